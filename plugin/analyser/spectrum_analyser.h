@@ -60,6 +60,36 @@ public:
         waitForData.signal();
     }
 
+    /**
+     * @brief Adds the mid or side signal of the first two channels.
+     */
+    void addMidSideData(const AudioBuffer<Type>& buffer, bool side)
+    {
+        // Return if not enough space is available
+        if (abstractFifo.getFreeSpace() < buffer.getNumSamples()) { return; }
+
+        const auto half      = static_cast<Type>(0.5);
+        const auto rightGain = side ? -half : half;
+
+        int start1 {};
+        int block1 {};
+        int start2 {};
+        int block2 {};
+        abstractFifo.prepareToWrite(buffer.getNumSamples(), start1, block1, start2, block2);
+        if (block1 > 0)
+        {
+            audioFifo.copyFrom(0, start1, buffer.getReadPointer(0), block1, half);
+            audioFifo.addFrom(0, start1, buffer.getReadPointer(1), block1, rightGain);
+        }
+        if (block2 > 0)
+        {
+            audioFifo.copyFrom(0, start2, buffer.getReadPointer(0, block1), block2, half);
+            audioFifo.addFrom(0, start2, buffer.getReadPointer(1, block1), block2, rightGain);
+        }
+        abstractFifo.finishedWrite(block1 + block2);
+        waitForData.signal();
+    }
+
     void setupAnalyser(int audioFifoSize, Type sampleRateToUse)
     {
         sampleRate = sampleRateToUse;
@@ -23,6 +23,7 @@ AnalyserController::AnalyserController(tobanteAudio::EqualizerProcessor& p,
     : processor(p), bandControllers(bc), view(v)
 {
     int i = 0;
+    view.handles.clear();
     for (const auto& band : bandControllers)
     {
         ignoreUnused(band);
@@ -44,7 +45,13 @@ AnalyserController::~AnalyserController()
 
 void AnalyserController::changeListenerCallback(ChangeBroadcaster* sender)
 {
-    ignoreUnused(sender);
+    // The view only broadcasts when it was resized
+    if (sender == &view)
+    {
+        const auto& plotFrame      = view.plotFrame;
+        auto const pixelsPerDouble = 2.0f * plotFrame.getHeight() / Decibels::decibelsToGain(MAX_DB);
+        processor.setPlotBounds(plotFrame, pixelsPerDouble);
+    }
     updateFrequencyResponses();
     view.repaint();
 }
@@ -228,9 +235,9 @@ void AnalyserController::mouseWheelMove(const MouseEvent& event, const MouseWhee
 }
 void AnalyserController::updateFrequencyResponses()
 {
-    auto& plotFrame            = view.plotFrame;
-    auto const pixelsPerDouble = 2.0f * plotFrame.getHeight() / Decibels::decibelsToGain(MAX_DB);
+    auto& plotFrame = view.plotFrame;
 
+    // The paths were built by the processor's curve worker
     for (int i = 0; i < bandControllers.size(); ++i)
     {
         auto* bandController = bandControllers.getUnchecked(i);
@@ -238,9 +245,7 @@ void AnalyserController::updateFrequencyResponses()
         if (auto* band = processor.getBand(i))
         {
             bandController->setUIControls(band->type);
-            bandController->frequencyResponse.clear();
-            processor.createFrequencyPlot(bandController->frequencyResponse, band->magnitudes,
-                                          plotFrame.withX(plotFrame.getX() + 1), pixelsPerDouble);
+            bandController->frequencyResponse = processor.getBandPlot(i);
 
             // HANDLE
             auto& handle = view.handles[i];
@@ -267,7 +272,6 @@ void AnalyserController::updateFrequencyResponses()
         }
         bandController->setSolo(processor.getBandSolo(i));
     }
-    view.frequencyResponse.clear();
-    processor.createFrequencyPlot(view.frequencyResponse, processor.getMagnitudes(), plotFrame, pixelsPerDouble);
+    view.frequencyResponse = processor.getResponsePlot();
 }
 }  // namespace tobanteAudio
\ No newline at end of file
@@ -28,6 +28,8 @@ BandController::BandController(const int i, ModEQProcessor& p, tobanteAudio::Equ
     const auto& frequency_id = processor.getFrequencyParamID(index);
     const auto& quality_id   = processor.getQualityParamID(index);
     const auto& gain_id      = processor.getGainParamID(index);
+    const auto& slope_id     = processor.getSlopeParamID(index);
+    const auto& routing_id   = processor.getRoutingParamID(index);
 
     // Link GUI components to ValueTree
     using SliderAttachment   = AudioProcessorValueTreeState::SliderAttachment;
@@ -36,6 +38,8 @@ BandController::BandController(const int i, ModEQProcessor& p, tobanteAudio::Equ
 
     // Type & Bypass
     boxAttachments.add(new ComboBoxAttachment(state, type_id, view.type));
+    boxAttachments.add(new ComboBoxAttachment(state, slope_id, view.slope));
+    boxAttachments.add(new ComboBoxAttachment(state, routing_id, view.routing));
     buttonAttachments.add(new ButtonAttachment(state, active_id, view.activate));
 
     // Slider
@@ -51,6 +55,10 @@ BandController::BandController(const int i, ModEQProcessor& p, tobanteAudio::Equ
 
 void BandController::setUIControls(tobanteAudio::EqualizerProcessor::FilterType type)
 {
+    // Only the high & low-passes have a selectable slope
+    view.slope.setEnabled(type == tobanteAudio::EqualizerProcessor::HighPass
+                          || type == tobanteAudio::EqualizerProcessor::LowPass);
+
     switch (type)
     {
     case tobanteAudio::EqualizerProcessor::LowPass:
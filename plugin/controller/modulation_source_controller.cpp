@@ -22,14 +22,21 @@ namespace tobanteAudio
 {
 ModulationSourceController::ModulationSourceController(const int i, ModEQProcessor& mp, ModulationSourceProcessor& p,
                                                        ModulationSourceView& v)
-    : index(i), connectViewActive(false), mainProcessor(mp), processor(p), view(v)
+    : index(i)
+    , connectViewActive(false)
+    , connectItems {&v.modConnect1, &v.modConnect2}
+    , mainProcessor(mp)
+    , processor(p)
+    , view(v)
 {
     // Link GUI components to ValueTree
-    using SliderAttachment = AudioProcessorValueTreeState::SliderAttachment;
-    auto& state            = mainProcessor.getPluginState();
+    using SliderAttachment   = AudioProcessorValueTreeState::SliderAttachment;
+    using ComboBoxAttachment = AudioProcessorValueTreeState::ComboBoxAttachment;
+    auto& state              = mainProcessor.getPluginState();
 
-    attachments.add(new SliderAttachment(state, "lfo_" + String(index) + "_freq", view.frequency));
-    attachments.add(new SliderAttachment(state, "lfo_" + String(index) + "_gain", view.gain));
+    attachments.add(new SliderAttachment(state, processor.getFrequencyParamID(index - 1), view.frequency));
+    attachments.add(new SliderAttachment(state, processor.getGainParamID(index - 1), view.gain));
+    shapeAttachment = std::make_unique<ComboBoxAttachment>(state, processor.getShapeParamID(index - 1), view.shape);
 
     // Button Connect
     view.modConnect1.setVisible(connectViewActive);
@@ -40,6 +47,17 @@ ModulationSourceController::ModulationSourceController(const int i, ModEQProcess
         view.modConnect2.setVisible(connectViewActive);
     };
 
+    // Connections
+    for (size_t item = 0; item < connectItems.size(); ++item)
+    {
+        auto& connect = *connectItems[item];
+        addTargets(connect);
+        connect.target.onChange      = [this, item]() { storeConnection(item); };
+        connect.amount.onValueChange = [this, item]() { storeConnection(item); };
+        connect.active.onClick       = [this, item]() { storeConnection(item); };
+    }
+    loadConnections();
+
     // Slider connect
     view.frequency.addListener(this);
     view.gain.addListener(this);
@@ -61,10 +79,73 @@ void ModulationSourceController::sliderValueChanged(Slider* slider)
     if (slider == &gain)
     { gainLabel.setText(gain.getTextFromValue(gain.getValue()), NotificationType::dontSendNotification); }
 }
+
+void ModulationSourceController::addTargets(ModulationConnectItemView& item)
+{
+    item.target.addItem(translate("Output"), getTargetId({ModulationParameter::Output, -1}));
+    for (int band = 0; band < FILTER_MAX_BANDS; ++band)
+    {
+        const auto name = mainProcessor.getEQ().getBandName(band);
+        item.target.addItem(name + " " + translate("Frequency"), getTargetId({ModulationParameter::Frequency, band}));
+        item.target.addItem(name + " " + translate("Gain"), getTargetId({ModulationParameter::Gain, band}));
+        item.target.addItem(name + " " + translate("Quality"), getTargetId({ModulationParameter::Quality, band}));
+    }
+}
+
+void ModulationSourceController::loadConnections()
+{
+    const auto source = index - 1;
+    size_t item       = 0;
+    for (const auto& connection : mainProcessor.getModulationMatrix().getConnections())
+    {
+        if (connection.source != source || item == connectItems.size()) { continue; }
+
+        auto& connect          = *connectItems[item];
+        connectTargetIds[item] = getTargetId(connection.target);
+        connect.target.setSelectedId(connectTargetIds[item], NotificationType::dontSendNotification);
+        connect.amount.setValue(connection.depth, NotificationType::dontSendNotification);
+        connect.active.setToggleState(connection.active, NotificationType::dontSendNotification);
+        ++item;
+    }
+}
+
+void ModulationSourceController::storeConnection(const size_t item)
+{
+    const auto& connect = *connectItems[item];
+    const auto targetId = connect.target.getSelectedId();
+    auto& matrix        = mainProcessor.getModulationMatrix();
+    const auto source   = index - 1;
+    if (targetId == 0) { return; }
+
+    if (connectTargetIds[item] != 0 && connectTargetIds[item] != targetId)
+    { matrix.removeConnection(source, getTarget(connectTargetIds[item])); }
+    connectTargetIds[item] = targetId;
+
+    ModulationMatrix::Connection connection;
+    connection.source = source;
+    connection.target = getTarget(targetId);
+    connection.depth  = static_cast<float>(connect.amount.getValue());
+    connection.active = connect.active.getToggleState();
+    matrix.setConnection(connection);
+}
+
+int ModulationSourceController::getTargetId(const ModulationTarget target)
+{
+    // 0 means nothing selected in a ComboBox
+    if (target.parameter == ModulationParameter::Output) { return 1; }
+    return 2 + target.band * 3 + static_cast<int>(target.parameter);
+}
+
+ModulationTarget ModulationSourceController::getTarget(const int targetId)
+{
+    if (targetId <= 1) { return {ModulationParameter::Output, -1}; }
+    return {static_cast<ModulationParameter>((targetId - 2) % 3), (targetId - 2) / 3};
+}
+
 void ModulationSourceController::timerCallback()
 {
-    if (processor.checkForNewAnalyserData())
-    { processor.createAnalyserPlot(view.modulationPath, view.plotFrame, 20.0f); }
+    if (processor.checkForNewAnalyserData(index - 1))
+    { processor.createAnalyserPlot(index - 1, view.modulationPath, view.plotFrame, 20.0f); }
     view.repaint(view.plotFrame);
 }
 
@@ -49,9 +49,32 @@ public:
     void timerCallback() override;
 
 private:
+    /**
+     * @brief Fills the target boxes with the output & the band parameters.
+     */
+    void addTargets(ModulationConnectItemView& item);
+
+    /**
+     * @brief Shows the stored connections of this source.
+     */
+    void loadConnections();
+
+    /**
+     * @brief Writes the connection of a connect view to the matrix.
+     */
+    void storeConnection(size_t item);
+
+    static int getTargetId(ModulationTarget target);
+    static ModulationTarget getTarget(int targetId);
+
     int index;
     bool connectViewActive;
 
+    // Each connect view edits one connection, the id of its target is kept
+    // to remove the connection when the target changes
+    std::array<ModulationConnectItemView*, 2> connectItems;
+    std::array<int, 2> connectTargetIds {};
+
     // Processor & View connections
     ModEQProcessor& mainProcessor;
     tobanteAudio::ModulationSourceProcessor& processor;
@@ -59,6 +82,7 @@ private:
 
     // Attachments to ValueTree
     OwnedArray<AudioProcessorValueTreeState::SliderAttachment> attachments;
+    std::unique_ptr<AudioProcessorValueTreeState::ComboBoxAttachment> shapeAttachment;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulationSourceController)
@@ -55,30 +55,17 @@ ModEQEditor::ModEQEditor(ModEQProcessor& p)
     settingsView.setVisible(false);
 
     // Modulation
-    for (int i = 1; i < 2; ++i)
+    for (int i = 1; i <= tobanteAudio::ModulationSourceProcessor::numSources; ++i)
     {
         using MSC = tobanteAudio::ModulationSourceController;
         using MSV = tobanteAudio::ModulationSourceView;
 
         auto* const modView = modViews.add(new MSV(i));
-        modController.add(new MSC(i, mainProcessor, mainProcessor.modSource, *modView));
+        modController.add(new MSC(i, mainProcessor, mainProcessor.getModulationSource(), *modView));
 
         addAndMakeVisible(modView);
     }
 
-    // EQ bands
-    for (int i = 0; i < mainProcessor.getEQ().getNumBands(); ++i)
-    {
-        using BC = tobanteAudio::BandController;
-        using BV = tobanteAudio::BandView;
-
-        const auto color     = mainProcessor.getEQ().getBand(i)->colour;
-        auto* const bandView = bandViews.add(new BV(i, color));
-        bandControllers.add(new BC(i, mainProcessor, mainProcessor.getEQ(), *bandView));
-
-        addAndMakeVisible(bandView);
-    }
-
     // Meter
     lnf = std::make_unique<tobanteAudio::TobanteMetersLookAndFeel>();
     lnf->setColour(FFAU::LevelMeter::lmMeterGradientLowColour, tobanteAudio::ORANGE);
@@ -90,14 +77,19 @@ ModEQEditor::ModEQEditor(ModEQProcessor& p)
     addAndMakeVisible(meter.get());
 
     // Plot
-    using AC = tobanteAudio::AnalyserController;
-    using AV = tobanteAudio::AnalyserView;
-
-    auto& eq           = mainProcessor.getEQ();
-    analyserView       = std::make_unique<AV>();
-    analyserController = std::make_unique<AC>(eq, bandControllers, *analyserView.get());
+    analyserView = std::make_unique<tobanteAudio::AnalyserView>();
     addAndMakeVisible(analyserView.get());
 
+    // EQ bands
+    auto& eq = mainProcessor.getEQ();
+    createBands();
+    eq.addChangeListener(this);
+
+    // Band count
+    auto& numBands = settingsView.numBands;
+    numBands.setSelectedId(eq.getNumBands(), dontSendNotification);
+    numBands.onChange = [this]() { mainProcessor.getEQ().setNumBands(settingsView.numBands.getSelectedId()); };
+
     // Master Section
     addAndMakeVisible(output);
     output.setTooltip(translate("Overall Gain"));
@@ -108,6 +100,20 @@ ModEQEditor::ModEQEditor(ModEQProcessor& p)
     const auto output_param = tobanteAudio::Parameters::Output;
     attachments.add(new SliderAttachment(state, output_param, output));
 
+    // Oversampling
+    using ComboBoxAttachment = AudioProcessorValueTreeState::ComboBoxAttachment;
+    const auto attachChoice  = [&](const String& parameterID, ComboBox& box) {
+        if (auto* choice = dynamic_cast<AudioParameterChoice*>(state.getParameter(parameterID)))
+        { box.addItemList(choice->choices, 1); }
+        boxAttachments.add(new ComboBoxAttachment(state, parameterID, box));
+    };
+    attachChoice(tobanteAudio::Parameters::Oversampling, settingsView.oversampling);
+    attachChoice(tobanteAudio::Parameters::OversamplingFilter, settingsView.oversamplingFilter);
+    attachChoice(tobanteAudio::Parameters::Phase, settingsView.phase);
+    attachChoice(tobanteAudio::Parameters::Design, settingsView.design);
+    attachChoice(tobanteAudio::Parameters::Topology, settingsView.topology);
+    attachChoice(tobanteAudio::Parameters::AnalyserChannels, settingsView.analyser);
+
     // Window settings
     setResizable(true, true);
     setResizeLimits(1000, 750, 2990, 1800);
@@ -121,6 +127,7 @@ ModEQEditor::ModEQEditor(ModEQProcessor& p)
 
 ModEQEditor::~ModEQEditor()
 {
+    mainProcessor.getEQ().removeChangeListener(this);
     setLookAndFeel(nullptr);
     PopupMenu::dismissAllActiveMenus();
 
@@ -129,6 +136,42 @@ ModEQEditor::~ModEQEditor()
 #endif
 }
 
+void ModEQEditor::changeListenerCallback(ChangeBroadcaster* sender)
+{
+    ignoreUnused(sender);
+
+    const auto numBands = mainProcessor.getEQ().getNumBands();
+    if (bandViews.size() == numBands) { return; }
+
+    settingsView.numBands.setSelectedId(numBands, dontSendNotification);
+    createBands();
+    resized();
+}
+
+void ModEQEditor::createBands()
+{
+    using AC = tobanteAudio::AnalyserController;
+    using BC = tobanteAudio::BandController;
+    using BV = tobanteAudio::BandView;
+
+    // Controllers reference the views, destroy them first
+    auto& eq = mainProcessor.getEQ();
+    analyserController.reset();
+    bandControllers.clear();
+    bandViews.clear();
+
+    for (int i = 0; i < eq.getNumBands(); ++i)
+    {
+        const auto color     = eq.getBand(i)->colour;
+        auto* const bandView = bandViews.add(new BV(i, color));
+        bandControllers.add(new BC(i, mainProcessor, eq, *bandView));
+
+        addAndMakeVisible(bandView);
+    }
+
+    analyserController = std::make_unique<AC>(eq, bandControllers, *analyserView.get());
+}
+
 void ModEQEditor::paint(Graphics& g)
 {
     // Background
@@ -37,7 +37,7 @@
 /**
  * @brief Entry point for GUI thread. Inherites from juce::AudioProcessorEditor
  */
-class ModEQEditor : public AudioProcessorEditor
+class ModEQEditor : public AudioProcessorEditor, public ChangeListener
 {
 public:
     ModEQEditor(ModEQProcessor& p);
@@ -46,9 +46,16 @@ public:
     void paint(Graphics& g) override;
     void resized() override;
 
+    /**
+     * @brief Rebuilds the band components if the number of bands changed.
+     */
+    void changeListenerCallback(ChangeBroadcaster* sender) override;
+
 private:
     ModEQProcessor& mainProcessor;
 
+    void createBands();
+
     // Components
     tobanteAudio::TobanteLookAndFeel tobanteLookAndFeel;
     tobanteAudio::SocialButtons socialButtons;
@@ -77,6 +84,7 @@ private:
     Slider output;
     Rectangle<int> outputSliderFrame;
     OwnedArray<AudioProcessorValueTreeState::SliderAttachment> attachments;
+    OwnedArray<AudioProcessorValueTreeState::ComboBoxAttachment> boxAttachments;
 
     SharedResourcePointer<TooltipWindow> tooltipWindow;
 
@@ -44,6 +44,9 @@ auto CreateParameters() -> juce::AudioProcessorValueTreeState::ParameterLayout
         return range;
     }();
 
+    // Hosts address automation by the parameter order. The parameters of the
+    // first release come first, everything added since is appended after the
+    // equalizer bands by the processors
     return {
         std::make_unique<juce::AudioParameterFloat>("lfo_1_freq",                                     //
                                                     "lfo freq",                                       //
@@ -82,23 +85,34 @@ ModEQProcessor::ModEQProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
     : juce::AudioProcessor(BusesProperties()
                                .withInput("Input", AudioChannelSet::stereo(), true)
-                               .withOutput("Output", AudioChannelSet::stereo(), true))
+                               .withOutput("Output", AudioChannelSet::stereo(), true)
+                               .withInput("Sidechain", AudioChannelSet::stereo(), false))
     ,
 #else
     :
 #endif
     state(*this, &undo, "tobanteAudioModEQ", CreateParameters())
-    , modSource(1, state)
     , equalizerProcessor(state)
+    , modSource(state)
+    , modulationMatrix(state.state)
 
 {
+    outputParameter = state.getRawParameterValue(tobanteAudio::Parameters::Output);
+
     state.addParameterListener(tobanteAudio::Parameters::Output, this);
+    state.addParameterListener(tobanteAudio::Parameters::Oversampling, this);
+    state.addParameterListener(tobanteAudio::Parameters::OversamplingFilter, this);
+    state.addParameterListener(tobanteAudio::Parameters::Phase, this);
 
 #ifdef JUCE_DEBUG
     tobanteAudio::tests::run();
 #else
     // in release mode, default to not running tests.
 #endif
+
+#if TOBANTEAUDIO_RUN_BENCHMARKS
+    tobanteAudio::tests::runBenchmarks();
+#endif
 }
 
 const String ModEQProcessor::getName() const { return JucePlugin_Name; }
@@ -122,7 +136,7 @@ bool ModEQProcessor::producesMidi() const
 }
 
 bool ModEQProcessor::isMidiEffect() const { return false; }
-double ModEQProcessor::getTailLengthSeconds() const { return 0.0; }
+double ModEQProcessor::getTailLengthSeconds() const { return equalizerProcessor.getTailLengthSeconds(); }
 int ModEQProcessor::getNumPrograms() { return 1; }
 int ModEQProcessor::getCurrentProgram() { return 0; }
 void ModEQProcessor::setCurrentProgram(int index) { ignoreUnused(index); }
@@ -140,7 +154,6 @@ void ModEQProcessor::changeProgramName(int index, const String& newName)
 void ModEQProcessor::prepareToPlay(double newSampleRate, int newSamplesPerBlock)
 {
     sampleRate = newSampleRate;
-    modBuffer.setSize(1, newSamplesPerBlock, false, false, true);
 
     dsp::ProcessSpec spec;
     spec.sampleRate       = newSampleRate;
@@ -150,12 +163,35 @@ void ModEQProcessor::prepareToPlay(double newSampleRate, int newSamplesPerBlock)
     auto const* const gain = state.getRawParameterValue(tobanteAudio::Parameters::Output);
     outputGain.setGainLinear(gain->load());
     outputGain.prepare(spec);
+    doubleOutputGain.setGainLinear(gain->load());
+    doubleOutputGain.prepare(spec);
+
+    // A modulated output gain ramps over one control interval
+    const auto rampSeconds = tobanteAudio::MODULATION_CONTROL_INTERVAL / newSampleRate;
+    outputGain.setRampDurationSeconds(rampSeconds);
+    doubleOutputGain.setRampDurationSeconds(rampSeconds);
 
-    modSource.setBusesLayout(getBusesLayout());
     modSource.prepareToPlay(sampleRate, newSamplesPerBlock);
 
-    equalizerProcessor.setBusesLayout(getBusesLayout());
+    // The sidechain is handed to the equalizer with each block
+    BusesLayout mainLayout;
+    mainLayout.inputBuses.add(getBusesLayout().getMainInputChannelSet());
+    mainLayout.outputBuses.add(getBusesLayout().getMainOutputChannelSet());
+    equalizerProcessor.setBusesLayout(mainLayout);
+    equalizerProcessor.setProcessingPrecision(getProcessingPrecision());
     equalizerProcessor.prepareToPlay(newSampleRate, newSamplesPerBlock);
+    setLatencySamples(equalizerProcessor.getLatencySamples());
+
+    using tobanteAudio::EqualizerProcessor;
+    const auto numChannels = getMainBusNumOutputChannels();
+    const auto isDouble    = getProcessingPrecision() == doublePrecision;
+    const auto sampleSize  = isDouble ? sizeof(double) : sizeof(float);
+    const auto interval    = equalizerProcessor.getControlInterval();
+    pipelineBlockSize      = EqualizerProcessor::getPipelineBlockSize(numChannels, sampleSize, interval);
+
+    // Resizing in measureBlock would allocate on the audio thread. The meter
+    // sees each host block once, whatever sub-blocks process() used
+    meterSource.resize(numChannels, tobanteAudio::METER_RMS_WINDOW);
 }
 
 void ModEQProcessor::releaseResources() { }
@@ -164,48 +200,101 @@ void ModEQProcessor::releaseResources() { }
 bool ModEQProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
     // This checks if the input layout matches the output layout
-    return layouts.getMainOutputChannelSet() == layouts.getMainInputChannelSet();
+    const auto main = layouts.getMainOutputChannelSet();
+    if (main != layouts.getMainInputChannelSet()) { return false; }
+    if (!tobanteAudio::EqualizerProcessor::isChannelLayoutSupported(main)) { return false; }
+
+    // The sidechain is optional & can be mono or stereo
+    if (layouts.inputBuses.size() < 2) { return true; }
+    const auto sidechain = layouts.getChannelSet(true, 1);
+    return sidechain.isDisabled() || sidechain == AudioChannelSet::mono() || sidechain == AudioChannelSet::stereo();
 }
 #endif
 
 void ModEQProcessor::processBlock(AudioBuffer<float>& buffer, MidiBuffer& midiMessages)
+{
+    process(buffer, midiMessages, outputGain);
+}
+
+void ModEQProcessor::processBlock(AudioBuffer<double>& buffer, MidiBuffer& midiMessages)
+{
+    process(buffer, midiMessages, doubleOutputGain);
+}
+
+template <typename SampleType>
+void ModEQProcessor::process(AudioBuffer<SampleType>& buffer, MidiBuffer& midiMessages, dsp::Gain<SampleType>& gain)
 {
     ignoreUnused(midiMessages);
     ScopedNoDenormals noDenormals;
 
-    auto totalNumInputChannels  = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
+    auto totalNumInputChannels  = getMainBusNumInputChannels();
+    auto totalNumOutputChannels = getMainBusNumOutputChannels();
 
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
     { buffer.clear(i, 0, buffer.getNumSamples()); }
 
-    // modBuffer.clear();
-    // modSource.processBlock(modBuffer, midiMessages);
+    // The sidechain only keys the dynamic bands & is never heard
+    auto mainBuffer          = getBusBuffer(buffer, false, 0);
+    const auto* sidechainBus = getBus(true, 1);
+    const auto hasSidechain  = sidechainBus != nullptr && sidechainBus->isEnabled();
+    auto sidechain           = hasSidechain ? getBusBuffer(buffer, true, 1) : AudioBuffer<SampleType> {};
+    equalizerProcessor.setSidechain(hasSidechain ? &sidechain : nullptr);
+
+    // The matrix samples the sources once per control interval while it has
+    // connections, otherwise they only advance once per block
+    const auto numChannels = mainBuffer.getNumChannels();
+    const auto numSamples  = mainBuffer.getNumSamples();
+    const auto modulated   = modulationMatrix.acquireConnections();
+    if (!modulated) { modSource.process(numSamples); }
+
+    // Every stage runs on a cache sized sub-block before the next one is read,
+    // the views refer to the bus buffer & don't allocate. Sub-blocks stay on
+    // the equalizer's control-rate grid, which may have changed since prepare
+    using tobanteAudio::EqualizerProcessor;
+    const auto interval  = equalizerProcessor.getControlInterval();
+    const auto blockSize = EqualizerProcessor::getPipelineBlockSize(numChannels, sizeof(SampleType), interval);
+    const auto modStep   = jmin(blockSize, modulationMatrix.getControlInterval()) / interval * interval;
+    const auto stepSize  = modulated ? jmax(interval, modStep) : blockSize;
+    auto audible         = false;
+    for (int start = 0; start < numSamples; start += stepSize)
+    {
+        const auto length = jmin(stepSize, numSamples - start);
+        if (modulated) { applyModulation(length, gain); }
+
+        AudioBuffer<SampleType> subBlock(mainBuffer.getArrayOfWritePointers(), numChannels, start, length);
+        equalizerProcessor.processSubBlock(subBlock, start);
 
-    // auto modRange  = .8f;
-    // auto modValue  = modBuffer.getSample(0,
-    // static_cast<int>(modBuffer.getNumSamples() / 2)); auto gainValue =
-    // *state.getRawParameterValue(tobanteAudio::Parameters::Output); auto
-    // gainMod   = gainValue + (modRange * modValue);
+        // Nothing to gain on silence
+        if (equalizerProcessor.isIdle()) { continue; }
 
-    // if (gainMod < -0.0f)
-    //{
-    //    gainMod = 0.0;
-    //}
-    // if (gainMod > 2.0f)
-    //{
-    //    gainMod = 2.0;
-    //}
+        dsp::AudioBlock<SampleType> ioBuffer(subBlock);
+        dsp::ProcessContextReplacing<SampleType> context(ioBuffer);
+        gain.process(context);
+        audible = true;
+    }
 
-    // outputGain.setGainLinear(gainMod);
+    // The meter window counts host blocks, the sub-block size changes with
+    // the modulation. A silent block is skipped & the meter decays on its own
+    if (audible) { meterSource.measureBlock(mainBuffer); }
+
+    equalizerProcessor.setSidechain(static_cast<const AudioBuffer<SampleType>*>(nullptr));
+}
 
-    equalizerProcessor.processBlock(buffer, midiMessages);
+template <typename SampleType>
+void ModEQProcessor::applyModulation(const int numSamples, dsp::Gain<SampleType>& gain)
+{
+    // Bands which were modulated by the last evaluation are reset as well
+    const auto* sources = modSource.process(numSamples);
+    auto bands          = modulationMatrix.process(sources, tobanteAudio::LfoBank::numLfos);
+    for (int band = 0; bands != 0; ++band, bands >>= 1)
+    {
+        if ((bands & 1) == 0) { continue; }
 
-    dsp::AudioBlock<float> ioBuffer(buffer);
-    dsp::ProcessContextReplacing<float> context(ioBuffer);
-    outputGain.process(context);
+        const auto& modulation = modulationMatrix.getBandModulation(static_cast<size_t>(band));
+        equalizerProcessor.setBandModulation(band, modulation.frequency, modulation.quality, modulation.gain);
+    }
 
-    meterSource.measureBlock(buffer);
+    gain.setGainLinear(static_cast<SampleType>(outputParameter->load() * modulationMatrix.getOutputGain()));
 }
 
 void ModEQProcessor::parameterChanged(const String& parameter, float newValue)
@@ -213,10 +302,18 @@ void ModEQProcessor::parameterChanged(const String& parameter, float newValue)
     if (parameter == tobanteAudio::Parameters::Output)
     {
         outputGain.setGainLinear(newValue);
+        doubleOutputGain.setGainLinear(newValue);
         return;
     }
+
+    // May be called from the audio thread, the host is notified later
+    if (parameter == tobanteAudio::Parameters::Oversampling
+        || parameter == tobanteAudio::Parameters::OversamplingFilter || parameter == tobanteAudio::Parameters::Phase)
+    { triggerAsyncUpdate(); }
 }
 
+void ModEQProcessor::handleAsyncUpdate() { setLatencySamples(equalizerProcessor.getLatencySamples()); }
+
 bool ModEQProcessor::hasEditor() const { return true; }
 
 AudioProcessorEditor* ModEQProcessor::createEditor() { return new ModEQEditor(*this); }
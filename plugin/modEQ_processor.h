@@ -23,6 +23,7 @@
 #include "analyser/spectrum_analyser.h"
 #include "parameters/text_value_converter.h"
 #include "processor/equalizer_processor.h"
+#include "processor/modulation_matrix.h"
 #include "processor/modulation_source_processor.h"
 
 /**
@@ -30,7 +31,8 @@
  */
 class ModEQProcessor : public juce::AudioProcessor,
                        public juce::AudioProcessorValueTreeState::Listener,
-                       public juce::ChangeBroadcaster
+                       public juce::ChangeBroadcaster,
+                       private juce::AsyncUpdater
 {
 private:
     juce::UndoManager undo;
@@ -48,7 +50,10 @@ public:
 #endif
 
     void processBlock(juce::AudioBuffer<float>& /*buffer*/, juce::MidiBuffer& /*midiMessages*/) override;
+    void processBlock(juce::AudioBuffer<double>& /*buffer*/, juce::MidiBuffer& /*midiMessages*/) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
     void parameterChanged(const String& parameter, float newValue) override;
+    void handleAsyncUpdate() override;
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -72,17 +77,33 @@ public:
     tobanteAudio::EqualizerProcessor& getEQ() { return equalizerProcessor; }
     juce::AudioProcessorValueTreeState& getPluginState() { return state; }
     juce::UndoManager& getUndoManager() { return undo; }
-    tobanteAudio::ModulationSourceProcessor modSource;
+    tobanteAudio::ModulationSourceProcessor& getModulationSource() { return modSource; }
+    tobanteAudio::ModulationMatrix& getModulationMatrix() { return modulationMatrix; }
     FFAU::LevelMeterSource* getMeterSource() { return &meterSource; }
 
 private:
-    double sampleRate = 0;
+    double sampleRate     = 0;
+    int pipelineBlockSize = tobanteAudio::FILTER_CONTROL_INTERVAL;
 
     tobanteAudio::EqualizerProcessor equalizerProcessor;
-    juce::AudioBuffer<float> modBuffer;
+
+    // Constructed after the equalizer, the parameters it adds follow the bands
+    tobanteAudio::ModulationSourceProcessor modSource;
+
+    // Routes the sources to the bands & the output gain, evaluated on its
+    // control-rate grid while it has connections
+    tobanteAudio::ModulationMatrix modulationMatrix;
+    std::atomic<float>* outputParameter {nullptr};
 
     juce::dsp::Gain<float> outputGain;
+    juce::dsp::Gain<double> doubleOutputGain;
     FFAU::LevelMeterSource meterSource;
 
+    template <typename SampleType> void applyModulation(int numSamples, juce::dsp::Gain<SampleType>& gain);
+
+    template <typename SampleType>
+    void process(juce::AudioBuffer<SampleType>& buffer, juce::MidiBuffer& midiMessages,
+                 juce::dsp::Gain<SampleType>& gain);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModEQProcessor)
 };
@@ -28,5 +28,28 @@ const String Quality   = "quality";
 const String Gain      = "gain";
 const String Active    = "active";
 const String Phase     = "phase";
+const String NumBands  = "num_bands";
+const String Design    = "design";
+const String Topology  = "topology";
+const String Slope     = "slope";
+const String Dynamic   = "dynamic";
+const String Threshold = "threshold";
+const String Ratio     = "ratio";
+const String Attack    = "attack";
+const String Release   = "release";
+const String Key       = "key";
+const String Routing   = "routing";
+
+const String Oversampling       = "oversampling";
+const String OversamplingFilter = "oversampling_filter";
+const String AnalyserChannels   = "analyser_channels";
+
+// Modulation routing, stored as child trees of the state
+const String Modulation = "modulation";
+const String Connection = "connection";
+const String Source     = "source";
+const String Band       = "band";
+const String Target     = "target";
+const String Depth      = "depth";
 };  // namespace Parameters
 }  // namespace tobanteAudio
\ No newline at end of file
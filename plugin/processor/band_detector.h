@@ -0,0 +1,236 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "biquad_designer.h"
+
+namespace tobanteAudio
+{
+/**
+ * @brief Level detectors for the dynamic bands, one band-pass & envelope
+ * follower per band.
+ *
+ * @details All channels are mixed to mono first. Each SIMD lane holds one
+ * band, so a block is processed with one loop over the samples which runs the
+ * band-pass & the envelope of every band at once. The gains are computed once
+ * per processed block, which is meant to be a control-rate sub-block.
+ */
+template <size_t MaxBands> class BandDetector
+{
+public:
+    using Vec = dsp::SIMDRegister<float>;
+
+    /**
+     * @brief Number of bands processed by one pass of the kernel.
+     */
+    static constexpr size_t lanes = Vec::SIMDNumElements;
+
+    /**
+     * @brief Constructor. All bands start disabled with unity gain.
+     */
+    BandDetector() { reset(); }
+
+    /**
+     * @brief Allocates the mono mix for blocks of up to maxBlockSize samples.
+     */
+    void prepare(double newSampleRate, int maxBlockSize)
+    {
+        sampleRate = newSampleRate;
+        mono.resize(static_cast<size_t>(maxBlockSize));
+        for (size_t band = 0; band < MaxBands; ++band) { updateBand(band); }
+        reset();
+    }
+
+    /**
+     * @brief Clears the filter & envelope state of all bands.
+     */
+    void reset() noexcept
+    {
+        std::fill(state1.begin(), state1.end(), Vec::expand(0.0f));
+        std::fill(state2.begin(), state2.end(), Vec::expand(0.0f));
+        std::fill(envelope.begin(), envelope.end(), Vec::expand(0.0f));
+        std::fill(gains.begin(), gains.end(), 1.0f);
+    }
+
+    /**
+     * @brief Sets the detection band & the gain computer of a band. Threshold
+     * in dBFS, attack & release in milliseconds.
+     */
+    void setBand(size_t band, float frequency, float quality, float threshold, float ratio, float attack,
+                 float release) noexcept
+    {
+        jassert(band < MaxBands);
+        settings[band] = Settings {frequency, quality, threshold, ratio, attack, release};
+        updateBand(band);
+    }
+
+    /**
+     * @brief Only enabled bands are followed, the others keep unity gain.
+     */
+    void setEnabled(size_t band, bool shouldBeEnabled) noexcept
+    {
+        jassert(band < MaxBands);
+        if (enabled[band] == shouldBeEnabled) { return; }
+
+        enabled[band] = shouldBeEnabled;
+        gains[band]   = 1.0f;
+
+        const auto group = band / lanes;
+        const auto lane  = band % lanes;
+        state1[group].set(lane, 0.0f);
+        state2[group].set(lane, 0.0f);
+        envelope[group].set(lane, 0.0f);
+    }
+
+    /**
+     * @brief Sets the number of bands which are followed.
+     */
+    void setNumActiveBands(size_t newNumActiveBands) noexcept { numActiveBands = jmin(newNumActiveBands, MaxBands); }
+
+    /**
+     * @brief Returns true if any of the active bands is enabled.
+     */
+    bool isActive() const noexcept
+    {
+        return std::any_of(enabled.begin(), enabled.begin() + static_cast<std::ptrdiff_t>(numActiveBands),
+                           [](auto isEnabled) { return isEnabled; });
+    }
+
+    /**
+     * @brief Follows the level of the block & updates the gains.
+     */
+    template <typename SampleType> void process(const dsp::AudioBlock<SampleType>& block) noexcept
+    {
+        const auto numChannels = block.getNumChannels();
+        const auto numSamples  = jmin(block.getNumSamples(), mono.size());
+        jassert(block.getNumSamples() <= mono.size());
+        if (numChannels == 0 || numSamples == 0) { return; }
+
+        const auto scale = 1.0f / static_cast<float>(numChannels);
+        std::fill(mono.begin(), mono.begin() + static_cast<std::ptrdiff_t>(numSamples), 0.0f);
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* samples = block.getChannelPointer(channel);
+            for (size_t i = 0; i < numSamples; ++i) { mono[i] += static_cast<float>(samples[i]) * scale; }
+        }
+
+        for (size_t group = 0; group * lanes < numActiveBands; ++group) { processGroup(group, numSamples); }
+
+        // The gain computer runs once per block
+        for (size_t band = 0; band < numActiveBands; ++band)
+        {
+            if (!enabled[band]) { continue; }
+
+            const auto& s        = settings[band];
+            const auto level     = Decibels::gainToDecibels(envelope[band / lanes].get(band % lanes));
+            const auto reduction = jmax(0.0f, level - s.threshold) * (1.0f - 1.0f / s.ratio);
+            gains[band]          = Decibels::decibelsToGain(-jmin(reduction, maxReduction));
+        }
+    }
+
+    /**
+     * @brief Returns the gain of a band computed from the last block, 1 for
+     * disabled bands.
+     */
+    float getGain(size_t band) const noexcept { return gains[band]; }
+
+    /**
+     * @brief Upper limit of the gain reduction in dB.
+     */
+    static constexpr float maxReduction = 24.0f;
+
+private:
+    struct Settings
+    {
+        float frequency = 1000.0f;
+        float quality   = 1.0f;
+        float threshold = 0.0f;
+        float ratio     = 1.0f;
+        float attack    = 10.0f;
+        float release   = 100.0f;
+    };
+
+    static constexpr size_t numGroups = (MaxBands + lanes - 1) / lanes;
+
+    void updateBand(size_t band) noexcept
+    {
+        if (sampleRate <= 0) { return; }
+
+        const auto& s    = settings[band];
+        const auto c     = BiquadDesigner<double>::makeBandPass(sampleRate, s.frequency, s.quality);
+        const auto group = band / lanes;
+        const auto lane  = band % lanes;
+        b0[group].set(lane, static_cast<float>(c.b0));
+        b1[group].set(lane, static_cast<float>(c.b1));
+        b2[group].set(lane, static_cast<float>(c.b2));
+        a1[group].set(lane, static_cast<float>(c.a1));
+        a2[group].set(lane, static_cast<float>(c.a2));
+        attackCoefficients[group].set(lane, getSmoothingCoefficient(s.attack));
+        releaseCoefficients[group].set(lane, getSmoothingCoefficient(s.release));
+    }
+
+    float getSmoothingCoefficient(float milliseconds) const noexcept
+    {
+        return static_cast<float>(1.0 - std::exp(-1000.0 / (jmax(0.01, double(milliseconds)) * sampleRate)));
+    }
+
+    void processGroup(size_t group, size_t numSamples) noexcept
+    {
+        // Work on local copies of the state, so it can stay in registers.
+        auto z1  = state1[group];
+        auto z2  = state2[group];
+        auto env = envelope[group];
+
+        const auto zero = Vec::expand(0.0f);
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            const auto x = Vec::expand(mono[i]);
+            const auto y = x * b0[group] + z1;
+            z1           = x * b1[group] - y * a1[group] + z2;
+            z2           = x * b2[group] - y * a2[group];
+
+            // Peak follower, rising with the attack & falling with the release
+            const auto delta = Vec::abs(y) - env;
+            env += Vec::max(delta, zero) * attackCoefficients[group]
+                   + Vec::min(delta, zero) * releaseCoefficients[group];
+        }
+
+        state1[group]   = z1;
+        state2[group]   = z2;
+        envelope[group] = env;
+    }
+
+    double sampleRate = 0.0;
+    size_t numActiveBands {MaxBands};
+    std::array<Settings, MaxBands> settings {};
+    std::array<bool, MaxBands> enabled {};
+    std::array<float, MaxBands> gains {};
+
+    // Coefficients & state, one register per group of bands.
+    std::array<Vec, numGroups> b0 {}, b1 {}, b2 {}, a1 {}, a2 {};
+    std::array<Vec, numGroups> attackCoefficients {}, releaseCoefficients {};
+    std::array<Vec, numGroups> state1 {}, state2 {}, envelope {};
+
+    std::vector<float> mono;
+};
+
+}  // namespace tobanteAudio
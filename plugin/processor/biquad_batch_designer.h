@@ -0,0 +1,236 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "biquad_cascade.h"
+#include "fast_math.h"
+
+namespace tobanteAudio
+{
+/**
+ * @brief Responses the BiquadBatchDesigner can design.
+ */
+enum class BiquadShape
+{
+    Identity = 0,
+    LowPass,
+    HighPass,
+    BandPass,
+    LowShelf,
+    HighShelf,
+    Peak
+};
+
+/**
+ * @brief Designs the bilinear sections of many bands in one pass, without
+ * allocating.
+ *
+ * @details Sections are queued into preallocated structure-of-arrays storage &
+ * designed together by design(). The work runs over fixed groups of lanes in
+ * three loops: the prewarped half angle tangent & the square roots of the
+ * gain, the raw coefficients of each shape & the normalisation. Only the
+ * normalisation is plain arithmetic. The tangent reflects its argument above
+ * pi / 4 & the raw coefficients switch over the shape, whether those loops
+ * vectorise is up to the compiler. Sine & cosine are not evaluated at all,
+ * the RBJ formulas are rewritten in terms of k = tan(pi * frequency /
+ * sampleRate).
+ *
+ * The tangent comes from fastTan in single & preciseTan in double precision.
+ * Compared with the dsp::IIR::Coefficients factories in double precision, the
+ * normalised coefficients are within maxAbsoluteError for frequencies from
+ * 2 Hz up to 0.45 * sampleRate, Q from 0.1 to 10 & gains of +-24 dB.
+ * Safe to call from the audio thread.
+ */
+template <typename SampleType, size_t MaxSections> class BiquadBatchDesigner
+{
+public:
+    using Coefficients = BiquadCoefficients<SampleType>;
+
+    /**
+     * @brief Constructor. Unused lanes hold a harmless section.
+     */
+    BiquadBatchDesigner() { qualities.fill(SampleType(1)); }
+
+    /**
+     * @brief Number of sections designed by one pass of the inner loops.
+     */
+    static constexpr size_t lanes = 8;
+
+    /**
+     * @brief Largest difference to the reference coefficients.
+     */
+    static constexpr double maxAbsoluteError = std::is_same<SampleType, double>::value ? 1.0e-9 : 5.0e-5;
+
+    /**
+     * @brief Removes all queued sections.
+     */
+    void clear() noexcept { numSections = 0; }
+
+    /**
+     * @brief Queues a section & returns its index. Gain is a linear factor,
+     * only used by the shelves & the peak.
+     */
+    size_t add(BiquadShape shape, double frequency, double Q, double gainFactor) noexcept
+    {
+        jassert(numSections < MaxSections);
+        const auto index = jmin(numSections, MaxSections - 1);
+        shapes[index]    = shape;
+        frequencies[index] = static_cast<SampleType>(jmax(frequency, 2.0));
+        qualities[index]   = static_cast<SampleType>(Q);
+        gains[index]       = static_cast<SampleType>(jmax(0.0, gainFactor));
+        numSections        = jmin(numSections + 1, MaxSections);
+        return index;
+    }
+
+    /**
+     * @brief Returns the number of queued sections.
+     */
+    size_t size() const noexcept { return numSections; }
+
+    /**
+     * @brief Designs all queued sections for the sample rate.
+     */
+    void design(double sampleRate) noexcept
+    {
+        jassert(sampleRate > 0.0);
+        const auto piOverRate = static_cast<SampleType>(MathConstants<double>::pi / sampleRate);
+
+        for (size_t first = 0; first < numSections; first += lanes)
+        {
+            // Transcendentals over all lanes
+            std::array<SampleType, lanes> k {}, w {}, a {}, sqrtA {};
+            for (size_t lane = 0; lane < lanes; ++lane)
+            {
+                const auto i = first + lane;
+                k[lane]      = tangent(frequencies[i] * piOverRate);
+                w[lane]      = k[lane] / qualities[i];
+                a[lane]      = std::sqrt(gains[i]);
+                sqrtA[lane]  = std::sqrt(a[lane]);
+            }
+
+            // Raw coefficients, all scaled by 1 + k^2
+            std::array<SampleType, lanes> b0 {}, b1 {}, b2 {}, a0 {}, a1 {}, a2 {};
+            for (size_t lane = 0; lane < lanes; ++lane)
+            {
+                const auto kSquared = k[lane] * k[lane];
+                const auto sum      = SampleType(1) + kSquared;
+                const auto diff     = SampleType(2) * (kSquared - SampleType(1));
+
+                auto raw = std::array<SampleType, 6> {1, 0, 0, 1, 0, 0};
+                switch (shapes[first + lane])
+                {
+                case BiquadShape::LowPass:
+                    raw = {kSquared, SampleType(2) * kSquared, kSquared, sum + w[lane], diff, sum - w[lane]};
+                    break;
+                case BiquadShape::HighPass:
+                    raw = {1, -2, 1, sum + w[lane], diff, sum - w[lane]};
+                    break;
+                case BiquadShape::BandPass:
+                    raw = {w[lane], 0, -w[lane], sum + w[lane], diff, sum - w[lane]};
+                    break;
+                case BiquadShape::Peak:
+                {
+                    const auto wTimesA = w[lane] * a[lane];
+                    const auto wOverA  = w[lane] / a[lane];
+                    raw                = {sum + wTimesA, diff, sum - wTimesA, sum + wOverA, diff, sum - wOverA};
+                    break;
+                }
+                case BiquadShape::LowShelf:
+                case BiquadShape::HighShelf:
+                {
+                    // (A +- 1) * cos(omega) scaled by 1 + k^2 is (A +- 1) * (1 - k^2)
+                    const auto low    = shapes[first + lane] == BiquadShape::LowShelf;
+                    const auto sign   = low ? SampleType(-1) : SampleType(1);
+                    const auto cosine = SampleType(1) - kSquared;
+                    const auto aPlus  = a[lane] + SampleType(1);
+                    const auto aMinus = a[lane] - SampleType(1);
+                    const auto beta   = SampleType(2) * sqrtA[lane] * w[lane];
+                    const auto upper  = aPlus * sum + sign * aMinus * cosine;
+                    const auto lower  = aPlus * sum - sign * aMinus * cosine;
+                    const auto rawB1  = SampleType(-2) * sign * a[lane] * (aMinus * sum + sign * aPlus * cosine);
+                    const auto rawA1  = SampleType(2) * sign * (aMinus * sum - sign * aPlus * cosine);
+
+                    raw = {a[lane] * (upper + beta), rawB1, a[lane] * (upper - beta), lower + beta, rawA1, lower - beta};
+                    break;
+                }
+                case BiquadShape::Identity:
+                default:
+                    break;
+                }
+
+                b0[lane] = raw[0];
+                b1[lane] = raw[1];
+                b2[lane] = raw[2];
+                a0[lane] = raw[3];
+                a1[lane] = raw[4];
+                a2[lane] = raw[5];
+            }
+
+            // Normalisation over all lanes
+            for (size_t lane = 0; lane < lanes; ++lane)
+            {
+                const auto i     = first + lane;
+                const auto a0Inv = SampleType(1) / a0[lane];
+                outB0[i]         = b0[lane] * a0Inv;
+                outB1[i]         = b1[lane] * a0Inv;
+                outB2[i]         = b2[lane] * a0Inv;
+                outA1[i]         = a1[lane] * a0Inv;
+                outA2[i]         = a2[lane] * a0Inv;
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the coefficients of a designed section.
+     */
+    Coefficients getCoefficients(size_t index) const noexcept
+    {
+        jassert(index < numSections);
+        return {outB0[index], outB1[index], outB2[index], outA1[index], outA2[index]};
+    }
+
+private:
+    // Whole groups of lanes, the unused tail of the last group is designed too
+    static constexpr size_t capacity = (MaxSections + lanes - 1) / lanes * lanes;
+
+    static SampleType tangent(SampleType x) noexcept
+    {
+        if constexpr (std::is_same<SampleType, double>::value) { return preciseTan(x); }
+        else
+        {
+            return fastTan(x);
+        }
+    }
+
+    template <typename T> using Lanes = std::array<T, capacity>;
+
+    Lanes<BiquadShape> shapes {};
+    alignas(64) Lanes<SampleType> frequencies {};
+    alignas(64) Lanes<SampleType> qualities {};
+    alignas(64) Lanes<SampleType> gains {};
+    alignas(64) Lanes<SampleType> outB0 {};
+    alignas(64) Lanes<SampleType> outB1 {};
+    alignas(64) Lanes<SampleType> outB2 {};
+    alignas(64) Lanes<SampleType> outA1 {};
+    alignas(64) Lanes<SampleType> outA2 {};
+    size_t numSections = 0;
+};
+}  // namespace tobanteAudio
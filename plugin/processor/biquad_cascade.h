@@ -0,0 +1,437 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "channel_routing.h"
+
+namespace tobanteAudio
+{
+/**
+ * @brief Normalised coefficients of one second order section (a0 == 1).
+ */
+template <typename SampleType> struct BiquadCoefficients
+{
+    SampleType b0 {1};
+    SampleType b1 {0};
+    SampleType b2 {0};
+    SampleType a1 {0};
+    SampleType a2 {0};
+
+    /**
+     * @brief Returns true if the section passes its input through unchanged.
+     */
+    bool isIdentity() const noexcept
+    {
+        return b0 == SampleType {1} && b1 == SampleType {0} && b2 == SampleType {0} && a1 == SampleType {0}
+               && a2 == SampleType {0};
+    }
+};
+
+/**
+ * @brief Cascade of second order sections, processed for all channels in a
+ * single pass.
+ *
+ * @details Coefficients and filter states are stored as structure-of-arrays.
+ * Each SIMD lane holds one channel, so a block is processed with one loop over
+ * the samples which runs every section before moving on to the next sample.
+ * Up to maxRegisters registers are processed side by side in that loop, so
+ * surround & ambisonic layouts run 8 or 16 channels per pass & the
+ * independent recursions hide each others latency. The sections use the same
+ * transposed direct form II as dsp::IIR::Filter.
+ *
+ * A section can be routed to a single channel or to mid or side. Lanes of
+ * channels a section isn't routed to get identity coefficients. Sections
+ * run in the order of the sequence, the kernel encodes the first two lanes to
+ * mid/side before a mid/side section & decodes them before a left/right one.
+ *
+ * Bypassed & identity sections are left out of the compact section list the
+ * kernel runs, so a cascade costs only as much as its sections which filter.
+ * Their state is cleared once they filter again.
+ */
+template <typename SampleType, size_t MaxSections> class BiquadCascade
+{
+public:
+    using Vec = dsp::SIMDRegister<SampleType>;
+
+    /**
+     * @brief Number of channels held by one SIMD register.
+     */
+    static constexpr size_t lanes = Vec::SIMDNumElements;
+
+    /**
+     * @brief Number of SIMD registers processed by one pass of the kernel.
+     */
+    static constexpr size_t maxRegisters = 4;
+
+    /**
+     * @brief Number of channels processed by one pass of the kernel.
+     */
+    static constexpr size_t channelsPerPass = lanes * maxRegisters;
+
+    using Coefficients = BiquadCoefficients<SampleType>;
+
+    /**
+     * @brief Constructor. All sections start as identity, routed to all
+     * channels.
+     */
+    BiquadCascade() { skipped.fill(true); }
+
+    /**
+     * @brief Allocates the filter state for the channel count in spec.
+     */
+    void prepare(const dsp::ProcessSpec& spec)
+    {
+        numGroups = (static_cast<size_t>(spec.numChannels) + lanes - 1) / lanes;
+        state1.resize(numGroups * MaxSections);
+        state2.resize(numGroups * MaxSections);
+        for (auto* registers : {&b0, &b1, &b2, &a1, &a2}) { registers->resize(numGroups * MaxSections); }
+        for (size_t section = 0; section < MaxSections; ++section) { updateKernelCoefficients(section); }
+        reset();
+    }
+
+    /**
+     * @brief Clears the filter state of all sections.
+     */
+    void reset() noexcept
+    {
+        std::fill(state1.begin(), state1.end(), Vec::expand(SampleType {0}));
+        std::fill(state2.begin(), state2.end(), Vec::expand(SampleType {0}));
+    }
+
+    /**
+     * @brief Clears the filter state of a single section.
+     */
+    void resetSection(size_t section) noexcept
+    {
+        jassert(section < MaxSections);
+        for (size_t group = 0; group < numGroups; ++group)
+        {
+            state1[group * MaxSections + section] = Vec::expand(SampleType {0});
+            state2[group * MaxSections + section] = Vec::expand(SampleType {0});
+        }
+    }
+
+    /**
+     * @brief Sets the coefficients of a section.
+     */
+    void setCoefficients(size_t section, const Coefficients& c) noexcept
+    {
+        jassert(section < MaxSections);
+        coefficients[section] = c;
+        updateKernelCoefficients(section);
+    }
+
+    /**
+     * @brief Sets the coefficients of a section from coefficients of another
+     * precision.
+     */
+    template <typename OtherType>
+    void setCoefficients(size_t section, const BiquadCoefficients<OtherType>& c) noexcept
+    {
+        setCoefficients(section, Coefficients {static_cast<SampleType>(c.b0), static_cast<SampleType>(c.b1),
+                                               static_cast<SampleType>(c.b2), static_cast<SampleType>(c.a1),
+                                               static_cast<SampleType>(c.a2)});
+    }
+
+    /**
+     * @brief Sets the coefficients of a section from a first or second order
+     * dsp::IIR::Coefficients object.
+     */
+    void setCoefficients(size_t section, const dsp::IIR::Coefficients<SampleType>& c) noexcept
+    {
+        setCoefficients(section, makeCoefficients(c));
+    }
+
+    /**
+     * @brief Converts a first or second order dsp::IIR::Coefficients object.
+     */
+    static Coefficients makeCoefficients(const dsp::IIR::Coefficients<SampleType>& c) noexcept
+    {
+        const auto* raw      = c.getRawCoefficients();
+        auto newCoefficients = Coefficients {};
+
+        if (c.getFilterOrder() == 1)
+        {
+            newCoefficients.b0 = raw[0];
+            newCoefficients.b1 = raw[1];
+            newCoefficients.a1 = raw[2];
+        }
+        else
+        {
+            jassert(c.getFilterOrder() == 2);
+            newCoefficients.b0 = raw[0];
+            newCoefficients.b1 = raw[1];
+            newCoefficients.b2 = raw[2];
+            newCoefficients.a1 = raw[3];
+            newCoefficients.a2 = raw[4];
+        }
+
+        return newCoefficients;
+    }
+
+    /**
+     * @brief Returns the coefficients of a section.
+     */
+    const Coefficients& getCoefficients(size_t section) const noexcept { return coefficients[section]; }
+
+    /**
+     * @brief A bypassed section passes its input through unchanged. The
+     * sections state is cleared, so it starts from silence once re-enabled.
+     */
+    void setBypassed(size_t section, bool shouldBeBypassed) noexcept
+    {
+        jassert(section < MaxSections);
+        if (bypassed[section] == shouldBeBypassed) { return; }
+
+        bypassed[section] = shouldBeBypassed;
+        updateKernelCoefficients(section);
+        resetSection(section);
+    }
+
+    /**
+     * @brief Returns true if the section is bypassed.
+     */
+    bool isBypassed(size_t section) const noexcept { return bypassed[section]; }
+
+    /**
+     * @brief Sets the channels a section filters. The sections state is
+     * cleared.
+     */
+    void setRouting(size_t section, ChannelRouting newRouting) noexcept
+    {
+        jassert(section < MaxSections);
+        if (routing[section] == newRouting) { return; }
+
+        routing[section] = newRouting;
+        updateKernelCoefficients(section);
+        resetSection(section);
+        order.update(routing, skipped);
+    }
+
+    /**
+     * @brief Returns the channels a section filters.
+     */
+    ChannelRouting getRouting(size_t section) const noexcept { return routing[section]; }
+
+    /**
+     * @brief Sets the number of sections which are processed. Sections at or
+     * above this index are skipped by the kernel. Newly enabled sections start
+     * from silence.
+     */
+    void setNumActiveSections(size_t newNumActiveSections) noexcept
+    {
+        std::array<size_t, MaxSections> indices {};
+        for (size_t section = 0; section < MaxSections; ++section) { indices[section] = section; }
+        setSequence(indices, newNumActiveSections);
+    }
+
+    /**
+     * @brief Sets the sections which are processed & the order they run in.
+     * Sections missing from the sequence are skipped by the kernel, sections
+     * which join it start from silence.
+     */
+    void setSequence(const std::array<size_t, MaxSections>& sequence, size_t length) noexcept
+    {
+        length = jmin(length, MaxSections);
+        for (size_t position = 0; position < length; ++position)
+        {
+            if (!order.isInSequence(sequence[position])) { resetSection(sequence[position]); }
+        }
+
+        order.setSequence(sequence, length);
+        order.update(routing, skipped);
+    }
+
+    /**
+     * @brief Returns the number of sections in the sequence, including the
+     * skipped ones.
+     */
+    size_t getNumActiveSections() const noexcept { return order.getSequenceLength(); }
+
+    /**
+     * @brief Returns the number of sections the kernel runs, the active
+     * sections which are neither bypassed nor identity.
+     */
+    size_t getNumProcessedSections() const noexcept { return order.size(); }
+
+    /**
+     * @brief Processes all channels of the block in place.
+     */
+    void process(const dsp::ProcessContextReplacing<SampleType>& context) noexcept
+    {
+        if (context.isBypassed || order.size() == 0) { return; }
+
+        auto& block            = context.getOutputBlock();
+        const auto numChannels = block.getNumChannels();
+        const auto numSamples  = block.getNumSamples();
+        jassert((numChannels + lanes - 1) / lanes <= numGroups);
+
+        for (size_t firstChannel = 0; firstChannel < numChannels; firstChannel += channelsPerPass)
+        {
+            const auto numLanes     = jmin(channelsPerPass, numChannels - firstChannel);
+            const auto numRegisters = (numLanes + lanes - 1) / lanes;
+
+            std::array<SampleType*, channelsPerPass> channels {};
+            for (size_t lane = 0; lane < numLanes; ++lane)
+            { channels[lane] = block.getChannelPointer(firstChannel + lane); }
+
+            // Kernel specialised for the number of registers & processed sections.
+            const auto kernel = kernels[numRegisters - 1][order.size()];
+            (this->*kernel)(channels.data(), numLanes, numSamples, firstChannel / lanes);
+        }
+    }
+
+private:
+    using Kernel = void (BiquadCascade::*)(SampleType* const*, size_t, size_t, size_t) noexcept;
+
+    void updateKernelCoefficients(size_t section) noexcept
+    {
+        const auto identity = Coefficients {};
+        const auto& c       = bypassed[section] ? identity : coefficients[section];
+        for (size_t group = 0; group < numGroups; ++group)
+        {
+            const auto index = group * MaxSections + section;
+            for (size_t lane = 0; lane < lanes; ++lane)
+            {
+                const auto& laneCoefficients = isRoutedTo(routing[section], group * lanes + lane) ? c : identity;
+                b0[index].set(lane, laneCoefficients.b0);
+                b1[index].set(lane, laneCoefficients.b1);
+                b2[index].set(lane, laneCoefficients.b2);
+                a1[index].set(lane, laneCoefficients.a1);
+                a2[index].set(lane, laneCoefficients.a2);
+            }
+        }
+
+        // Sections start from silence once they filter again
+        const auto shouldSkip = bypassed[section] || c.isIdentity();
+        if (shouldSkip == skipped[section]) { return; }
+
+        skipped[section] = shouldSkip;
+        if (!shouldSkip) { resetSection(section); }
+        order.update(routing, skipped);
+    }
+
+    template <size_t NumRegisters, size_t NumSections>
+    void processGroup(SampleType* const* channels, size_t numLanes, size_t numSamples, size_t firstGroup) noexcept
+    {
+        auto* s1        = &state1[firstGroup * MaxSections];
+        auto* s2        = &state2[firstGroup * MaxSections];
+        const auto* cb0 = &b0[firstGroup * MaxSections];
+        const auto* cb1 = &b1[firstGroup * MaxSections];
+        const auto* cb2 = &b2[firstGroup * MaxSections];
+        const auto* ca1 = &a1[firstGroup * MaxSections];
+        const auto* ca2 = &a2[firstGroup * MaxSections];
+
+        // Only the first two channels are encoded to mid/side
+        const auto midSide = firstGroup == 0 && numLanes >= 2;
+        std::array<MidSideTransition, NumSections + 1> transitions {};
+        for (size_t position = 0; midSide && position < NumSections; ++position)
+        { transitions[position] = order.getTransition(position); }
+        const auto decodeAtEnd = midSide && order.isMidSideAtEnd();
+
+        // Work on local copies of the state of the processed sections, so it
+        // can stay in registers.
+        std::array<std::array<Vec, NumSections + 1>, NumRegisters> z1;
+        std::array<std::array<Vec, NumSections + 1>, NumRegisters> z2;
+        for (size_t r = 0; r < NumRegisters; ++r)
+        {
+            for (size_t position = 0; position < NumSections; ++position)
+            {
+                z1[r][position] = s1[r * MaxSections + order[position]];
+                z2[r][position] = s2[r * MaxSections + order[position]];
+            }
+        }
+
+        alignas(Vec::SIMDRegisterSize) std::array<SampleType, lanes * NumRegisters> frame {};
+        std::array<Vec, NumRegisters> x;
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            for (size_t lane = 0; lane < numLanes; ++lane) { frame[lane] = channels[lane][i]; }
+            for (size_t r = 0; r < NumRegisters; ++r) { x[r] = Vec::fromRawArray(frame.data() + r * lanes); }
+
+            for (size_t position = 0; position < NumSections; ++position)
+            {
+                if (transitions[position] != MidSideTransition::None)
+                {
+                    x[0].copyToRawArray(frame.data());
+                    applyMidSideTransition(transitions[position], frame.data());
+                    x[0] = Vec::fromRawArray(frame.data());
+                }
+
+                const auto section = order[position];
+                for (size_t r = 0; r < NumRegisters; ++r)
+                {
+                    const auto index = r * MaxSections + section;
+                    const auto y     = x[r] * cb0[index] + z1[r][position];
+                    z1[r][position]  = x[r] * cb1[index] - y * ca1[index] + z2[r][position];
+                    z2[r][position]  = x[r] * cb2[index] - y * ca2[index];
+                    x[r]             = y;
+                }
+            }
+
+            for (size_t r = 0; r < NumRegisters; ++r) { x[r].copyToRawArray(frame.data() + r * lanes); }
+            if (decodeAtEnd) { decodeMidSide(frame.data()); }
+            for (size_t lane = 0; lane < numLanes; ++lane) { channels[lane][i] = frame[lane]; }
+        }
+
+        for (size_t r = 0; r < NumRegisters; ++r)
+        {
+            for (size_t position = 0; position < NumSections; ++position)
+            {
+                s1[r * MaxSections + order[position]] = z1[r][position];
+                s2[r * MaxSections + order[position]] = z2[r][position];
+            }
+        }
+    }
+
+    template <size_t NumRegisters, size_t... NumSections>
+    static constexpr std::array<Kernel, sizeof...(NumSections)> makeKernels(std::index_sequence<NumSections...>)
+    {
+        return {{&BiquadCascade::processGroup<NumRegisters, NumSections>...}};
+    }
+
+    template <size_t... NumRegisters>
+    static constexpr std::array<std::array<Kernel, MaxSections + 1>, sizeof...(NumRegisters)>
+    makeKernelTable(std::index_sequence<NumRegisters...>)
+    {
+        return {{makeKernels<NumRegisters + 1>(std::make_index_sequence<MaxSections + 1> {})...}};
+    }
+
+    static constexpr auto kernels = makeKernelTable(std::make_index_sequence<maxRegisters> {});
+
+    std::array<Coefficients, MaxSections> coefficients {};
+    std::array<bool, MaxSections> bypassed {};
+    std::array<bool, MaxSections> skipped {};
+    std::array<ChannelRouting, MaxSections> routing {};
+    SectionOrder<MaxSections> order;
+
+    // Coefficients per lane, MaxSections registers per channel group of one
+    // SIMD register.
+    std::vector<Vec> b0, b1, b2, a1, a2;
+
+    // Filter state, MaxSections registers per channel group.
+    std::vector<Vec> state1;
+    std::vector<Vec> state2;
+    size_t numGroups {0};
+};
+
+}  // namespace tobanteAudio
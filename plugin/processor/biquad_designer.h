@@ -0,0 +1,168 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "biquad_cascade.h"
+
+namespace tobanteAudio
+{
+/**
+ * @brief Computes second order section coefficients without allocating.
+ *
+ * @details Uses the same formulas as the dsp::IIR::Coefficients factory
+ * functions, but returns the normalised coefficients by value. Safe to call
+ * from the audio thread.
+ */
+template <typename SampleType> struct BiquadDesigner
+{
+    using Coefficients = BiquadCoefficients<SampleType>;
+
+    /**
+     * @brief Returns a section which passes the signal through unchanged.
+     */
+    static Coefficients makeIdentity() noexcept { return {}; }
+
+    /**
+     * @brief Second order low-pass.
+     */
+    static Coefficients makeLowPass(double sampleRate, double frequency, double Q) noexcept
+    {
+        const auto n        = 1.0 / std::tan(MathConstants<double>::pi * frequency / sampleRate);
+        const auto nSquared = n * n;
+        const auto invQ     = 1.0 / Q;
+        const auto c1       = 1.0 / (1.0 + invQ * n + nSquared);
+
+        return make(c1, c1 * 2.0, c1, 1.0, c1 * 2.0 * (1.0 - nSquared), c1 * (1.0 - invQ * n + nSquared));
+    }
+
+    /**
+     * @brief Second order high-pass.
+     */
+    static Coefficients makeHighPass(double sampleRate, double frequency, double Q) noexcept
+    {
+        const auto n        = std::tan(MathConstants<double>::pi * frequency / sampleRate);
+        const auto nSquared = n * n;
+        const auto invQ     = 1.0 / Q;
+        const auto c1       = 1.0 / (1.0 + invQ * n + nSquared);
+
+        return make(c1, c1 * -2.0, c1, 1.0, c1 * 2.0 * (nSquared - 1.0), c1 * (1.0 - invQ * n + nSquared));
+    }
+
+    /**
+     * @brief Second order band-pass with 0 dB peak gain.
+     */
+    static Coefficients makeBandPass(double sampleRate, double frequency, double Q) noexcept
+    {
+        const auto n        = 1.0 / std::tan(MathConstants<double>::pi * frequency / sampleRate);
+        const auto nSquared = n * n;
+        const auto invQ     = 1.0 / Q;
+        const auto c1       = 1.0 / (1.0 + invQ * n + nSquared);
+
+        return make(c1 * n * invQ, 0.0, -c1 * n * invQ, 1.0, c1 * 2.0 * (1.0 - nSquared),
+                    c1 * (1.0 - invQ * n + nSquared));
+    }
+
+    /**
+     * @brief Second order low-shelf. Gain is a linear factor.
+     */
+    static Coefficients makeLowShelf(double sampleRate, double frequency, double Q, double gainFactor) noexcept
+    {
+        const auto A                = jmax(0.0, std::sqrt(gainFactor));
+        const auto aminus1          = A - 1.0;
+        const auto aplus1           = A + 1.0;
+        const auto omega            = (MathConstants<double>::twoPi * jmax(frequency, 2.0)) / sampleRate;
+        const auto coso             = std::cos(omega);
+        const auto beta             = std::sin(omega) * std::sqrt(A) / Q;
+        const auto aminus1TimesCoso = aminus1 * coso;
+
+        return make(A * (aplus1 - aminus1TimesCoso + beta), A * 2.0 * (aminus1 - aplus1 * coso),
+                    A * (aplus1 - aminus1TimesCoso - beta), aplus1 + aminus1TimesCoso + beta,
+                    -2.0 * (aminus1 + aplus1 * coso), aplus1 + aminus1TimesCoso - beta);
+    }
+
+    /**
+     * @brief Second order high-shelf. Gain is a linear factor.
+     */
+    static Coefficients makeHighShelf(double sampleRate, double frequency, double Q, double gainFactor) noexcept
+    {
+        const auto A                = jmax(0.0, std::sqrt(gainFactor));
+        const auto aminus1          = A - 1.0;
+        const auto aplus1           = A + 1.0;
+        const auto omega            = (MathConstants<double>::twoPi * jmax(frequency, 2.0)) / sampleRate;
+        const auto coso             = std::cos(omega);
+        const auto beta             = std::sin(omega) * std::sqrt(A) / Q;
+        const auto aminus1TimesCoso = aminus1 * coso;
+
+        return make(A * (aplus1 + aminus1TimesCoso + beta), A * -2.0 * (aminus1 + aplus1 * coso),
+                    A * (aplus1 + aminus1TimesCoso - beta), aplus1 - aminus1TimesCoso + beta,
+                    2.0 * (aminus1 - aplus1 * coso), aplus1 - aminus1TimesCoso - beta);
+    }
+
+    /**
+     * @brief Second order peak (bell). Gain is a linear factor.
+     */
+    static Coefficients makePeakFilter(double sampleRate, double frequency, double Q, double gainFactor) noexcept
+    {
+        const auto A           = jmax(0.0, std::sqrt(gainFactor));
+        const auto omega       = (MathConstants<double>::twoPi * jmax(frequency, 2.0)) / sampleRate;
+        const auto alpha       = std::sin(omega) / (Q * 2.0);
+        const auto c2          = -2.0 * std::cos(omega);
+        const auto alphaTimesA = alpha * A;
+        const auto alphaOverA  = alpha / A;
+
+        return make(1.0 + alphaTimesA, c2, 1.0 - alphaTimesA, 1.0 + alphaOverA, c2, 1.0 - alphaOverA);
+    }
+
+    /**
+     * @brief Returns the number of samples the impulse response of a section
+     * takes to decay by the given attenuation, from the radius of its slowest
+     * pole. Unstable sections never decay.
+     */
+    static double getDecaySamples(const Coefficients& c, double attenuationDb) noexcept
+    {
+        const auto a1           = static_cast<double>(c.a1);
+        const auto a2           = static_cast<double>(c.a2);
+        const auto discriminant = a1 * a1 - 4.0 * a2;
+        const auto radius       = discriminant < 0.0 ? std::sqrt(a2) : 0.5 * (std::abs(a1) + std::sqrt(discriminant));
+
+        // Without feedback the response ends after the two delays
+        if (radius <= 0.0) { return 2.0; }
+        if (radius >= 1.0) { return std::numeric_limits<double>::infinity(); }
+        return std::log(std::pow(10.0, -attenuationDb / 20.0)) / std::log(radius);
+    }
+
+private:
+    static Coefficients make(double b0, double b1, double b2, double a0, double a1, double a2) noexcept
+    {
+        jassert(a0 != 0.0);
+        const auto a0Inv = 1.0 / a0;
+
+        auto c = Coefficients {};
+        c.b0   = static_cast<SampleType>(b0 * a0Inv);
+        c.b1   = static_cast<SampleType>(b1 * a0Inv);
+        c.b2   = static_cast<SampleType>(b2 * a0Inv);
+        c.a1   = static_cast<SampleType>(a1 * a0Inv);
+        c.a2   = static_cast<SampleType>(a2 * a0Inv);
+        return c;
+    }
+};
+
+}  // namespace tobanteAudio
@@ -0,0 +1,221 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+namespace tobanteAudio
+{
+/**
+ * @brief Channels a section filters. Left & right are the first two channels,
+ * mid & side the first two channels after mid/side encoding. The remaining
+ * channels are only filtered by stereo sections.
+ */
+enum class ChannelRouting
+{
+    Stereo = 0,
+    Left,
+    Right,
+    Mid,
+    Side,
+};
+
+/**
+ * @brief Returns true if a section with the routing filters the channel.
+ */
+inline bool isRoutedTo(ChannelRouting routing, size_t channel) noexcept
+{
+    switch (routing)
+    {
+    case ChannelRouting::Left:
+    case ChannelRouting::Mid:
+        return channel == 0;
+    case ChannelRouting::Right:
+    case ChannelRouting::Side:
+        return channel == 1;
+    case ChannelRouting::Stereo:
+    default:
+        return true;
+    }
+}
+
+/**
+ * @brief Returns true if the routing needs mid/side encoded channels.
+ */
+inline bool isMidSide(ChannelRouting routing) noexcept
+{
+    return routing == ChannelRouting::Mid || routing == ChannelRouting::Side;
+}
+
+/**
+ * @brief Returns true if the routing filters a single left or right channel.
+ */
+inline bool isLeftRight(ChannelRouting routing) noexcept
+{
+    return routing == ChannelRouting::Left || routing == ChannelRouting::Right;
+}
+
+/**
+ * @brief Encodes the first two lanes of a frame to mid & side.
+ */
+template <typename SampleType> void encodeMidSide(SampleType* frame) noexcept
+{
+    const auto left  = frame[0];
+    const auto right = frame[1];
+    frame[0]         = (left + right) * SampleType(0.5);
+    frame[1]         = (left - right) * SampleType(0.5);
+}
+
+/**
+ * @brief Decodes the first two lanes of a frame back to left & right.
+ */
+template <typename SampleType> void decodeMidSide(SampleType* frame) noexcept
+{
+    const auto mid  = frame[0];
+    const auto side = frame[1];
+    frame[0]        = mid + side;
+    frame[1]        = mid - side;
+}
+
+/**
+ * @brief Change of the first two channels before a section is processed.
+ */
+enum class MidSideTransition
+{
+    None = 0,
+    Encode,
+    Decode,
+};
+
+/**
+ * @brief Encodes or decodes the first two lanes of a frame.
+ */
+template <typename SampleType> void applyMidSideTransition(MidSideTransition transition, SampleType* frame) noexcept
+{
+    if (transition == MidSideTransition::Encode) { encodeMidSide(frame); }
+    if (transition == MidSideTransition::Decode) { decodeMidSide(frame); }
+}
+
+/**
+ * @brief Compact list of the sections a cascade processes, in the order of
+ * its sequence. Left/right sections don't commute with the mid/side matrix,
+ * so the channels are encoded before a mid/side section which follows a
+ * left/right one & decoded again before the next left/right section. Stereo
+ * sections filter both channels alike & run on whichever pair is current.
+ * Skipped sections, which are bypassed or pass their input through anyway,
+ * are left out.
+ */
+template <size_t MaxSections> class SectionOrder
+{
+public:
+    /**
+     * @brief Constructor. The sequence starts as all sections in index order.
+     */
+    SectionOrder()
+    {
+        for (size_t section = 0; section < MaxSections; ++section) { sequence[section] = section; }
+        inSequence.fill(true);
+    }
+
+    /**
+     * @brief Sets the sections which are processed & their order. Takes
+     * effect with the next update().
+     */
+    void setSequence(const std::array<size_t, MaxSections>& newSequence, size_t length) noexcept
+    {
+        sequenceLength = jmin(length, MaxSections);
+        inSequence.fill(false);
+        for (size_t position = 0; position < sequenceLength; ++position)
+        {
+            jassert(newSequence[position] < MaxSections);
+            sequence[position]                = newSequence[position];
+            inSequence[newSequence[position]] = true;
+        }
+    }
+
+    /**
+     * @brief Returns the number of sections in the sequence, including the
+     * skipped ones.
+     */
+    size_t getSequenceLength() const noexcept { return sequenceLength; }
+
+    /**
+     * @brief Returns true if the section is part of the sequence.
+     */
+    bool isInSequence(size_t section) const noexcept { return inSequence[section]; }
+
+    /**
+     * @brief Lists the sections of the sequence which aren't skipped,
+     * together with the transition each of them needs.
+     */
+    void update(const std::array<ChannelRouting, MaxSections>& routing,
+                const std::array<bool, MaxSections>& skipped) noexcept
+    {
+        auto position = size_t {0};
+        auto midSide  = false;
+        for (size_t i = 0; i < sequenceLength; ++i)
+        {
+            const auto section = sequence[i];
+            if (skipped[section]) { continue; }
+
+            auto transition = MidSideTransition::None;
+            if (isMidSide(routing[section]) && !midSide) { transition = MidSideTransition::Encode; }
+            if (isLeftRight(routing[section]) && midSide) { transition = MidSideTransition::Decode; }
+            if (transition != MidSideTransition::None) { midSide = !midSide; }
+
+            order[position]       = section;
+            transitions[position] = transition;
+            ++position;
+        }
+
+        endsInMidSide = midSide;
+        numProcessed  = position;
+    }
+
+    /**
+     * @brief Returns the number of sections which are processed.
+     */
+    size_t size() const noexcept { return numProcessed; }
+
+    /**
+     * @brief Returns the section processed at the given position.
+     */
+    size_t operator[](size_t position) const noexcept { return order[position]; }
+
+    /**
+     * @brief Returns the transition before the section at the given position.
+     */
+    MidSideTransition getTransition(size_t position) const noexcept { return transitions[position]; }
+
+    /**
+     * @brief Returns true if the channels have to be decoded after the last
+     * section.
+     */
+    bool isMidSideAtEnd() const noexcept { return endsInMidSide; }
+
+private:
+    std::array<size_t, MaxSections> sequence {};
+    std::array<bool, MaxSections> inSequence {};
+    size_t sequenceLength {MaxSections};
+    std::array<size_t, MaxSections> order {};
+    std::array<MidSideTransition, MaxSections> transitions {};
+    bool endsInMidSide {false};
+    size_t numProcessed {0};
+};
+
+}  // namespace tobanteAudio
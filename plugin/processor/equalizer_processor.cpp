@@ -22,15 +22,24 @@ namespace tobanteAudio
 {
 EqualizerProcessor::EqualizerProcessor(AudioProcessorValueTreeState& vts) : BaseProcessor(vts)
 {
-    frequencies.resize(300);
-    for (size_t i = 0; i < frequencies.size(); ++i) { frequencies[i] = 20.0 * std::pow(2.0, i / 30.0); }
-    magnitudes.resize(frequencies.size());
-
-    // needs to be in sync with the ProcessorChain filter
-    bands.resize(6);
+    // Parameters exist for every band, only the first numBands are processed
+    bands.resize(maxFilterBands);
+    resizeResponseGrid(RESPONSE_DEFAULT_POINTS);
 
     setDefaults();
 
+    // Parameter IDs are built once, the listeners & the views look them up
+    bandParamIDs.resize(bands.size());
+    bandParameterValues.resize(bands.size());
+    for (size_t i = 0; i < bands.size(); ++i)
+    {
+        for (int parameter = 0; parameter < LastBandParameterID; ++parameter)
+        {
+            const auto& suffix = getBandParameterSuffix(static_cast<BandParameter>(parameter));
+            bandParamIDs[i][static_cast<size_t>(parameter)] = bands[i].name + "-" + suffix;
+        }
+    }
+
     // Create Ranges for parameters
     using tobanteAudio::FILTER_FREQ_MAX;
     using tobanteAudio::FILTER_FREQ_MIN;
@@ -50,25 +59,31 @@ EqualizerProcessor::EqualizerProcessor(AudioProcessorValueTreeState& vts) : Base
     qualityRange.setSkewForCentre(1.0f);
     gainRange.setSkewForCentre(1.0f);
 
-    for (int i = 0; i < static_cast<int>(bands.size()); ++i)
-    {
-        auto& band = bands[size_t(i)];
+    NormalisableRange<float> thresholdRange(DYNAMIC_THRESHOLD_MIN, DYNAMIC_THRESHOLD_MAX, 0.1f);
+    NormalisableRange<float> ratioRange(DYNAMIC_RATIO_MIN, DYNAMIC_RATIO_MAX, 0.01f);
+    NormalisableRange<float> attackRange(DYNAMIC_ATTACK_MIN, DYNAMIC_ATTACK_MAX, 0.01f);
+    NormalisableRange<float> releaseRange(DYNAMIC_RELEASE_MIN, DYNAMIC_RELEASE_MAX, 0.1f);
 
-        // Generate random rgb colour
-        const auto colour = []() -> Colour {
-            auto& random = Random::getSystemRandom();
-            const auto r = static_cast<uint8>(random.nextInt(256));
-            const auto g = static_cast<uint8>(random.nextInt(256));
-            const auto b = static_cast<uint8>(random.nextInt(256));
-            return Colour(r, g, b).brighter(0.6f);
-        }();
+    ratioRange.setSkewForCentre(4.0f);
+    attackRange.setSkewForCentre(10.0f);
+    releaseRange.setSkewForCentre(200.0f);
 
-        band.colour = colour;
-        band.magnitudes.resize(frequencies.size(), 1.0);
+    const auto keys = StringArray {translate("Input"), translate("Sidechain")};
+
+    auto routings = StringArray {};
+    for (auto routing = 0; routing <= static_cast<int>(tobanteAudio::ChannelRouting::Side); ++routing)
+    { routings.add(getChannelRoutingName(static_cast<tobanteAudio::ChannelRouting>(routing))); }
 
-        // ValueTree parameters
+    auto slopes = StringArray {};
+    for (int slope = 0; slope < tobanteAudio::EqualizerProcessor::LastSlopeID; ++slope)
+    { slopes.add(getFilterSlopeName(static_cast<FilterSlope>(slope))); }
+
+    // ValueTree parameters
+    const auto addBaseParameters = [&](const int i) {
         using Parameter = AudioProcessorValueTreeState::Parameter;
 
+        const auto& band = bands[size_t(i)];
+
         state.createAndAddParameter(std::make_unique<Parameter>(
             getFrequencyParamID(i), band.name + " freq", "Frequency", frequencyRange, band.frequency,
             frequencyTextConverter, frequencyTextConverter, false, true, false));
@@ -85,28 +100,149 @@ EqualizerProcessor::EqualizerProcessor(AudioProcessorValueTreeState& vts) : Base
         state.createAndAddParameter(std::make_unique<Parameter>(
             getTypeParamID(i), band.name + " Type", translate("Filter Type"), filterTypeRange,
             static_cast<float>(band.type), filterTypeTextConverter, filterTypeTextConverter, false, true, true));
+    };
+
+    // Hosts address automation by the parameter order. The parameters of the
+    // default bands keep their place, the ones added since follow them
+    for (int i = 0; i < FILTER_DEFAULT_NUM_BANDS; ++i) { addBaseParameters(i); }
+
+    for (int i = 0; i < static_cast<int>(bands.size()); ++i)
+    {
+        auto& band = bands[size_t(i)];
+
+        // Generate random rgb colour
+        const auto colour = []() -> Colour {
+            auto& random = Random::getSystemRandom();
+            const auto r = static_cast<uint8>(random.nextInt(256));
+            const auto g = static_cast<uint8>(random.nextInt(256));
+            const auto b = static_cast<uint8>(random.nextInt(256));
+            return Colour(r, g, b).brighter(0.6f);
+        }();
+
+        band.colour = colour;
+
+        if (i >= FILTER_DEFAULT_NUM_BANDS) { addBaseParameters(i); }
+        state.createAndAddParameter(std::make_unique<AudioParameterChoice>(
+            getSlopeParamID(i), band.name + " Slope", slopes, static_cast<int>(band.slope)));
+        state.createAndAddParameter(std::make_unique<AudioParameterChoice>(
+            getRoutingParamID(i), band.name + " Routing", routings, static_cast<int>(band.routing)));
+
+        // Dynamics
+        state.createAndAddParameter(
+            std::make_unique<AudioParameterBool>(getDynamicParamID(i), band.name + " Dynamic", band.dynamic));
+        state.createAndAddParameter(std::make_unique<AudioParameterFloat>(
+            getThresholdParamID(i), band.name + " Threshold", thresholdRange, band.threshold, "dB"));
+        state.createAndAddParameter(std::make_unique<AudioParameterFloat>(getRatioParamID(i), band.name + " Ratio",
+                                                                          ratioRange, band.ratio, ":1"));
+        state.createAndAddParameter(std::make_unique<AudioParameterFloat>(getAttackParamID(i), band.name + " Attack",
+                                                                          attackRange, band.attack, "ms"));
+        state.createAndAddParameter(std::make_unique<AudioParameterFloat>(
+            getReleaseParamID(i), band.name + " Release", releaseRange, band.release, "ms"));
+        state.createAndAddParameter(std::make_unique<AudioParameterChoice>(getKeyParamID(i), band.name + " Key", keys,
+                                                                           band.sidechainKey ? 1 : 0));
 
-        state.addParameterListener(getTypeParamID(i), this);
-        state.addParameterListener(getFrequencyParamID(i), this);
-        state.addParameterListener(getQualityParamID(i), this);
-        state.addParameterListener(getGainParamID(i), this);
-        state.addParameterListener(getActiveParamID(i), this);
+        // Each band parameter gets its own listener, which marks its band
+        for (int parameter = 0; parameter < LastBandParameterID; ++parameter)
+        {
+            const auto id = static_cast<BandParameter>(parameter);
+            bandParameterValues[size_t(i)][size_t(parameter)] = state.getRawParameterValue(getBandParamID(i, id));
+            bandParameterListeners.push_back(std::make_unique<BandParameterListener>(*this, size_t(i)));
+            state.addParameterListener(getBandParamID(i, id), bandParameterListeners.back().get());
+        }
     }
+
+    // Oversampling
+    auto factors = StringArray {translate("Off")};
+    for (int order = 1; order <= OVERSAMPLING_MAX_ORDER; ++order) { factors.add(String(1 << order) + "x"); }
+    const auto filterTypes = StringArray {translate("Polyphase IIR"), translate("FIR")};
+
+    state.createAndAddParameter(std::make_unique<AudioParameterChoice>(tobanteAudio::Parameters::Oversampling,
+                                                                       translate("Oversampling"), factors, 0));
+    state.createAndAddParameter(std::make_unique<AudioParameterChoice>(
+        tobanteAudio::Parameters::OversamplingFilter, translate("Oversampling Filter"), filterTypes, 0));
+
+    state.addParameterListener(tobanteAudio::Parameters::Oversampling, this);
+    state.addParameterListener(tobanteAudio::Parameters::OversamplingFilter, this);
+    oversamplingOrder  = state.getRawParameterValue(tobanteAudio::Parameters::Oversampling);
+    oversamplingFilter = state.getRawParameterValue(tobanteAudio::Parameters::OversamplingFilter);
+
+    // Phase
+    const auto phaseModes = StringArray {translate("Minimum Phase"), translate("Linear Phase")};
+    state.createAndAddParameter(
+        std::make_unique<AudioParameterChoice>(tobanteAudio::Parameters::Phase, translate("Phase"), phaseModes, 0));
+    state.addParameterListener(tobanteAudio::Parameters::Phase, this);
+    phaseMode = state.getRawParameterValue(tobanteAudio::Parameters::Phase);
+
+    // Design
+    const auto designs = StringArray {translate("Bilinear"), translate("Matched")};
+    state.createAndAddParameter(
+        std::make_unique<AudioParameterChoice>(tobanteAudio::Parameters::Design, translate("Design"), designs, 0));
+    state.addParameterListener(tobanteAudio::Parameters::Design, this);
+    designMethod = state.getRawParameterValue(tobanteAudio::Parameters::Design);
+
+    // Topology
+    const auto topologies = StringArray {translate("Biquad"), translate("State Variable")};
+    state.createAndAddParameter(std::make_unique<AudioParameterChoice>(tobanteAudio::Parameters::Topology,
+                                                                       translate("Topology"), topologies, 0));
+    state.addParameterListener(tobanteAudio::Parameters::Topology, this);
+    topology = state.getRawParameterValue(tobanteAudio::Parameters::Topology);
+
+    // Analyser
+    const auto analyserModes = StringArray {translate("Stereo"), translate("Mid"), translate("Side")};
+    state.createAndAddParameter(std::make_unique<AudioParameterChoice>(
+        tobanteAudio::Parameters::AnalyserChannels, translate("Analyser Channels"), analyserModes, 0));
+    analyserChannels = state.getRawParameterValue(tobanteAudio::Parameters::AnalyserChannels);
+
+    state.state.addListener(this);
+    updateNumBands();
+
+    // Responses & plots of changed bands are recomputed on the message thread,
+    // their curves in the background
+    startTimerHz(GLOBAL_REFRESH_RATE_HZ);
+    responseWorker.startThread(1);
 }
 
 EqualizerProcessor::~EqualizerProcessor()
 {
+    stopTimer();
+
+    for (size_t i = 0; i < bandParameterListeners.size(); ++i)
+    {
+        const auto band      = static_cast<int>(i) / LastBandParameterID;
+        const auto parameter = static_cast<BandParameter>(static_cast<int>(i) % LastBandParameterID);
+        state.removeParameterListener(getBandParamID(band, parameter), bandParameterListeners[i].get());
+    }
+
+    state.state.removeListener(this);
     inputAnalyser.stopThread(1000);
     outputAnalyser.stopThread(1000);
 }
 
 void EqualizerProcessor::prepareToPlay(double newSampleRate, int samplesPerBlock)
 {
+    // The designer writes to the convolver, which is reallocated below
+    linearPhaseDesigner.stopThread(1000);
+
     sampleRate = newSampleRate;
 
+    for (auto& smoother : smoothers)
+    {
+        smoother.frequency.reset(sampleRate, FILTER_SMOOTHING_SECONDS);
+        smoother.quality.reset(sampleRate, FILTER_SMOOTHING_SECONDS);
+        smoother.gain.reset(sampleRate, FILTER_SMOOTHING_SECONDS);
+    }
+    snapSmoothers = true;
+
     for (size_t i = 0; i < bands.size(); ++i) { updateBand(i); }
+    const auto lowered = limitSlopeSections(~uint64 {0});
+    for (size_t i = 0; i < bands.size(); ++i)
+    {
+        if ((lowered & (uint64 {1} << i)) != 0) { updateBand(i); }
+    }
 
-    updatePlots();
+    // The first kernel below is designed from these curves
+    updateBypassedStates();
+    updateResponsesNow();
 
     inputAnalyser.setupAnalyser(int(sampleRate), float(sampleRate));
     outputAnalyser.setupAnalyser(int(sampleRate), float(sampleRate));
@@ -117,56 +253,531 @@ void EqualizerProcessor::prepareToPlay(double newSampleRate, int samplesPerBlock
     spec.numChannels      = static_cast<uint32>(getTotalNumOutputChannels());
 
     filter.prepare(spec);
+    doubleFilter.prepare(spec);
+    detector.prepare(sampleRate, samplesPerBlock);
+    sidechainDetector.prepare(sampleRate, samplesPerBlock);
+    // The ramps run at the oversampled rate
+    const auto numRampSamples = samplesPerBlock * (1 << OVERSAMPLING_MAX_ORDER);
+    frequencyRamps.setSize(isUsingDoublePrecision() ? 0 : static_cast<int>(maxFilterBands), numRampSamples);
+    doubleFrequencyRamps.setSize(isUsingDoublePrecision() ? static_cast<int>(maxFilterBands) : 0, numRampSamples);
+
+    // The analysers only take float, double buffers are converted first. Of
+    // an ambisonic bed only the omnidirectional W channel is analysed.
+    analyserBuffer.setSize(static_cast<int>(spec.numChannels), samplesPerBlock);
+    const auto layout   = getChannelLayoutOfBus(false, 0);
+    numAnalyserChannels = isAmbisonic(layout) ? 1 : static_cast<int>(spec.numChannels);
+
+    // Only the oversamplers for the current precision are needed
+    const auto numChannels = static_cast<int>(spec.numChannels);
+    if (isUsingDoublePrecision())
+    {
+        prepareOversamplers(doubleOversamplers, numChannels, samplesPerBlock);
+        for (auto& oversampler : oversamplers) { oversampler.reset(); }
+    }
+    else
+    {
+        prepareOversamplers(oversamplers, numChannels, samplesPerBlock);
+        for (auto& oversampler : doubleOversamplers) { oversampler.reset(); }
+    }
+
+    // The first block picks up the oversampling mode & redesigns the sections
+    activeOversampler = -1;
+    filterSampleRate  = sampleRate;
+
+    // Start processing, even if the first blocks are silent
+    silentSamples = 0;
+    idle          = false;
+
+    // The first kernel is designed right away, later ones in the background
+    convolver.prepare(numChannels, LINEAR_PHASE_PARTITION_SIZE, linearPhaseDesigner.getKernelLength());
+    convolutionBuffer.setSize(isUsingDoublePrecision() ? numChannels : 0, samplesPerBlock);
+    wasLinearPhase = false;
+    linearPhaseDesigner.updateNow();
+    linearPhaseDesigner.startThread(3);
+
+    updateLatency();
+}
+
+double EqualizerProcessor::getTailLengthSeconds() const
+{
+    if (sampleRate <= 0) { return 0.0; }
+
+    // The linear-phase kernel keeps ringing for its second half, the cascade
+    // until its slowest band has decayed
+    auto tail = static_cast<double>(getLatencySamples()) / sampleRate;
+    if (isLinearPhase()) { return tail + linearPhaseDesigner.getKernelDelay() / sampleRate; }
+
+    const auto solo    = soloed.load();
+    const auto hasSolo = isPositiveAndBelow(solo, numBands);
+    for (auto i = 0; i < numBands; ++i)
+    {
+        const auto& band = bands[static_cast<size_t>(i)];
+        if (hasSolo ? i == solo : band.active) { tail += band.tailSeconds; }
+    }
+
+    return tail;
+}
+
+bool EqualizerProcessor::isLinearPhase() const { return phaseMode->load() >= 0.5f; }
+
+bool EqualizerProcessor::isStateVariable() const { return roundToInt(topology->load()) == 1; }
+
+void EqualizerProcessor::setBandModulation(const int band, const float frequencyRatio, const float qualityRatio,
+                                           const float gainRatio) noexcept
+{
+    if (!isPositiveAndBelow(band, maxFilterBands)) { return; }
+
+    auto& smoother = smoothers[static_cast<size_t>(band)];
+    if (smoother.frequencyRatio == frequencyRatio && smoother.qualityRatio == qualityRatio
+        && smoother.gainRatio == gainRatio)
+    { return; }
+
+    smoother.frequencyRatio    = frequencyRatio;
+    smoother.qualityRatio      = qualityRatio;
+    smoother.gainRatio         = gainRatio;
+    smoother.modulationChanged = true;
 }
 
+void EqualizerProcessor::setSidechain(const AudioBuffer<float>* buffer) noexcept { sidechain = buffer; }
+
+void EqualizerProcessor::setSidechain(const AudioBuffer<double>* buffer) noexcept { doubleSidechain = buffer; }
+
 void EqualizerProcessor::processBlock(AudioBuffer<float>& buffer, MidiBuffer& midiBuffer)
 {
     juce::ignoreUnused(midiBuffer);
+    processSubBlock(buffer, 0);
+}
+
+void EqualizerProcessor::processBlock(AudioBuffer<double>& buffer, MidiBuffer& midiBuffer)
+{
+    juce::ignoreUnused(midiBuffer);
+    processSubBlock(buffer, 0);
+}
+
+void EqualizerProcessor::processSubBlock(AudioBuffer<float>& buffer, const int startSample)
+{
+    // Parameter changes are collected once per block
+    if (startSample == 0) { applyBandChanges(); }
+    applySnapshot();
+
+    // Only digital silence skips everything once the tails have decayed,
+    // quiet input is still equalized & gained
+    const auto inputSilent = isSilent(buffer, 0.0f);
+    if (inputSilent && idle) { return; }
+
+    addAnalyserData(inputAnalyser, buffer);
+    processFilter(buffer, filter, oversamplers, frequencyRamps, sidechain, startSample);
+    addAnalyserData(outputAnalyser, buffer);
+    updateIdleState(buffer, inputSilent);
+}
+
+void EqualizerProcessor::processSubBlock(AudioBuffer<double>& buffer, const int startSample)
+{
+    // Parameter changes are collected once per block
+    if (startSample == 0) { applyBandChanges(); }
+    applySnapshot();
+
+    // Only digital silence skips everything once the tails have decayed,
+    // quiet input is still equalized & gained
+    const auto inputSilent = isSilent(buffer, 0.0);
+    if (inputSilent && idle) { return; }
+
+    analyserBuffer.makeCopyOf(buffer, true);
+    addAnalyserData(inputAnalyser, analyserBuffer);
+
+    processFilter(buffer, doubleFilter, doubleOversamplers, doubleFrequencyRamps, doubleSidechain, startSample);
+
+    analyserBuffer.makeCopyOf(buffer, true);
+    addAnalyserData(outputAnalyser, analyserBuffer);
+    updateIdleState(buffer, inputSilent);
+}
+
+void EqualizerProcessor::updateModulationMode() noexcept
+{
+    // Only the state variable sections take per-sample ratios, at the rate
+    // they run at. Bands with a frequency ratio are redesigned for the new
+    // mode, the ramps continue from the ratio the design had.
+    const auto audioRate = isStateVariable() && !isLinearPhase();
+    if (audioRate == audioRateModulation) { return; }
+
+    audioRateModulation = audioRate;
+    for (auto& smoother : smoothers)
+    {
+        smoother.appliedFrequencyRatio = smoother.frequencyRatio;
+        if (smoother.frequencyRatio != 1.0f) { smoother.modulationChanged = true; }
+    }
+}
+
+template <typename SampleType>
+void EqualizerProcessor::renderFrequencyRamps(AudioBuffer<SampleType>& ramps, const int numSamples,
+                                              std::array<const SampleType*, maxFilterBands>& modulation) noexcept
+{
+    if (!audioRateModulation || ramps.getNumSamples() < numSamples) { return; }
+
+    for (size_t band = 0; band < maxFilterBands; ++band)
+    {
+        // Modulated frequencies stay within the parameter range, the same as
+        // the control-rate design
+        auto& smoother       = smoothers[band];
+        const auto frequency = smoother.frequency.getCurrentValue();
+        const auto start     = smoother.appliedFrequencyRatio;
+        const auto target
+            = jlimit(FILTER_FREQ_MIN / frequency, FILTER_FREQ_MAX / frequency, smoother.frequencyRatio);
+        if (start == 1.0f && target == 1.0f) { continue; }
+
+        auto* ratios    = ramps.getWritePointer(static_cast<int>(band));
+        const auto step = (target - start) / static_cast<float>(numSamples);
+        for (int i = 0; i < numSamples; ++i) { ratios[i] = static_cast<SampleType>(start + step * (i + 1)); }
+        smoother.appliedFrequencyRatio = target;
+        modulation[band]               = ratios;
+    }
+}
+
+template <typename SampleType>
+bool EqualizerProcessor::isSilent(const AudioBuffer<SampleType>& buffer, const SampleType threshold) noexcept
+{
+    // Stops at the first audible sample instead of taking the peak of the
+    // whole block, signal is told apart on its first sample
+    const auto audible = [threshold](const SampleType sample) { return std::abs(sample) > threshold; };
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        const auto* samples = buffer.getReadPointer(channel);
+        if (std::any_of(samples, samples + buffer.getNumSamples(), audible)) { return false; }
+    }
 
-    inputAnalyser.addAudioData(buffer, 0, getTotalNumInputChannels());
+    return true;
+}
+
+template <typename SampleType>
+void EqualizerProcessor::updateIdleState(const AudioBuffer<SampleType>& buffer, const bool inputSilent)
+{
+    if (!inputSilent)
+    {
+        silentSamples = 0;
+        idle          = false;
+        return;
+    }
+
+    // The filters keep ringing after the input stopped, wait for the tail of
+    // all bands & the latency to pass, then for the output to decay as well.
+    // The output is only read once the tail has passed
+    silentSamples = jmin(silentSamples + buffer.getNumSamples(), std::numeric_limits<int>::max() / 2);
+    auto tail     = tailSamples + getLatencySamples();
+    if (isLinearPhase()) { tail += linearPhaseDesigner.getKernelLength(); }
+    const auto threshold = static_cast<SampleType>(SILENCE_THRESHOLD_LEVEL);
+    if (silentSamples < tail || !isSilent(buffer, threshold)) { return; }
+
+    // Without input the detectors would release all the same
+    idle = true;
+    detector.reset();
+    sidechainDetector.reset();
+}
+
+void EqualizerProcessor::addAnalyserData(tobanteAudio::SpectrumAnalyser<float>& analyser,
+                                         const AudioBuffer<float>& buffer)
+{
+    const auto mode = static_cast<int>(*analyserChannels);
+    if (mode == 0 || numAnalyserChannels < 2)
+    {
+        analyser.addAudioData(buffer, 0, numAnalyserChannels);
+        return;
+    }
+
+    analyser.addMidSideData(buffer, mode == 2);
+}
+
+template <typename SampleType>
+void EqualizerProcessor::prepareOversamplers(Oversamplers<SampleType>& newOversamplers, const int numChannels,
+                                             const int samplesPerBlock)
+{
+    using Oversampling     = dsp::Oversampling<SampleType>;
+    const auto filterTypes = std::array<typename Oversampling::FilterType, 2> {
+        Oversampling::filterHalfBandPolyphaseIIR,
+        Oversampling::filterHalfBandFIREquiripple,
+    };
+
+    for (size_t type = 0; type < filterTypes.size(); ++type)
+    {
+        for (size_t order = 1; order <= OVERSAMPLING_MAX_ORDER; ++order)
+        {
+            auto& oversampler = newOversamplers[type * OVERSAMPLING_MAX_ORDER + order - 1];
+            oversampler = std::make_unique<Oversampling>(static_cast<size_t>(numChannels), order, filterTypes[type]);
+            oversampler->initProcessing(static_cast<size_t>(samplesPerBlock));
+        }
+    }
+}
+
+template <typename SampleType>
+void EqualizerProcessor::processFilter(AudioBuffer<SampleType>& buffer, FilterEngine<SampleType>& engine,
+                                       Oversamplers<SampleType>& oversampling, AudioBuffer<SampleType>& ramps,
+                                       const AudioBuffer<SampleType>* key, const int keyOffset)
+{
+    // Keyed bands start from silence once the sidechain is connected
+    const auto keyConnected = key != nullptr && key->getNumChannels() > 0
+                              && key->getNumSamples() >= keyOffset + buffer.getNumSamples();
+    if (keyConnected != hasSidechain)
+    {
+        hasSidechain = keyConnected;
+        sidechainDetector.reset();
+    }
+
+    // The sections of the other topology are stale, redesign all of them
+    const auto topologyIndex = roundToInt(topology->load());
+    if (topologyIndex != activeTopology)
+    {
+        activeTopology = topologyIndex;
+        engine.reset();
+        redesignSections();
+    }
+    const auto stateVariable = isStateVariable();
+    updateModulationMode();
+
+    // A new design method changes the coefficients of every section
+    const auto design = roundToInt(designMethod->load());
+    if (design != activeDesign)
+    {
+        activeDesign = design;
+        redesignSections();
+    }
+
+    // Linear phase mode replaces the cascade & the oversampling
+    const auto linearPhase = isLinearPhase();
+    if (linearPhase != wasLinearPhase)
+    {
+        wasLinearPhase = linearPhase;
+        convolver.reset();
+        engine.reset();
+    }
+
+    if (linearPhase)
+    {
+        updateSmoothedSections(buffer.getNumSamples());
+        processLinearPhase(buffer);
+        return;
+    }
+
+    // A new oversampling mode changes the rate the sections are designed for
+    const auto oversamplerIndex = getOversamplerIndex();
+    auto* const oversampler
+        = oversamplerIndex < 0 ? nullptr : oversampling[static_cast<size_t>(oversamplerIndex)].get();
+    if (oversamplerIndex != activeOversampler)
+    {
+        activeOversampler = oversamplerIndex;
+        filterSampleRate  = sampleRate;
+        if (oversampler != nullptr)
+        {
+            oversampler->reset();
+            filterSampleRate *= static_cast<double>(oversampler->getOversamplingFactor());
+        }
+
+        engine.reset();
+        redesignSections();
+    }
 
     if (wasBypassed)
     {
-        filter.reset();
+        engine.reset();
         wasBypassed = false;
     }
 
-    auto ioBuffer = juce::dsp::AudioBlock<float> {buffer};
-    auto context  = juce::dsp::ProcessContextReplacing<float> {ioBuffer};
-    filter.process(context);
+    // Frequency ramps of the state variable sections, one sample per sample
+    // of the rate the sections run at
+    const auto factor = oversampler != nullptr ? static_cast<int>(oversampler->getOversamplingFactor()) : 1;
+    std::array<const SampleType*, maxFilterBands> modulation {};
+    renderFrequencyRamps(ramps, buffer.getNumSamples() * factor, modulation);
+
+    // Coefficients of ramping bands are updated on a fixed control-rate grid
+    auto ioBuffer         = juce::dsp::AudioBlock<SampleType> {buffer};
+    const auto numSamples = static_cast<int>(ioBuffer.getNumSamples());
+    const auto interval   = controlInterval.load();
+    for (int start = 0; start < numSamples; start += interval)
+    {
+        const auto length = jmin(interval, numSamples - start);
+        auto subBlock     = ioBuffer.getSubBlock(static_cast<size_t>(start), static_cast<size_t>(length));
+
+        // Dynamic bands follow the level of the input or the sidechain
+        if (detector.isActive()) { detector.process(subBlock); }
+        if (hasSidechain && sidechainDetector.isActive())
+        {
+            const auto keyBlock = juce::dsp::AudioBlock<const SampleType> {key->getArrayOfReadPointers(),
+                                                                           static_cast<size_t>(key->getNumChannels()),
+                                                                           static_cast<size_t>(keyOffset + start),
+                                                                           static_cast<size_t>(length)};
+            sidechainDetector.process(keyBlock);
+        }
+        updateSmoothedSections(length);
+
+        // Slope sections follow the modulation of the band they belong to
+        std::array<const SampleType*, maxSections> ratios {};
+        for (size_t band = 0; band < maxFilterBands; ++band)
+        {
+            if (modulation[band] == nullptr) { continue; }
+
+            ratios[band]           = modulation[band] + start * factor;
+            const auto& allocation = slopeSections[band];
+            const auto first       = maxFilterBands + allocation.first;
+            for (size_t i = 0; i < allocation.count; ++i) { ratios[first + i] = ratios[band]; }
+        }
+
+        auto block   = oversampler != nullptr ? oversampler->processSamplesUp(subBlock) : subBlock;
+        auto context = juce::dsp::ProcessContextReplacing<SampleType> {block};
+        if (stateVariable) { engine.svfs.process(context, ratios.data()); }
+        else
+        {
+            engine.biquads.process(context);
+        }
+        if (oversampler != nullptr) { oversampler->processSamplesDown(subBlock); }
+    }
+}
+
+void EqualizerProcessor::processLinearPhase(AudioBuffer<float>& buffer)
+{
+    auto block = dsp::AudioBlock<float> {buffer};
+    convolver.process(dsp::ProcessContextReplacing<float> {block});
+}
 
-    outputAnalyser.addAudioData(buffer, 0, getTotalNumOutputChannels());
+void EqualizerProcessor::processLinearPhase(AudioBuffer<double>& buffer)
+{
+    // The convolution runs in float, the kernel is far less precise anyway
+    convolutionBuffer.makeCopyOf(buffer, true);
+    processLinearPhase(convolutionBuffer);
+    buffer.makeCopyOf(convolutionBuffer, true);
 }
 
 void EqualizerProcessor::parameterChanged(const String& parameter, float newValue)
 {
+    // Band parameters have their own listeners, only the global ones end up here
+    ignoreUnused(newValue);
+    if (parameter == tobanteAudio::Parameters::Oversampling
+        || parameter == tobanteAudio::Parameters::OversamplingFilter || parameter == tobanteAudio::Parameters::Phase
+        || parameter == tobanteAudio::Parameters::Design || parameter == tobanteAudio::Parameters::Topology)
+    {
+        // The plots follow the rate the cascade runs at, the kernel is designed
+        // from them. Both are redone on the message thread.
+        updateLatency();
+        changedPlots.store(std::numeric_limits<uint64>::max() >> (64 - bands.size()));
+    }
+}
+
+void EqualizerProcessor::markBandChanged(const size_t index) noexcept
+{
+    const auto bit = uint64 {1} << index;
+    changedSections.fetch_or(bit);
+    changedPlots.fetch_or(bit);
+}
+
+template <typename Model> void EqualizerProcessor::loadBandParameters(const size_t index, Model& model) const noexcept
+{
+    const auto& values = bandParameterValues[index];
+    const auto value   = [&values](const BandParameter parameter) { return values[size_t(parameter)]->load(); };
+
+    model.type         = static_cast<FilterType>(static_cast<int>(value(TypeParameter)));
+    model.slope        = static_cast<FilterSlope>(static_cast<int>(value(SlopeParameter)));
+    model.frequency    = value(FrequencyParameter);
+    model.quality      = value(QualityParameter);
+    model.gain         = value(GainParameter);
+    model.routing      = static_cast<tobanteAudio::ChannelRouting>(static_cast<int>(value(RoutingParameter)));
+    model.dynamic      = value(DynamicParameter) >= 0.5f;
+    model.threshold    = value(ThresholdParameter);
+    model.ratio        = value(RatioParameter);
+    model.attack       = value(AttackParameter);
+    model.release      = value(ReleaseParameter);
+    model.sidechainKey = value(KeyParameter) >= 0.5f;
+}
+
+bool EqualizerProcessor::isBandActive(const size_t index) const noexcept
+{
+    return bandParameterValues[index][size_t(ActiveParameter)]->load() >= 0.5f;
+}
+
+void EqualizerProcessor::applyBandChanges()
+{
+    const auto changed = changedSections.exchange(0);
+    if (changed == 0) { return; }
+
+    // The audio thread never waits, a busy writer defers to the next block
+    const SpinLock::ScopedTryLockType lock(snapshotLock);
+    if (!lock.isLocked())
+    {
+        changedSections.fetch_or(changed);
+        return;
+    }
+
+    const auto solo    = soloed.load();
+    const auto hasSolo = isPositiveAndBelow(solo, static_cast<int>(pendingSnapshot.numActiveSections));
+    for (size_t i = 0; i < bands.size(); ++i)
+    {
+        if ((changed & (uint64 {1} << i)) == 0) { continue; }
+
+        auto& section = pendingSnapshot.sections[i];
+        loadBandParameters(i, section);
+        section.bypassed = hasSolo ? static_cast<int>(i) != solo : !isBandActive(i);
+    }
+
+    publishSnapshot();
+}
+
+void EqualizerProcessor::handleBandChanges()
+{
+    const auto changed = changedPlots.exchange(0);
+    if (changed == 0) { return; }
+
+    for (size_t i = 0; i < bands.size(); ++i)
+    {
+        if ((changed & (uint64 {1} << i)) == 0) { continue; }
+
+        loadBandParameters(i, bands[i]);
+        bands[i].active = isBandActive(i);
+    }
+
+    limitSlopeSections(changed);
     for (size_t i = 0; i < bands.size(); ++i)
     {
-        if (parameter.startsWith(getBandName(int(i)) + "-"))
+        if ((changed & (uint64 {1} << i)) != 0) { updateResponse(i); }
+    }
+
+    {
+        const SpinLock::ScopedLockType lock(snapshotLock);
+        for (size_t i = 0; i < bands.size(); ++i)
         {
-            if (parameter.endsWith(tobanteAudio::Parameters::Type))
-            { bands[i].type = static_cast<FilterType>(static_cast<int>(newValue)); }
-            else if (parameter.endsWith(tobanteAudio::Parameters::Frequency))
-            {
-                bands[i].frequency = newValue;
-            }
-            else if (parameter.endsWith(tobanteAudio::Parameters::Quality))
-            {
-                bands[i].quality = newValue;
-            }
-            else if (parameter.endsWith(tobanteAudio::Parameters::Gain))
-            {
-                bands[i].gain = newValue;
-            }
-            else if (parameter.endsWith(tobanteAudio::Parameters::Active))
-            {
-                bands[i].active = newValue >= 0.5f;
-            }
-
-            updateBand(i);
-            return;
+            if ((changed & (uint64 {1} << i)) != 0) { pendingSnapshot.sections[i].tailSeconds = bands[i].tailSeconds; }
         }
     }
+
+    // Publishes the tails & redraws the summed plot once for all bands
+    updateBypassedStates();
+}
+
+void EqualizerProcessor::timerCallback()
+{
+    handleBandChanges();
+    handleResponseUpdates();
+}
+
+const String& EqualizerProcessor::getBandParameterSuffix(const BandParameter parameter)
+{
+    // Same order as BandParameter
+    static const auto suffixes = std::array<String, LastBandParameterID> {
+        tobanteAudio::Parameters::Type,      tobanteAudio::Parameters::Frequency, tobanteAudio::Parameters::Quality,
+        tobanteAudio::Parameters::Gain,      tobanteAudio::Parameters::Active,    tobanteAudio::Parameters::Slope,
+        tobanteAudio::Parameters::Routing,   tobanteAudio::Parameters::Dynamic,   tobanteAudio::Parameters::Threshold,
+        tobanteAudio::Parameters::Ratio,     tobanteAudio::Parameters::Attack,    tobanteAudio::Parameters::Release,
+        tobanteAudio::Parameters::Key,
+    };
+
+    jassert(isPositiveAndBelow(parameter, LastBandParameterID));
+    return suffixes[static_cast<size_t>(jlimit(0, LastBandParameterID - 1, static_cast<int>(parameter)))];
+}
+
+void EqualizerProcessor::valueTreePropertyChanged(ValueTree& tree, const Identifier& property)
+{
+    if (tree == state.state && property.toString() == tobanteAudio::Parameters::NumBands) { updateNumBands(); }
+}
+
+void EqualizerProcessor::valueTreeRedirected(ValueTree& tree)
+{
+    ignoreUnused(tree);
+    updateNumBands();
 }
 
 String EqualizerProcessor::getFilterTypeName(const EqualizerProcessor::FilterType type)
@@ -192,7 +803,139 @@ String EqualizerProcessor::getFilterTypeName(const EqualizerProcessor::FilterTyp
     }
 }
 
-int EqualizerProcessor::getNumBands() const { return static_cast<int>(bands.size()); }
+String EqualizerProcessor::getFilterSlopeName(const EqualizerProcessor::FilterSlope slope)
+{
+    switch (slope)
+    {
+    case Slope12:
+        return translate("12 dB/oct");
+    case Butterworth24:
+        return translate("24 dB/oct Butterworth");
+    case LinkwitzRiley24:
+        return translate("24 dB/oct Linkwitz-Riley");
+    case Butterworth48:
+        return translate("48 dB/oct Butterworth");
+    case LinkwitzRiley48:
+        return translate("48 dB/oct Linkwitz-Riley");
+    case Butterworth96:
+        return translate("96 dB/oct Butterworth");
+    case LinkwitzRiley96:
+        return translate("96 dB/oct Linkwitz-Riley");
+    default:
+        return translate("unknown");
+    }
+}
+
+String EqualizerProcessor::getChannelRoutingName(const tobanteAudio::ChannelRouting routing)
+{
+    switch (routing)
+    {
+    case tobanteAudio::ChannelRouting::Stereo:
+        return translate("Stereo");
+    case tobanteAudio::ChannelRouting::Left:
+        return translate("Left");
+    case tobanteAudio::ChannelRouting::Right:
+        return translate("Right");
+    case tobanteAudio::ChannelRouting::Mid:
+        return translate("Mid");
+    case tobanteAudio::ChannelRouting::Side:
+        return translate("Side");
+    default:
+        return translate("unknown");
+    }
+}
+
+bool EqualizerProcessor::isChannelLayoutSupported(const AudioChannelSet& layout)
+{
+    return layout == AudioChannelSet::mono() || layout == AudioChannelSet::stereo()
+           || layout == AudioChannelSet::create5point1() || layout == AudioChannelSet::create7point1()
+           || layout == AudioChannelSet::create7point1point4() || isAmbisonic(layout);
+}
+
+bool EqualizerProcessor::isAmbisonic(const AudioChannelSet& layout)
+{
+    for (auto order = 1; order <= 3; ++order)
+    {
+        if (layout == AudioChannelSet::ambisonic(order)) { return true; }
+    }
+
+    return false;
+}
+
+int EqualizerProcessor::getPipelineBlockSize(const int numChannels, const size_t bytesPerSample,
+                                             const int controlInterval)
+{
+    const auto interval      = jmax(1, controlInterval);
+    const auto bytesPerFrame = static_cast<size_t>(jmax(1, numChannels)) * bytesPerSample;
+    const auto numSamples    = static_cast<int>(static_cast<size_t>(PIPELINE_CACHE_BYTES) / bytesPerFrame);
+    return jmax(interval, numSamples / interval * interval);
+}
+
+size_t EqualizerProcessor::getNumSlopeSections(const FilterSlope slope)
+{
+    switch (slope)
+    {
+    case Butterworth24:
+    case LinkwitzRiley24:
+        return 2;
+    case Butterworth48:
+    case LinkwitzRiley48:
+        return 4;
+    case Butterworth96:
+    case LinkwitzRiley96:
+        return 8;
+    case Slope12:
+    default:
+        return 1;
+    }
+}
+
+float EqualizerProcessor::getSlopeQuality(const FilterSlope slope, const size_t numSections, const size_t section)
+{
+    // Butterworth poles of order 2n pair up into n sections, a Linkwitz-Riley
+    // filter is a squared Butterworth of order n
+    const auto isLinkwitzRiley = (slope == LinkwitzRiley24 || slope == LinkwitzRiley48 || slope == LinkwitzRiley96)
+                                 && numSections % 2 == 0;
+    const auto order = isLinkwitzRiley ? numSections : 2 * numSections;
+    const auto pole  = isLinkwitzRiley ? section % (numSections / 2) : section;
+    const auto angle = MathConstants<double>::pi * static_cast<double>(2 * pole + 1) / static_cast<double>(2 * order);
+    return static_cast<float>(0.5 / std::sin(angle));
+}
+
+int EqualizerProcessor::getNumBands() const { return numBands; }
+
+void EqualizerProcessor::setNumBands(const int newNumBands)
+{
+    const auto clamped = jlimit(1, FILTER_MAX_BANDS, newNumBands);
+    state.state.setProperty(tobanteAudio::Parameters::NumBands, clamped, state.undoManager);
+}
+
+void EqualizerProcessor::updateNumBands()
+{
+    const auto property    = state.state.getProperty(tobanteAudio::Parameters::NumBands, FILTER_DEFAULT_NUM_BANDS);
+    const auto newNumBands = jlimit(1, FILTER_MAX_BANDS, static_cast<int>(property));
+
+    // Deactivated bands can't stay soloed or selected, added ones share the
+    // slope sections which are left
+    const auto added = newNumBands > numBands ? ((uint64 {1} << newNumBands) - 1) & ~((uint64 {1} << numBands) - 1) : 0;
+    numBands         = newNumBands;
+    if (soloed.load() >= numBands) { soloed = -1; }
+    for (auto i = static_cast<size_t>(numBands); i < bands.size(); ++i) { bands[i].selected = false; }
+
+    const auto lowered = limitSlopeSections(added);
+    for (size_t i = 0; i < bands.size(); ++i)
+    {
+        if ((lowered & (uint64 {1} << i)) != 0) { updateBand(i); }
+    }
+
+    {
+        const SpinLock::ScopedLockType lock(snapshotLock);
+        pendingSnapshot.numActiveSections = static_cast<size_t>(numBands);
+        publishSnapshot();
+    }
+
+    updateBypassedStates();
+}
 
 String EqualizerProcessor::getBandName(const int index) const
 {
@@ -213,52 +956,63 @@ void EqualizerProcessor::setBandSolo(const int index)
 
 void EqualizerProcessor::updateBypassedStates()
 {
-    if (isPositiveAndBelow(soloed, bands.size()))
-    {
-        filter.setBypassed<0>(soloed != 0);
-        filter.setBypassed<1>(soloed != 1);
-        filter.setBypassed<2>(soloed != 2);
-        filter.setBypassed<3>(soloed != 3);
-        filter.setBypassed<4>(soloed != 4);
-        filter.setBypassed<5>(soloed != 5);
-    }
-    else
     {
-        filter.setBypassed<0>(!bands[0].active);
-        filter.setBypassed<1>(!bands[1].active);
-        filter.setBypassed<2>(!bands[2].active);
-        filter.setBypassed<3>(!bands[3].active);
-        filter.setBypassed<4>(!bands[4].active);
-        filter.setBypassed<5>(!bands[5].active);
+        const SpinLock::ScopedLockType lock(snapshotLock);
+        const auto solo    = soloed.load();
+        const auto hasSolo = isPositiveAndBelow(solo, numBands);
+        for (size_t i = 0; i < bands.size(); ++i)
+        { pendingSnapshot.sections[i].bypassed = hasSolo ? static_cast<int>(i) != solo : !bands[i].active; }
+        publishSnapshot();
     }
     updatePlots();
 }
 
 void EqualizerProcessor::updatePlots()
 {
-    const auto gain = 1.0f;
-    std::fill(magnitudes.begin(), magnitudes.end(), gain);
+    // Plot at the rate the cascade runs at, the sum holds the soloed or all
+    // active bands
+    responseRequest.frequencies     = frequencies;
+    responseRequest.sampleRate      = sampleRate * (isLinearPhase() ? 1 : getOversamplingFactor());
+    responseRequest.bounds          = plotBounds;
+    responseRequest.pixelsPerDouble = plotPixelsPerDouble;
+    responseRequest.curves.resize(bands.size());
 
-    if (isPositiveAndBelow(soloed, bands.size()))
-    {
-        FloatVectorOperations::multiply(magnitudes.data(), bands[static_cast<size_t>(soloed)].magnitudes.data(),
-                                        static_cast<int>(magnitudes.size()));
-    }
-    else
+    const auto solo    = soloed.load();
+    const auto hasSolo = isPositiveAndBelow(solo, numBands);
+    for (size_t i = 0; i < bands.size(); ++i)
     {
-        for (const auto& band : bands)
-        {
-            if (band.active)
-            {
-                FloatVectorOperations::multiply(magnitudes.data(), band.magnitudes.data(),
-                                                static_cast<int>(magnitudes.size()));
-            }
-        }
+        const auto isProcessed           = static_cast<int>(i) < numBands;
+        responseRequest.curves[i]        = bands[i].curve;
+        responseRequest.curves[i].summed = hasSolo ? static_cast<int>(i) == solo : isProcessed && bands[i].active;
     }
 
+    responseWorker.requestUpdate(responseRequest);
+}
+
+void EqualizerProcessor::handleResponseUpdates()
+{
+    if (!responseWorker.getResult(responseCurves)) { return; }
+
+    // Curves for a grid which was resized since are dropped, the request for
+    // the new one is already queued
+    if (responseCurves.summedMagnitudes.size() != frequencies.size()) { return; }
+
+    for (size_t i = 0; i < bands.size() && i < responseCurves.magnitudes.size(); ++i)
+    { std::swap(bands[i].magnitudes, responseCurves.magnitudes[i]); }
+    std::swap(magnitudes, responseCurves.summedMagnitudes);
+
+    // The linear-phase kernel follows the summed response
+    if (sampleRate > 0) { linearPhaseDesigner.requestUpdate(frequencies, magnitudes, sampleRate); }
+
     sendChangeMessage();
 }
 
+void EqualizerProcessor::updateResponsesNow()
+{
+    responseWorker.updateNow();
+    handleResponseUpdates();
+}
+
 void EqualizerProcessor::setSelectedBand(int index)
 {
     // Set all bands to not selected
@@ -331,6 +1085,19 @@ void EqualizerProcessor::setDefaults()
         band.quality   = 0.707f;
         band.type      = tobanteAudio::EqualizerProcessor::LowPass;
     }
+
+    // Additional bands are peaks, spread logarithmically over the spectrum
+    const auto firstExtraBand = static_cast<size_t>(FILTER_DEFAULT_NUM_BANDS);
+    const auto numExtraBands  = static_cast<float>(bands.size() - firstExtraBand);
+    for (auto i = firstExtraBand; i < bands.size(); ++i)
+    {
+        const auto position = (static_cast<float>(i - firstExtraBand) + 0.5f) / numExtraBands;
+
+        auto& band     = bands[i];
+        band.name      = "Band " + String(static_cast<int>(i) + 1);
+        band.frequency = FILTER_FREQ_MIN * std::pow(FILTER_FREQ_MAX / FILTER_FREQ_MIN, position);
+        band.type      = tobanteAudio::EqualizerProcessor::Peak;
+    }
 }
 
 EqualizerProcessor::Band* EqualizerProcessor::getBand(const int index)
@@ -341,121 +1108,555 @@ EqualizerProcessor::Band* EqualizerProcessor::getBand(const int index)
 
 void EqualizerProcessor::updateBand(const size_t index)
 {
-    if (sampleRate > 0)
+    auto& band = bands[index];
+    loadBandParameters(index, band);
+    band.active = isBandActive(index);
+    if (sampleRate <= 0) { return; }
+
+    updateResponse(index);
     {
-        dsp::IIR::Coefficients<float>::Ptr newCoefficients;
-        switch (bands[index].type)
+        const SpinLock::ScopedLockType lock(snapshotLock);
+        auto& section = pendingSnapshot.sections[index];
+        loadBandParameters(index, section);
+        section.tailSeconds = band.tailSeconds;
+        publishSnapshot();
+    }
+}
+
+void EqualizerProcessor::updateResponse(const size_t index)
+{
+    if (sampleRate <= 0) { return; }
+
+    // Plot the response at the rate the cascade runs at
+    const auto designRate = sampleRate * (isLinearPhase() ? 1 : getOversamplingFactor());
+
+    auto& band = bands[index];
+
+    // The response of a steep slope is the product of all its sections,
+    // the tail the sum of their decays. The plot worker evaluates the
+    // sections on the grid.
+    const auto isPass      = band.type == HighPass || band.type == LowPass;
+    const auto numSections = isPass ? getNumSlopeSections(band.slope) : size_t {1};
+    auto& curve            = band.curve;
+    auto decaySamples      = 0.0;
+    jassert(numSections <= curve.sections.size());
+    for (size_t i = 0; i < numSections; ++i)
+    {
+        const auto quality = numSections == 1 ? band.quality : getSlopeQuality(band.slope, numSections, i);
+        curve.sections[i]  = designSection(band.type, designRate, band.frequency, quality, band.gain);
+        decaySamples += FilterDesigner::getDecaySamples(curve.sections[i], -SILENCE_THRESHOLD_DB);
+    }
+    curve.numSections = numSections;
+
+    band.tailSeconds = jmin(decaySamples / designRate, SILENCE_MAX_TAIL_SECONDS);
+}
+
+uint64 EqualizerProcessor::limitSlopeSections(const uint64 changed)
+{
+    // The audio thread hands out the shared slope sections in band order.
+    // Unchanged bands keep theirs, a changed slope which doesn't fit into
+    // what is left is lowered, so the plot & the parameter show what is heard.
+    const auto extraSections = [this](size_t i) {
+        const auto& band = bands[i];
+        return band.type == HighPass || band.type == LowPass ? getNumSlopeSections(band.slope) - 1 : size_t {0};
+    };
+
+    const auto numActive = static_cast<size_t>(numBands);
+    auto numUsed         = size_t {0};
+    for (size_t i = 0; i < numActive; ++i)
+    {
+        if ((changed & (uint64 {1} << i)) == 0) { numUsed += extraSections(i); }
+    }
+
+    auto lowered = uint64 {0};
+    for (size_t i = 0; i < numActive; ++i)
+    {
+        if ((changed & (uint64 {1} << i)) == 0) { continue; }
+
+        auto& band      = bands[i];
+        const auto left = numUsed < maxSlopeSections ? maxSlopeSections - numUsed : 0;
+        if (extraSections(i) > left)
         {
-        case tobanteAudio::EqualizerProcessor::NoFilter:
-            newCoefficients = new dsp::IIR::Coefficients<float>(1, 0, 1, 0);
-            break;
-        case tobanteAudio::EqualizerProcessor::LowPass:
-            newCoefficients
-                = dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, bands[index].frequency, bands[index].quality);
-            break;
-        case tobanteAudio::EqualizerProcessor::LowShelf:
-            newCoefficients = dsp::IIR::Coefficients<float>::makeLowShelf(sampleRate, bands[index].frequency,
-                                                                          bands[index].quality, bands[index].gain);
-            break;
-        case tobanteAudio::EqualizerProcessor::BandPass:
-            newCoefficients
-                = dsp::IIR::Coefficients<float>::makeBandPass(sampleRate, bands[index].frequency, bands[index].quality);
-            break;
-        case tobanteAudio::EqualizerProcessor::Peak:
-            newCoefficients = dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, bands[index].frequency,
-                                                                            bands[index].quality, bands[index].gain);
-            break;
-        case tobanteAudio::EqualizerProcessor::HighShelf:
-            newCoefficients = dsp::IIR::Coefficients<float>::makeHighShelf(sampleRate, bands[index].frequency,
-                                                                           bands[index].quality, bands[index].gain);
-            break;
-        case tobanteAudio::EqualizerProcessor::HighPass:
-            newCoefficients
-                = dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, bands[index].frequency, bands[index].quality);
-            break;
-        default:
-            break;
+            band.slope = getSteepestSlope(band.slope, left + 1);
+            lowered |= uint64 {1} << i;
+            if (auto* parameter = state.getParameter(getSlopeParamID(static_cast<int>(i))))
+            { parameter->setValueNotifyingHost(parameter->convertTo0to1(static_cast<float>(band.slope))); }
         }
+        numUsed += extraSections(i);
+    }
+
+    return lowered;
+}
+
+EqualizerProcessor::FilterSlope EqualizerProcessor::getSteepestSlope(FilterSlope slope, const size_t numSections)
+{
+    // Each step halves the sections & keeps the Butterworth or Linkwitz-Riley
+    // alignment, 24 dB/oct falls back to the single section
+    while (getNumSlopeSections(slope) > numSections)
+    { slope = slope >= Butterworth48 ? static_cast<FilterSlope>(slope - 2) : Slope12; }
+    return slope;
+}
+
+void EqualizerProcessor::publishSnapshot()
+{
+    snapshots.getWriteBuffer() = pendingSnapshot;
+    snapshots.publish();
+}
+
+void EqualizerProcessor::applySnapshot()
+{
+    if (!snapshots.acquire()) { return; }
 
-        if (newCoefficients)
+    const auto& snapshot  = snapshots.getReadBuffer();
+    auto numSlopeSections = size_t {0};
+    auto sequenceLength   = size_t {0};
+    auto tailSeconds      = 0.0;
+    for (size_t i = 0; i < snapshot.numActiveSections; ++i)
+    {
+        const auto& section = snapshot.sections[i];
+        auto& smoother      = smoothers[i];
+
+        // Steep high & low-passes take their extra sections in band order, as
+        // many as are left. Moved sections start from silence.
+        const auto isPass     = section.type == HighPass || section.type == LowPass;
+        const auto numWanted  = isPass ? getNumSlopeSections(section.slope) - 1 : 0;
+        const auto allocation = SlopeSections {numSlopeSections, jmin(numWanted, maxSlopeSections - numSlopeSections)};
+        const auto hasMoved   = allocation.count != slopeSections[i].count
+                              || (allocation.count > 0 && allocation.first != slopeSections[i].first);
+        slopeSections[i] = allocation;
+        numSlopeSections += allocation.count;
+        if (hasMoved)
         {
-            {
-                // minimise lock scope, get<0>() needs to be a  compile time
-                // constant
-                ScopedLock processLock(getCallbackLock());
-                if (index == 0) { *filter.get<0>().state = *newCoefficients; }
-                else if (index == 1)
-                {
-                    *filter.get<1>().state = *newCoefficients;
-                }
-                else if (index == 2)
-                {
-                    *filter.get<2>().state = *newCoefficients;
-                }
-                else if (index == 3)
-                {
-                    *filter.get<3>().state = *newCoefficients;
-                }
-                else if (index == 4)
-                {
-                    *filter.get<4>().state = *newCoefficients;
-                }
-                else if (index == 5)
-                {
-                    *filter.get<5>().state = *newCoefficients;
-                }
-            }
-            newCoefficients->getMagnitudeForFrequencyArray(frequencies.data(), bands[index].magnitudes.data(),
-                                                           frequencies.size(), sampleRate);
+            clearSlopeSections(filter, i);
+            clearSlopeSections(doubleFilter, i);
         }
-        updateBypassedStates();
-        updatePlots();
+
+        // A new filter type or slope can't be ramped & newly added bands have
+        // stale smoothers, jump to the target instead.
+        if (snapSmoothers || hasMoved || i >= numActiveBands || smoother.type != section.type
+            || smoother.slope != section.slope)
+        {
+            smoother.type  = section.type;
+            smoother.slope = section.slope;
+            smoother.frequency.setCurrentAndTargetValue(section.frequency);
+            smoother.quality.setCurrentAndTargetValue(section.quality);
+            smoother.gain.setCurrentAndTargetValue(section.gain);
+            queueModulatedBand(i, section.frequency, section.quality, section.gain);
+        }
+        else
+        {
+            smoother.frequency.setTargetValue(section.frequency);
+            smoother.quality.setTargetValue(section.quality);
+            smoother.gain.setTargetValue(section.gain);
+        }
+
+        // Both detectors share the settings, only the one of the key follows
+        const auto isDynamic = section.dynamic && !section.bypassed;
+        detector.setBand(i, section.frequency, section.quality, section.threshold, section.ratio, section.attack,
+                         section.release);
+        sidechainDetector.setBand(i, section.frequency, section.quality, section.threshold, section.ratio,
+                                  section.attack, section.release);
+        detector.setEnabled(i, isDynamic && !section.sidechainKey);
+        sidechainDetector.setEnabled(i, isDynamic && section.sidechainKey);
+        if (!section.bypassed) { tailSeconds += section.tailSeconds; }
+
+        // The sections of a band run one after the other, before the next band
+        for (size_t j = 0; j <= allocation.count; ++j)
+        {
+            const auto index                  = j == 0 ? i : maxFilterBands + allocation.first + j - 1;
+            sectionSequence[sequenceLength++] = index;
+            filter.biquads.setBypassed(index, section.bypassed);
+            doubleFilter.biquads.setBypassed(index, section.bypassed);
+            filter.svfs.setBypassed(index, section.bypassed);
+            doubleFilter.svfs.setBypassed(index, section.bypassed);
+            filter.biquads.setRouting(index, section.routing);
+            doubleFilter.biquads.setRouting(index, section.routing);
+            filter.svfs.setRouting(index, section.routing);
+            doubleFilter.svfs.setRouting(index, section.routing);
+        }
+    }
+
+    designQueuedSections();
+    tailSamples = roundToInt(jmin(tailSeconds, SILENCE_MAX_TAIL_SECONDS) * sampleRate);
+
+    // Removed bands give up their slope sections
+    for (auto i = snapshot.numActiveSections; i < maxFilterBands; ++i) { slopeSections[i] = SlopeSections {}; }
+
+    numActiveBands = snapshot.numActiveSections;
+    filter.biquads.setSequence(sectionSequence, sequenceLength);
+    doubleFilter.biquads.setSequence(sectionSequence, sequenceLength);
+    filter.svfs.setSequence(sectionSequence, sequenceLength);
+    doubleFilter.svfs.setSequence(sectionSequence, sequenceLength);
+    detector.setNumActiveBands(snapshot.numActiveSections);
+    sidechainDetector.setNumActiveBands(snapshot.numActiveSections);
+    snapSmoothers = false;
+}
+
+template <typename SampleType>
+void EqualizerProcessor::clearSlopeSections(FilterEngine<SampleType>& engine, const size_t band)
+{
+    const auto& allocation = slopeSections[band];
+    for (auto section = allocation.first; section < allocation.first + allocation.count; ++section)
+    {
+        engine.biquads.resetSection(maxFilterBands + section);
+        engine.svfs.resetSection(maxFilterBands + section);
     }
 }
 
+void EqualizerProcessor::updateSmoothedSections(const int numSamples)
+{
+    for (size_t i = 0; i < numActiveBands; ++i)
+    {
+        auto& smoother         = smoothers[i];
+        const auto keyGain     = hasSidechain ? sidechainDetector.getGain(i) : 1.0f;
+        const auto dynamicGain = detector.getGain(i) * keyGain;
+        if (!smoother.isSmoothing() && dynamicGain == smoother.dynamicGain && !smoother.modulationChanged)
+        { continue; }
+
+        smoother.dynamicGain = dynamicGain;
+        const auto frequency = smoother.frequency.skip(numSamples);
+        const auto quality   = smoother.quality.skip(numSamples);
+        const auto gain      = smoother.gain.skip(numSamples);
+        queueModulatedBand(i, frequency, quality, gain);
+    }
+
+    designQueuedSections();
+}
+
+template <typename Designer>
+typename Designer::Coefficients EqualizerProcessor::designWith(const FilterType type, const double rate,
+                                                               const float frequency, const float quality,
+                                                               const float gain)
+{
+    switch (type)
+    {
+    case tobanteAudio::EqualizerProcessor::LowPass:
+        return Designer::makeLowPass(rate, frequency, quality);
+    case tobanteAudio::EqualizerProcessor::LowShelf:
+        return Designer::makeLowShelf(rate, frequency, quality, gain);
+    case tobanteAudio::EqualizerProcessor::BandPass:
+        return Designer::makeBandPass(rate, frequency, quality);
+    case tobanteAudio::EqualizerProcessor::Peak:
+        return Designer::makePeakFilter(rate, frequency, quality, gain);
+    case tobanteAudio::EqualizerProcessor::HighShelf:
+        return Designer::makeHighShelf(rate, frequency, quality, gain);
+    case tobanteAudio::EqualizerProcessor::HighPass:
+        return Designer::makeHighPass(rate, frequency, quality);
+    case tobanteAudio::EqualizerProcessor::NoFilter:
+    default:
+        return Designer::makeIdentity();
+    }
+}
+
+void EqualizerProcessor::setBandCoefficients(const size_t band, const FilterType type, const FilterSlope slope,
+                                             const float frequency, const float quality, const float gain)
+{
+    if (isUsingDoublePrecision()) { setBandCoefficients(doubleFilter, band, type, slope, frequency, quality, gain); }
+    else
+    {
+        setBandCoefficients(filter, band, type, slope, frequency, quality, gain);
+    }
+}
+
+template <typename SampleType>
+void EqualizerProcessor::setBandCoefficients(FilterEngine<SampleType>& engine, const size_t band, const FilterType type,
+                                             const FilterSlope slope, const float frequency, const float quality,
+                                             const float gain)
+{
+    // The first section is the one of the band, the rest are slope sections
+    const auto& allocation = slopeSections[band];
+    const auto numSections = allocation.count + 1;
+    for (size_t i = 0; i < numSections; ++i)
+    {
+        const auto sectionQuality = numSections == 1 ? quality : getSlopeQuality(slope, numSections, i);
+        const auto section        = i == 0 ? band : maxFilterBands + allocation.first + i - 1;
+
+        if (activeTopology == 1)
+        {
+            engine.svfs.setCoefficients(
+                section, designWith<SvfFilterDesigner>(type, filterSampleRate, frequency, sectionQuality, gain));
+            continue;
+        }
+
+        engine.biquads.setCoefficients(section, makeCoefficients(type, frequency, sectionQuality, gain));
+    }
+}
+
+void EqualizerProcessor::redesignSections()
+{
+    for (size_t i = 0; i < numActiveBands; ++i)
+    {
+        const auto& smoother = smoothers[i];
+        const auto frequency = smoother.frequency.getCurrentValue();
+        const auto quality   = smoother.quality.getCurrentValue();
+        const auto gain      = smoother.gain.getCurrentValue();
+        queueModulatedBand(i, frequency, quality, gain);
+    }
+
+    designQueuedSections();
+}
+
+void EqualizerProcessor::queueModulatedBand(const size_t band, const float frequency, const float quality,
+                                            const float gain)
+{
+    auto& smoother             = smoothers[band];
+    smoother.modulationChanged = false;
+
+    // Modulated values stay within the parameter ranges, the state variable
+    // sections take the frequency ratio per sample instead. The dynamic gain
+    // applies on top, like for unmodulated bands.
+    const auto frequencyRatio     = audioRateModulation ? 1.0f : smoother.frequencyRatio;
+    const auto modulatedFrequency = jlimit(FILTER_FREQ_MIN, FILTER_FREQ_MAX, frequency * frequencyRatio);
+    const auto modulatedQuality   = jlimit(FILTER_Q_MIN, FILTER_Q_MAX, quality * smoother.qualityRatio);
+    const auto modulatedGain      = jlimit(1.0f / MAX_GAIN, MAX_GAIN, gain * smoother.gainRatio) * smoother.dynamicGain;
+    queueBandCoefficients(band, smoother.type, smoother.slope, modulatedFrequency, modulatedQuality, modulatedGain);
+}
+
+void EqualizerProcessor::queueBandCoefficients(const size_t band, const FilterType type, const FilterSlope slope,
+                                               const float frequency, const float quality, const float gain)
+{
+    // Matched & state variable sections have designers of their own. The
+    // topology is the one the audio thread runs, not the parameter
+    if (activeTopology == 1 || isMatchedDesign())
+    {
+        setBandCoefficients(band, type, slope, frequency, quality, gain);
+        return;
+    }
+
+    const auto& allocation = slopeSections[band];
+    const auto numSections = allocation.count + 1;
+    for (size_t i = 0; i < numSections; ++i)
+    {
+        const auto sectionQuality = numSections == 1 ? quality : getSlopeQuality(slope, numSections, i);
+        const auto index          = batchDesigner.add(getBiquadShape(type), frequency, sectionQuality, gain);
+        batchTargets[index]       = i == 0 ? band : maxFilterBands + allocation.first + i - 1;
+    }
+}
+
+void EqualizerProcessor::designQueuedSections()
+{
+    if (batchDesigner.size() == 0) { return; }
+
+    batchDesigner.design(filterSampleRate);
+    if (isUsingDoublePrecision()) { setQueuedCoefficients(doubleFilter); }
+    else
+    {
+        setQueuedCoefficients(filter);
+    }
+    batchDesigner.clear();
+}
+
+template <typename SampleType> void EqualizerProcessor::setQueuedCoefficients(FilterEngine<SampleType>& engine)
+{
+    for (size_t i = 0; i < batchDesigner.size(); ++i)
+    {
+        engine.biquads.setCoefficients(batchTargets[i], batchDesigner.getCoefficients(i));
+    }
+}
+
+BiquadShape EqualizerProcessor::getBiquadShape(const FilterType type) noexcept
+{
+    switch (type)
+    {
+    case LowPass:
+        return BiquadShape::LowPass;
+    case HighPass:
+        return BiquadShape::HighPass;
+    case BandPass:
+        return BiquadShape::BandPass;
+    case LowShelf:
+        return BiquadShape::LowShelf;
+    case HighShelf:
+        return BiquadShape::HighShelf;
+    case Peak:
+        return BiquadShape::Peak;
+    case NoFilter:
+    default:
+        return BiquadShape::Identity;
+    }
+}
+
+int EqualizerProcessor::getOversamplerIndex() const
+{
+    const auto order = roundToInt(oversamplingOrder->load());
+    if (order <= 0) { return -1; }
+
+    const auto filterType = roundToInt(oversamplingFilter->load());
+    return filterType * OVERSAMPLING_MAX_ORDER + order - 1;
+}
+
+int EqualizerProcessor::getOversamplingFactor() const { return 1 << roundToInt(oversamplingOrder->load()); }
+
+void EqualizerProcessor::updateLatency()
+{
+    if (isLinearPhase())
+    {
+        setLatencySamples(convolver.getLatencySamples() + linearPhaseDesigner.getKernelDelay());
+        return;
+    }
+
+    const auto index = getOversamplerIndex();
+    if (index < 0)
+    {
+        setLatencySamples(0);
+        return;
+    }
+
+    const auto& oversampler       = oversamplers[static_cast<size_t>(index)];
+    const auto& doubleOversampler = doubleOversamplers[static_cast<size_t>(index)];
+
+    auto latency = 0.0f;
+    if (oversampler != nullptr) { latency = oversampler->getLatencyInSamples(); }
+    if (doubleOversampler != nullptr) { latency = static_cast<float>(doubleOversampler->getLatencyInSamples()); }
+    setLatencySamples(roundToInt(latency));
+}
+
+EqualizerProcessor::FilterDesigner::Coefficients EqualizerProcessor::makeCoefficients(const FilterType type,
+                                                                                      const float frequency,
+                                                                                      const float quality,
+                                                                                      const float gain) const
+{
+    // Only the biquad sections of the audio thread get here, the parameter
+    // may already name the other topology
+    if (isMatchedDesign())
+    { return designWith<MatchedFilterDesigner>(type, filterSampleRate, frequency, quality, gain); }
+    return designWith<FilterDesigner>(type, filterSampleRate, frequency, quality, gain);
+}
+
+bool EqualizerProcessor::isMatchedDesign() const { return roundToInt(designMethod->load()) == 1; }
+
+EqualizerProcessor::FilterDesigner::Coefficients
+EqualizerProcessor::designSection(const FilterType type, const double rate, const float frequency,
+                                  const float quality, const float gain) const
+{
+    // State variable filters have the bilinear response
+    if (isMatchedDesign() && !isStateVariable())
+    { return designWith<MatchedFilterDesigner>(type, rate, frequency, quality, gain); }
+    return designWith<FilterDesigner>(type, rate, frequency, quality, gain);
+}
+
+void EqualizerProcessor::setControlInterval(const int numSamples) { controlInterval.store(jmax(1, numSamples)); }
+
+int EqualizerProcessor::getControlInterval() const { return controlInterval.load(); }
+
+String EqualizerProcessor::getBandParamID(const int index, const BandParameter parameter) const
+{
+    if (isPositiveAndBelow(index, bandParamIDs.size()) && isPositiveAndBelow(parameter, LastBandParameterID))
+    { return bandParamIDs[size_t(index)][size_t(parameter)]; }
+    return getBandName(index) + "-" + getBandParameterSuffix(parameter);
+}
+
 String EqualizerProcessor::getTypeParamID(const int index) const
 {
-    return getBandName(index) + "-" + tobanteAudio::Parameters::Type;
+    return getBandParamID(index, TypeParameter);
 }
 
 String EqualizerProcessor::getFrequencyParamID(const int index) const
 {
-    return getBandName(index) + "-" + tobanteAudio::Parameters::Frequency;
+    return getBandParamID(index, FrequencyParameter);
 }
 
 String EqualizerProcessor::getQualityParamID(const int index) const
 {
-    return getBandName(index) + "-" + tobanteAudio::Parameters::Quality;
+    return getBandParamID(index, QualityParameter);
 }
 
 String EqualizerProcessor::getGainParamID(const int index) const
 {
-    return getBandName(index) + "-" + tobanteAudio::Parameters::Gain;
+    return getBandParamID(index, GainParameter);
 }
 
 String EqualizerProcessor::getActiveParamID(const int index) const
 {
-    return getBandName(index) + "-" + tobanteAudio::Parameters::Active;
+    return getBandParamID(index, ActiveParameter);
 }
 
-const std::vector<double>& EqualizerProcessor::getMagnitudes() { return magnitudes; }
+String EqualizerProcessor::getSlopeParamID(const int index) const
+{
+    return getBandParamID(index, SlopeParameter);
+}
 
-void EqualizerProcessor::createFrequencyPlot(Path& p, const std::vector<double>& mags, const Rectangle<int> bounds,
-                                             float pixelsPerDouble)
+String EqualizerProcessor::getDynamicParamID(const int index) const
 {
-    p.startNewSubPath(
-        static_cast<float>(bounds.getX()),
-        static_cast<float>(roundToInt(bounds.getCentreY() - pixelsPerDouble * std::log(mags[0]) / std::log(2))));
-    const double xFactor = static_cast<double>(bounds.getWidth()) / frequencies.size();
-    for (size_t i = 1; i < frequencies.size(); ++i)
-    {
-        const auto x = roundToInt(bounds.getX() + i * xFactor);
-        const auto y = roundToInt(bounds.getCentreY() - pixelsPerDouble * std::log(mags[i]) / std::log(2));
+    return getBandParamID(index, DynamicParameter);
+}
 
-        p.lineTo(static_cast<float>(x), static_cast<float>(y));
-    }
+String EqualizerProcessor::getThresholdParamID(const int index) const
+{
+    return getBandParamID(index, ThresholdParameter);
 }
 
+String EqualizerProcessor::getRatioParamID(const int index) const
+{
+    return getBandParamID(index, RatioParameter);
+}
+
+String EqualizerProcessor::getAttackParamID(const int index) const
+{
+    return getBandParamID(index, AttackParameter);
+}
+
+String EqualizerProcessor::getReleaseParamID(const int index) const
+{
+    return getBandParamID(index, ReleaseParameter);
+}
+
+String EqualizerProcessor::getKeyParamID(const int index) const
+{
+    return getBandParamID(index, KeyParameter);
+}
+
+String EqualizerProcessor::getRoutingParamID(const int index) const
+{
+    return getBandParamID(index, RoutingParameter);
+}
+
+void EqualizerProcessor::setResponseWidth(const int widthInPixels)
+{
+    const auto numPoints = jlimit(RESPONSE_MIN_POINTS, RESPONSE_MAX_POINTS, widthInPixels / RESPONSE_PIXELS_PER_POINT);
+    if (static_cast<size_t>(numPoints) == frequencies.size()) { return; }
+
+    resizeResponseGrid(numPoints);
+    updatePlots();
+}
+
+void EqualizerProcessor::setPlotBounds(const Rectangle<int> bounds, const float pixelsPerDouble)
+{
+    plotBounds          = bounds;
+    plotPixelsPerDouble = pixelsPerDouble;
+
+    // Only a new grid size requests new plots by itself
+    const auto numPoints = frequencies.size();
+    setResponseWidth(bounds.getWidth());
+    if (frequencies.size() == numPoints) { updatePlots(); }
+}
+
+void EqualizerProcessor::resizeResponseGrid(const int numPoints)
+{
+    // Log spaced over the ten octaves from 20 Hz the plot shows, the first &
+    // last point are on the edges
+    jassert(numPoints > 1);
+    frequencies.resize(static_cast<size_t>(numPoints));
+    for (size_t i = 0; i < frequencies.size(); ++i)
+    { frequencies[i] = 20.0 * std::pow(2.0, 10.0 * static_cast<double>(i) / (numPoints - 1)); }
+
+    magnitudes.assign(frequencies.size(), 1.0);
+    for (auto& band : bands) { band.magnitudes.assign(frequencies.size(), 1.0); }
+}
+
+const std::vector<double>& EqualizerProcessor::getFrequencies() const noexcept { return frequencies; }
+
+const std::vector<double>& EqualizerProcessor::getMagnitudes() { return magnitudes; }
+
+const Path& EqualizerProcessor::getBandPlot(const int index) const noexcept
+{
+    static const Path empty;
+    if (!isPositiveAndBelow(index, static_cast<int>(responseCurves.paths.size()))) { return empty; }
+    return responseCurves.paths[static_cast<size_t>(index)];
+}
+
+const Path& EqualizerProcessor::getResponsePlot() const noexcept { return responseCurves.summedPath; }
+
 void EqualizerProcessor::createAnalyserPlot(Path& p, const Rectangle<int> bounds, float minFreq, bool input)
 {
     if (input) { inputAnalyser.createPath(p, bounds.toFloat(), minFreq); }
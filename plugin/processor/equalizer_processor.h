@@ -17,14 +17,31 @@
 #pragma once
 #include "../analyser/spectrum_analyser.h"
 #include "../parameters/text_value_converter.h"
+#include "../settings/constants.h"
+#include "band_detector.h"
 #include "base_processor.h"
+#include "biquad_batch_designer.h"
+#include "biquad_cascade.h"
+#include "biquad_designer.h"
+#include "channel_routing.h"
+#include "linear_phase_designer.h"
+#include "matched_designer.h"
+#include "partitioned_convolver.h"
+#include "response_curve_worker.h"
+#include "svf_cascade.h"
+#include "svf_designer.h"
+#include "triple_buffer.h"
 namespace tobanteAudio
 {
 /**
- * @brief Main processor class for modEQ. Holds 6 JUCE dsp filters in a
- * ProcessorChain.
+ * @brief Main processor class for modEQ. Holds up to FILTER_MAX_BANDS filter
+ * bands in a BiquadCascade. The number of active bands is stored in the state.
  */
-class EqualizerProcessor : public BaseProcessor, public ChangeBroadcaster, AudioProcessorValueTreeState::Listener
+class EqualizerProcessor : public BaseProcessor,
+                           public ChangeBroadcaster,
+                           AudioProcessorValueTreeState::Listener,
+                           ValueTree::Listener,
+                           Timer
 
 {
 public:
@@ -43,6 +60,43 @@ public:
         LastFilterID
     };
 
+    /**
+     * @brief Slopes of the high & low-pass types. Steeper slopes cascade
+     * further sections with fixed Butterworth or Linkwitz-Riley qualities.
+     */
+    enum FilterSlope
+    {
+        Slope12 = 0,
+        Butterworth24,
+        LinkwitzRiley24,
+        Butterworth48,
+        LinkwitzRiley48,
+        Butterworth96,
+        LinkwitzRiley96,
+        LastSlopeID
+    };
+
+    /**
+     * @brief Parameters every band has, indexes the table of parameter IDs.
+     */
+    enum BandParameter
+    {
+        TypeParameter = 0,
+        FrequencyParameter,
+        QualityParameter,
+        GainParameter,
+        ActiveParameter,
+        SlopeParameter,
+        RoutingParameter,
+        DynamicParameter,
+        ThresholdParameter,
+        RatioParameter,
+        AttackParameter,
+        ReleaseParameter,
+        KeyParameter,
+        LastBandParameterID
+    };
+
     /**
      * @brief Model of a filter band.
      */
@@ -50,13 +104,23 @@ public:
     {
         String name;
         Colour colour;
-        FilterType type = BandPass;
-        float frequency = 1000.0f;
-        float quality   = 1.0f;
-        float gain      = 1.0f;
-        bool active     = true;
-        bool selected   = false;
+        FilterType type        = BandPass;
+        FilterSlope slope      = Slope12;
+        float frequency        = 1000.0f;
+        float quality          = 1.0f;
+        float gain             = 1.0f;
+        bool active            = true;
+        bool selected          = false;
+        bool dynamic           = false;
+        float threshold        = -24.0f;
+        float ratio            = 2.0f;
+        float attack           = 10.0f;
+        float release          = 100.0f;
+        bool sidechainKey      = false;
+        ChannelRouting routing = ChannelRouting::Stereo;
+        double tailSeconds     = 0.0;
         std::vector<double> magnitudes;
+        tobanteAudio::ResponseCurveWorker::Curve curve;
     };
 
     /**
@@ -80,15 +144,151 @@ public:
     void processBlock(AudioBuffer<float>& buffer, MidiBuffer& midi) override;
 
     /**
-     * @brief Updates the dsp model if a parameter was changed.
+     * @brief Process audio & midi buffers with double precision coefficients &
+     * filter state.
+     */
+    void processBlock(AudioBuffer<double>& buffer, MidiBuffer& midi) override;
+
+    /**
+     * @brief Processes a sub-block of the current block. The buffer refers to
+     * the samples starting at startSample, the modulation & the sidechain are
+     * read from the same offset. Lets the plugin run every stage on data which
+     * is still in cache.
+     */
+    void processSubBlock(AudioBuffer<float>& buffer, int startSample);
+
+    /**
+     * @brief Processes a double precision sub-block of the current block.
+     */
+    void processSubBlock(AudioBuffer<double>& buffer, int startSample);
+
+    /**
+     * @brief The filters can run in double precision, e.g. for offline renders.
+     */
+    bool supportsDoublePrecisionProcessing() const override { return true; }
+
+    /**
+     * @brief Returns the delay of the oversampling filters plus the decay of
+     * the active bands or the ringing of the linear-phase kernel in seconds.
+     */
+    double getTailLengthSeconds() const override;
+
+    /**
+     * @brief Returns true if the bands are applied as a linear-phase FIR.
+     */
+    bool isLinearPhase() const;
+
+    /**
+     * @brief Returns true if the sections are designed to match the analog
+     * magnitude up to Nyquist, instead of with the bilinear transform.
+     */
+    bool isMatchedDesign() const;
+
+    /**
+     * @brief Returns true if the bands run as state variable filters, which
+     * stay stable under audio-rate modulation.
+     */
+    bool isStateVariable() const;
+
+    /**
+     * @brief Scales the frequency, quality & gain of a band on top of its
+     * parameters. The band is redesigned at the next control interval, the
+     * results are limited to the parameter ranges. With the state variable
+     * topology the frequency instead glides to the new ratio sample by sample
+     * over the next sub-block, oversampled or not. Call from the audio thread.
+     */
+    void setBandModulation(int band, float frequencyRatio, float qualityRatio, float gainRatio) noexcept;
+
+    /**
+     * @brief Sets the sidechain which keys the dynamic bands for the next
+     * processBlock call or the sub-blocks of the current block. Needs the same
+     * number of samples as the main buffer.
+     * Call from the audio thread, nullptr disconnects it.
+     */
+    void setSidechain(const AudioBuffer<float>* buffer) noexcept;
+
+    /**
+     * @brief Sets the double precision sidechain for the next processBlock
+     * call.
+     */
+    void setSidechain(const AudioBuffer<double>* buffer) noexcept;
+
+    /**
+     * @brief Returns true if the last block was skipped, because the input is
+     * silent & the tails of all bands have decayed.
+     */
+    bool isIdle() const noexcept { return idle; }
+
+    /**
+     * @brief Updates the latency & marks all plots for a redraw if a global
+     * parameter was changed. Band parameters have their own listeners.
      */
     void parameterChanged(const String& parameter, float newValue) override;
 
+    /**
+     * @brief Reads the bands changed since the last call into the model &
+     * recomputes their responses, tails & the summed plot. Runs from a timer
+     * on the message thread, call it directly to apply the changes right away.
+     */
+    void handleBandChanges();
+
+    /**
+     * @brief Picks up a new band count from the state.
+     */
+    void valueTreePropertyChanged(ValueTree& tree, const Identifier& property) override;
+
+    /**
+     * @brief Picks up the band count after the state was replaced.
+     */
+    void valueTreeRedirected(ValueTree& tree) override;
+
     /**
      * @brief Converts filter type enum class to string value.
      */
     static String getFilterTypeName(tobanteAudio::EqualizerProcessor::FilterType type);
 
+    /**
+     * @brief Converts filter slope enum to string value.
+     */
+    static String getFilterSlopeName(tobanteAudio::EqualizerProcessor::FilterSlope slope);
+
+    /**
+     * @brief Returns the number of second order sections a high or low-pass
+     * with the given slope is made of.
+     */
+    static size_t getNumSlopeSections(FilterSlope slope);
+
+    /**
+     * @brief Returns the quality of one section of a high or low-pass made of
+     * numSections sections. Linkwitz-Riley slopes need an even number of
+     * sections & fall back to Butterworth otherwise.
+     */
+    static float getSlopeQuality(FilterSlope slope, size_t numSections, size_t section);
+
+    /**
+     * @brief Converts channel routing enum to string value.
+     */
+    static String getChannelRoutingName(ChannelRouting routing);
+
+    /**
+     * @brief Returns true for the channel layouts the equalizer supports:
+     * mono, stereo, 5.1, 7.1, 7.1.4 & ambisonic beds up to 3rd order.
+     */
+    static bool isChannelLayoutSupported(const AudioChannelSet& layout);
+
+    /**
+     * @brief Returns true if the layout is an ambisonic bed.
+     */
+    static bool isAmbisonic(const AudioChannelSet& layout);
+
+    /**
+     * @brief Returns the number of samples per sub-block for which all
+     * channels fit into PIPELINE_CACHE_BYTES. Always a multiple of the
+     * control interval, so the control-rate grid stays the same.
+     */
+    static int getPipelineBlockSize(int numChannels, size_t bytesPerSample,
+                                    int controlInterval = FILTER_CONTROL_INTERVAL);
+
     /**
      * @brief Returns the processor name.
      */
@@ -100,7 +300,8 @@ public:
     Band* getBand(int index);
 
     /**
-     * @brief Updates the filter coefficients for a band by index.
+     * @brief Reads the parameters of a band by index, recomputes its response
+     * & hands it to the audio thread right away. Message thread only.
      */
     void updateBand(size_t index);
 
@@ -110,19 +311,56 @@ public:
     void updateBypassedStates();
 
     /**
-     * @brief Updates the bands frequency response plots.
+     * @brief Requests new frequency response plots from the background
+     * worker.
      */
     void updatePlots();
 
+    /**
+     * @brief Swaps in the plots the worker finished since the last call,
+     * updates the linear-phase kernel & notifies the views. Runs from a timer
+     * on the message thread.
+     */
+    void handleResponseUpdates();
+
+    /**
+     * @brief Computes the requested plots on the calling thread & swaps them
+     * in. Message thread only.
+     */
+    void updateResponsesNow();
+
+    /**
+     * @brief Sets the area the response paths are drawn in & resizes the grid
+     * to its width. Message thread only.
+     */
+    void setPlotBounds(Rectangle<int> bounds, float pixelsPerDouble);
+
+    /**
+     * @brief Resizes the response grid to a plot of the given width, one
+     * point every RESPONSE_PIXELS_PER_POINT pixels, & recomputes the band
+     * responses. Message thread only.
+     */
+    void setResponseWidth(int widthInPixels);
+
+    /**
+     * @brief Returns the frequencies of the response grid.
+     */
+    const std::vector<double>& getFrequencies() const noexcept;
+
     /**
      * @brief Returns refrence to the magnitudes vector.
      */
     const std::vector<double>& getMagnitudes();
 
     /**
-     * @brief Daws the frequency response plot to a given path & area.
+     * @brief Returns the response path of a band, empty for unknown bands.
      */
-    void createFrequencyPlot(Path& p, const std::vector<double>& mags, Rectangle<int> bounds, float pixelsPerDouble);
+    const Path& getBandPlot(int index) const noexcept;
+
+    /**
+     * @brief Returns the path of the summed response.
+     */
+    const Path& getResponsePlot() const noexcept;
 
     /**
      * @brief Draws the analyser plot to a given path & area.
@@ -134,6 +372,12 @@ public:
      */
     bool checkForNewAnalyserData();
 
+    /**
+     * @brief Returns the ValueTree parameter string of a band parameter. The
+     * strings are built once in the constructor.
+     */
+    String getBandParamID(int index, BandParameter parameter) const;
+
     /**
      * @brief Returns the filter type ValueTree parameter string for a band by
      * index.
@@ -164,10 +408,61 @@ public:
     String getActiveParamID(int index) const;
 
     /**
-     * @brief Returns the number of bands in the processor chain.
+     * @brief Returns the slope ValueTree parameter string for a band by index.
+     */
+    String getSlopeParamID(int index) const;
+
+    /**
+     * @brief Returns the dynamic on/off ValueTree parameter string for a band
+     * by index.
+     */
+    String getDynamicParamID(int index) const;
+
+    /**
+     * @brief Returns the threshold ValueTree parameter string for a band by
+     * index.
+     */
+    String getThresholdParamID(int index) const;
+
+    /**
+     * @brief Returns the ratio ValueTree parameter string for a band by index.
+     */
+    String getRatioParamID(int index) const;
+
+    /**
+     * @brief Returns the attack ValueTree parameter string for a band by index.
+     */
+    String getAttackParamID(int index) const;
+
+    /**
+     * @brief Returns the release ValueTree parameter string for a band by
+     * index.
+     */
+    String getReleaseParamID(int index) const;
+
+    /**
+     * @brief Returns the detector key (input or sidechain) ValueTree
+     * parameter string for a band by index.
+     */
+    String getKeyParamID(int index) const;
+
+    /**
+     * @brief Returns the channel routing ValueTree parameter string for a band
+     * by index.
+     */
+    String getRoutingParamID(int index) const;
+
+    /**
+     * @brief Returns the number of active bands in the processor chain.
      */
     int getNumBands() const;
 
+    /**
+     * @brief Sets the number of active bands. Stored in the state, clamped to
+     * 1 - FILTER_MAX_BANDS.
+     */
+    void setNumBands(int newNumBands);
+
     /**
      * @brief Returns the bands name by index. Returns "unknown" if out of
      * bounds.
@@ -201,22 +496,215 @@ public:
      */
     int getSelectedBand();
 
+    /**
+     * @brief Sets the number of samples between two coefficient updates while
+     * band parameters are ramping.
+     */
+    void setControlInterval(int numSamples);
+
+    /**
+     * @brief Returns the number of samples between two coefficient updates.
+     */
+    int getControlInterval() const;
+
 private:
-    int soloed       = -1;
+    std::atomic<int> soloed {-1};
+    int numBands     = FILTER_DEFAULT_NUM_BANDS;
     bool wasBypassed = true;
 
-    using FloatFilter       = dsp::IIR::Filter<float>;
-    using FloatCoefficients = dsp::IIR::Coefficients<float>;
-    using FBand             = dsp::ProcessorDuplicator<FloatFilter, FloatCoefficients>;
+    static constexpr size_t maxFilterBands = FILTER_MAX_BANDS;
+
+    static constexpr size_t maxSlopeSections = FILTER_MAX_SLOPE_SECTIONS;
+
+    // Band sections come first, slope sections follow at maxFilterBands
+    static constexpr size_t maxSections = maxFilterBands + maxSlopeSections;
+
+    using FilterDesigner        = tobanteAudio::BiquadDesigner<double>;
+    using MatchedFilterDesigner = tobanteAudio::MatchedDesigner<double>;
+    using SvfFilterDesigner     = tobanteAudio::SvfDesigner<double>;
+    using FilterSmoother        = SmoothedValue<float, ValueSmoothingTypes::Multiplicative>;
+
+    /**
+     * @brief Cascades of one precision. Section i belongs to band i, the extra
+     * sections of steep high & low-passes are packed in band order from
+     * maxFilterBands on. The sequence runs the extra sections of a band right
+     * after its first one.
+     */
+    template <typename SampleType> struct FilterEngine
+    {
+        tobanteAudio::BiquadCascade<SampleType, maxSections> biquads;
+        tobanteAudio::SvfCascade<SampleType, maxSections> svfs;
+
+        void prepare(const dsp::ProcessSpec& spec)
+        {
+            biquads.prepare(spec);
+            svfs.prepare(spec);
+        }
+
+        void reset() noexcept
+        {
+            biquads.reset();
+            svfs.reset();
+        }
+    };
+
+    /**
+     * @brief Range of slope sections owned by a band.
+     */
+    struct SlopeSections
+    {
+        size_t first = 0;
+        size_t count = 0;
+    };
+
+    // One oversampler per order & half-band filter type, all allocated in
+    // prepareToPlay, so switching never allocates on the audio thread.
+    static constexpr size_t numOversamplers = 2 * OVERSAMPLING_MAX_ORDER;
+
+    template <typename SampleType>
+    using Oversamplers = std::array<std::unique_ptr<dsp::Oversampling<SampleType>>, numOversamplers>;
+
+    /**
+     * @brief Band parameters & bypass states handed from the thread which
+     * changes a band to the audio thread.
+     */
+    struct FilterSnapshot
+    {
+        struct Section
+        {
+            FilterType type        = NoFilter;
+            FilterSlope slope      = Slope12;
+            float frequency        = 1000.0f;
+            float quality          = 1.0f;
+            float gain             = 1.0f;
+            bool bypassed          = false;
+            bool dynamic           = false;
+            float threshold        = -24.0f;
+            float ratio            = 2.0f;
+            float attack           = 10.0f;
+            float release          = 100.0f;
+            bool sidechainKey      = false;
+            ChannelRouting routing = ChannelRouting::Stereo;
+            double tailSeconds     = 0.0;
+        };
+
+        std::array<Section, maxFilterBands> sections {};
+        size_t numActiveSections = FILTER_DEFAULT_NUM_BANDS;
+    };
 
-    dsp::ProcessorChain<FBand, FBand, FBand, FBand, FBand, FBand> filter;
+    /**
+     * @brief Ramps the parameters of a band on the audio thread.
+     */
+    struct SectionSmoother
+    {
+        FilterType type   = NoFilter;
+        FilterSlope slope = Slope12;
+        FilterSmoother frequency {1000.0f};
+        FilterSmoother quality {1.0f};
+        FilterSmoother gain {1.0f};
+        float dynamicGain = 1.0f;
+
+        // Ratios of the modulation matrix, applied on top of the ramps
+        float frequencyRatio   = 1.0f;
+        float qualityRatio     = 1.0f;
+        float gainRatio        = 1.0f;
+        bool modulationChanged = false;
+
+        // Frequency ratio the per-sample ramp of the state variable sections
+        // has reached
+        float appliedFrequencyRatio = 1.0f;
+
+        bool isSmoothing() const noexcept
+        {
+            return frequency.isSmoothing() || quality.isSmoothing() || gain.isSmoothing();
+        }
+    };
+
+    // Only the cascades matching the processing precision & topology get
+    // coefficients
+    FilterEngine<float> filter;
+    FilterEngine<double> doubleFilter;
+
+    // Bilinear biquad sections are queued & designed together, the targets
+    // are sections of the cascades
+    tobanteAudio::BiquadBatchDesigner<double, maxSections> batchDesigner;
+    std::array<size_t, maxSections> batchTargets {};
     std::vector<Band> bands;
 
+    // Writers are serialised by snapshotLock, the audio thread only ever
+    // calls acquire() on the triple buffer & never waits.
+    SpinLock snapshotLock;
+    FilterSnapshot pendingSnapshot;
+    tobanteAudio::TripleBuffer<FilterSnapshot> snapshots;
+
+    // Audio thread only
+    std::array<SectionSmoother, maxFilterBands> smoothers;
+    std::array<SlopeSections, maxFilterBands> slopeSections {};
+    std::array<size_t, maxSections> sectionSequence {};
+    size_t numActiveBands = 0;
+
+    // Dynamic bands scale their gain with the level in their region, updated
+    // once per control interval
+    tobanteAudio::BandDetector<maxFilterBands> detector;
+
+    // Bands keyed by the sidechain, skipped & at unity gain while it is
+    // disconnected
+    tobanteAudio::BandDetector<maxFilterBands> sidechainDetector;
+    const AudioBuffer<float>* sidechain {nullptr};
+    const AudioBuffer<double>* doubleSidechain {nullptr};
+    bool hasSidechain = false;
+    bool snapSmoothers = true;
+    std::atomic<int> controlInterval {FILTER_CONTROL_INTERVAL};
+
+    // Oversampling
+    Oversamplers<float> oversamplers;
+    Oversamplers<double> doubleOversamplers;
+    std::atomic<float>* oversamplingOrder {nullptr};
+    std::atomic<float>* oversamplingFilter {nullptr};
+    int activeOversampler   = -1;
+    double filterSampleRate = 0.0;
+
+    // Linear phase, the kernel follows the summed magnitude response
+    tobanteAudio::PartitionedConvolver convolver;
+    tobanteAudio::LinearPhaseDesigner linearPhaseDesigner {convolver, LINEAR_PHASE_FFT_SIZE};
+    std::atomic<float>* phaseMode {nullptr};
+    AudioBuffer<float> convolutionBuffer;
+    bool wasLinearPhase = false;
+
+    // Bilinear (RBJ) or matched coefficient design
+    std::atomic<float>* designMethod {nullptr};
+    int activeDesign = -1;
+
+    // Biquad or state variable sections, only the latter can be modulated
+    std::atomic<float>* topology {nullptr};
+    int activeTopology = -1;
+    // Per-sample frequency ratios of the modulated bands at the rate the
+    // sections run at, one row per band
+    bool audioRateModulation = false;
+    AudioBuffer<float> frequencyRamps;
+    AudioBuffer<double> doubleFrequencyRamps;
+
     std::vector<double> frequencies;
     std::vector<double> magnitudes;
 
+    // The magnitudes & paths are computed in the background, the finished
+    // ones are swapped in on the message thread
+    tobanteAudio::ResponseCurveWorker responseWorker;
+    tobanteAudio::ResponseCurveWorker::Request responseRequest;
+    tobanteAudio::ResponseCurveWorker::Result responseCurves;
+    Rectangle<int> plotBounds;
+    float plotPixelsPerDouble = 0.0f;
+
     tobanteAudio::SpectrumAnalyser<float> inputAnalyser;
     tobanteAudio::SpectrumAnalyser<float> outputAnalyser;
+    AudioBuffer<float> analyserBuffer;
+    std::atomic<float>* analyserChannels {nullptr};
+    int numAnalyserChannels {0};
+
+    // Silence detection, the cascade is skipped once idle
+    int silentSamples {0};
+    int tailSamples {0};
+    bool idle {false};
 
     tobanteAudio::GainTextConverter gainTextConverter;
     tobanteAudio::ActiveTextConverter activeTextConverter;
@@ -224,7 +712,96 @@ private:
     tobanteAudio::FrequencyTextConverter frequencyTextConverter;
     tobanteAudio::FilterTypeTextConverter filterTypeTextConverter;
 
+    /**
+     * @brief Listens to a single band parameter. A change only marks its band,
+     * the values are read from the state when they are needed.
+     */
+    class BandParameterListener : public AudioProcessorValueTreeState::Listener
+    {
+    public:
+        BandParameterListener(EqualizerProcessor& p, size_t i) : owner(p), band(i) { }
+
+        void parameterChanged(const String& parameterID, float newValue) override
+        {
+            ignoreUnused(parameterID, newValue);
+            owner.markBandChanged(band);
+        }
+
+    private:
+        EqualizerProcessor& owner;
+        size_t band;
+    };
+
+    using BandParameterValues = std::array<std::atomic<float>*, LastBandParameterID>;
+
+    std::vector<std::array<String, LastBandParameterID>> bandParamIDs;
+    std::vector<BandParameterValues> bandParameterValues;
+    std::vector<std::unique_ptr<BandParameterListener>> bandParameterListeners;
+
+    // One bit per band, set by the listeners on any thread. The audio thread
+    // clears the first at the start of a block, the message thread the second.
+    static_assert(FILTER_MAX_BANDS <= 64, "One bit per band");
+    std::atomic<uint64> changedSections {0};
+    std::atomic<uint64> changedPlots {0};
+
     void setDefaults();
+    void markBandChanged(size_t index) noexcept;
+    template <typename Model> void loadBandParameters(size_t index, Model& model) const noexcept;
+    bool isBandActive(size_t index) const noexcept;
+    void applyBandChanges();
+    void updateResponse(size_t index);
+    uint64 limitSlopeSections(uint64 changed);
+    static FilterSlope getSteepestSlope(FilterSlope slope, size_t numSections);
+    void resizeResponseGrid(int numPoints);
+    void timerCallback() override;
+    static const String& getBandParameterSuffix(BandParameter parameter);
+    void updateNumBands();
+    void publishSnapshot();
+    void applySnapshot();
+    void updateSmoothedSections(int numSamples);
+    void setBandCoefficients(size_t band, FilterType type, FilterSlope slope, float frequency, float quality,
+                             float gain);
+    template <typename SampleType>
+    void setBandCoefficients(FilterEngine<SampleType>& engine, size_t band, FilterType type, FilterSlope slope,
+                             float frequency, float quality, float gain);
+    template <typename SampleType> void clearSlopeSections(FilterEngine<SampleType>& engine, size_t band);
+    void queueModulatedBand(size_t band, float frequency, float quality, float gain);
+    void queueBandCoefficients(size_t band, FilterType type, FilterSlope slope, float frequency, float quality,
+                               float gain);
+    void designQueuedSections();
+    template <typename SampleType> void setQueuedCoefficients(FilterEngine<SampleType>& engine);
+    static BiquadShape getBiquadShape(FilterType type) noexcept;
+    void redesignSections();
+    int getOversamplerIndex() const;
+    int getOversamplingFactor() const;
+    void updateLatency();
+    FilterDesigner::Coefficients makeCoefficients(FilterType type, float frequency, float quality, float gain) const;
+    FilterDesigner::Coefficients designSection(FilterType type, double rate, float frequency, float quality,
+                                               float gain) const;
+    template <typename Designer>
+    static typename Designer::Coefficients designWith(FilterType type, double rate, float frequency, float quality,
+                                                      float gain);
+
+    template <typename SampleType>
+    void prepareOversamplers(Oversamplers<SampleType>& newOversamplers, int numChannels, int samplesPerBlock);
+
+    void addAnalyserData(tobanteAudio::SpectrumAnalyser<float>& analyser, const AudioBuffer<float>& buffer);
+
+    template <typename SampleType>
+    static bool isSilent(const AudioBuffer<SampleType>& buffer, SampleType threshold) noexcept;
+    template <typename SampleType> void updateIdleState(const AudioBuffer<SampleType>& buffer, bool inputSilent);
+    void processLinearPhase(AudioBuffer<float>& buffer);
+    void processLinearPhase(AudioBuffer<double>& buffer);
+
+    void updateModulationMode() noexcept;
+    template <typename SampleType>
+    void renderFrequencyRamps(AudioBuffer<SampleType>& ramps, int numSamples,
+                              std::array<const SampleType*, maxFilterBands>& modulation) noexcept;
+
+    template <typename SampleType>
+    void processFilter(AudioBuffer<SampleType>& buffer, FilterEngine<SampleType>& engine,
+                       Oversamplers<SampleType>& oversampling, AudioBuffer<SampleType>& ramps,
+                       const AudioBuffer<SampleType>* key, int keyOffset);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EqualizerProcessor)
 };
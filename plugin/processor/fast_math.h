@@ -0,0 +1,65 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+namespace tobanteAudio
+{
+/**
+ * @brief Approximates tan(x) for x in [0, pi/2).
+ *
+ * @details Uses a (5, 4) Pade approximant on [0, pi/4] & tan(x) =
+ * 1 / tan(pi/2 - x) above. In double precision the relative error is below
+ * 1e-7, which is plenty for prewarping cutoff frequencies, at a fraction of
+ * the cost of std::tan.
+ */
+template <typename FloatType> FloatType fastTan(FloatType x) noexcept
+{
+    constexpr auto quarterPi = MathConstants<FloatType>::pi / FloatType(4);
+    const auto reflect       = x > quarterPi;
+    const auto y             = reflect ? MathConstants<FloatType>::halfPi - x : x;
+    const auto y2            = y * y;
+
+    const auto numerator   = y * (FloatType(945) + y2 * (FloatType(-105) + y2));
+    const auto denominator = FloatType(945) + y2 * (FloatType(-420) + y2 * FloatType(15));
+    return reflect ? denominator / numerator : numerator / denominator;
+}
+
+/**
+ * @brief Approximates tan(x) for x in [0, pi/2) with double precision
+ * accuracy.
+ *
+ * @details Same scheme as fastTan, with a (7, 6) Pade approximant. The
+ * relative error stays below 1e-12, so coefficients designed with it match
+ * the ones from std::tan.
+ */
+template <typename FloatType> FloatType preciseTan(FloatType x) noexcept
+{
+    constexpr auto quarterPi = MathConstants<FloatType>::pi / FloatType(4);
+    const auto reflect       = x > quarterPi;
+    const auto y             = reflect ? MathConstants<FloatType>::halfPi - x : x;
+    const auto y2            = y * y;
+
+    const auto numerator   = y * (FloatType(135135) + y2 * (FloatType(-17325) + y2 * (FloatType(378) - y2)));
+    const auto denominator = FloatType(135135) + y2 * (FloatType(-62370) + y2 * (FloatType(3150) - y2 * FloatType(28)));
+    return reflect ? denominator / numerator : numerator / denominator;
+}
+
+}  // namespace tobanteAudio
@@ -0,0 +1,253 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "../settings/constants.h"
+
+namespace tobanteAudio
+{
+/**
+ * @brief Bank of LFOs evaluated at control rate from wavetables.
+ *
+ * @details Each SIMD lane holds one LFO, a call to process() returns the
+ * value of every LFO at its current phase & then advances all phases by the
+ * given number of samples. The wavetables are shared by all instances, the
+ * lookup is a gather per lane, the interpolation, gain & phase increment run
+ * in the registers. Sample & hold reads a constant table & scales it with a
+ * value drawn at every wrap of its phase.
+ */
+class LfoBank
+{
+public:
+    using Vec = dsp::SIMDRegister<float>;
+
+    /**
+     * @brief Number of LFOs processed by one register.
+     */
+    static constexpr size_t lanes        = Vec::SIMDNumElements;
+    static constexpr size_t numLfos      = LFO_NUM_SOURCES;
+    static constexpr size_t numRegisters = (numLfos + lanes - 1) / lanes;
+    static constexpr size_t tableSize    = LFO_TABLE_SIZE;
+    static_assert(numLfos <= MODULATION_MAX_SOURCES, "Every LFO needs a source of the modulation matrix");
+
+    /**
+     * @brief Waveforms of the LFOs.
+     */
+    enum Shape
+    {
+        Sine = 0,
+        Triangle,
+        Saw,
+        Square,
+        SampleAndHold,
+        LastShape,
+    };
+
+    /**
+     * @brief Constructor. All LFOs start as a sine at LFO_FREQ_DEFAULT.
+     */
+    LfoBank()
+    {
+        frequencies.fill(LFO_FREQ_DEFAULT);
+        gains.fill(1.0f);
+        held.fill(1.0f);
+        updateIncrements();
+        reset();
+    }
+
+    /**
+     * @brief Sets the sample rate the phases are advanced with.
+     */
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        updateIncrements();
+        reset();
+    }
+
+    /**
+     * @brief Restarts all LFOs at phase 0.
+     */
+    void reset() noexcept
+    {
+        phases.fill(0.0f);
+        for (size_t lfo = 0; lfo < numLfos; ++lfo) { drawHeldValue(lfo); }
+    }
+
+    /**
+     * @brief Sets the frequency of an LFO in Hz.
+     */
+    void setFrequency(size_t lfo, float frequency) noexcept
+    {
+        jassert(lfo < numLfos);
+        if (frequencies[lfo] == frequency) { return; }
+
+        frequencies[lfo] = frequency;
+        increments[lfo]  = static_cast<float>(frequency / sampleRate);
+    }
+
+    /**
+     * @brief Sets the linear gain of an LFO.
+     */
+    void setGain(size_t lfo, float gain) noexcept
+    {
+        jassert(lfo < numLfos);
+        gains[lfo]      = gain;
+        amplitudes[lfo] = gain * held[lfo];
+    }
+
+    /**
+     * @brief Sets the waveform of an LFO.
+     */
+    void setShape(size_t lfo, Shape shape) noexcept
+    {
+        jassert(lfo < numLfos);
+        if (shapes[lfo] == shape) { return; }
+
+        shapes[lfo]       = shape;
+        tableOffsets[lfo] = static_cast<size_t>(shape) * (tableSize + 1);
+        drawHeldValue(lfo);
+    }
+
+    /**
+     * @brief Returns the waveform of an LFO.
+     */
+    Shape getShape(size_t lfo) const noexcept { return shapes[lfo]; }
+
+    /**
+     * @brief Returns the values of all LFOs at their current phase & advances
+     * them by the given number of samples.
+     */
+    const float* process(int numSamples) noexcept
+    {
+        const auto& tables = getTables();
+        const auto scale   = Vec::expand(static_cast<float>(tableSize));
+        const auto advance = Vec::expand(static_cast<float>(numSamples));
+
+        alignas(Vec::SIMDRegisterSize) std::array<float, lanes> position {};
+        alignas(Vec::SIMDRegisterSize) std::array<float, lanes> lower {};
+        alignas(Vec::SIMDRegisterSize) std::array<float, lanes> upper {};
+        alignas(Vec::SIMDRegisterSize) std::array<float, lanes> fraction {};
+
+        for (size_t reg = 0; reg < numRegisters; ++reg)
+        {
+            const auto offset = reg * lanes;
+            auto phase        = Vec::fromRawArray(phases.data() + offset);
+
+            // The table lookup is the only part which isn't vectorised
+            (phase * scale).copyToRawArray(position.data());
+            for (size_t lane = 0; lane < lanes; ++lane)
+            {
+                const auto index = jmin(static_cast<size_t>(position[lane]), tableSize - 1);
+                const auto* row  = tables.data() + tableOffsets[offset + lane] + index;
+                lower[lane]      = row[0];
+                upper[lane]      = row[1];
+                fraction[lane]   = position[lane] - static_cast<float>(index);
+            }
+
+            const auto a     = Vec::fromRawArray(lower.data());
+            const auto b     = Vec::fromRawArray(upper.data());
+            const auto value = a + (b - a) * Vec::fromRawArray(fraction.data());
+            (value * Vec::fromRawArray(amplitudes.data() + offset)).copyToRawArray(values.data() + offset);
+
+            phase = phase + Vec::fromRawArray(increments.data() + offset) * advance;
+            phase.copyToRawArray(phases.data() + offset);
+        }
+
+        // Wraps are rare at control rate, each one draws a new held value
+        for (size_t lfo = 0; lfo < numLfos; ++lfo)
+        {
+            if (phases[lfo] < 1.0f) { continue; }
+
+            phases[lfo] -= std::floor(phases[lfo]);
+            if (shapes[lfo] == SampleAndHold) { drawHeldValue(lfo); }
+        }
+
+        return values.data();
+    }
+
+    /**
+     * @brief Returns the values of the last call to process.
+     */
+    const float* getValues() const noexcept { return values.data(); }
+
+private:
+    static constexpr size_t numSlots = numRegisters * lanes;
+
+    /**
+     * @brief All tables in one block, a table holds one period & repeats its
+     * first point at the end for the interpolation.
+     */
+    using Tables = std::array<float, static_cast<size_t>(LastShape) * (tableSize + 1)>;
+
+    static const Tables& getTables()
+    {
+        static const Tables tables = []() {
+            Tables result {};
+            for (size_t i = 0; i <= tableSize; ++i)
+            {
+                const auto phase = static_cast<float>(i % tableSize) / static_cast<float>(tableSize);
+                const auto row   = [&](Shape shape) -> float& {
+                    return result[static_cast<size_t>(shape) * (tableSize + 1) + i];
+                };
+
+                row(Sine)          = std::sin(MathConstants<float>::twoPi * phase);
+                row(Triangle)      = 1.0f - 4.0f * std::abs(std::fmod(phase + 0.25f, 1.0f) - 0.5f);
+                row(Saw)           = 2.0f * phase - 1.0f;
+                row(Square)        = phase < 0.5f ? 1.0f : -1.0f;
+                row(SampleAndHold) = 1.0f;
+            }
+            return result;
+        }();
+        return tables;
+    }
+
+    void updateIncrements() noexcept
+    {
+        for (size_t lfo = 0; lfo < numLfos; ++lfo)
+        { increments[lfo] = static_cast<float>(frequencies[lfo] / sampleRate); }
+    }
+
+    void drawHeldValue(size_t lfo) noexcept
+    {
+        held[lfo]       = shapes[lfo] == SampleAndHold ? random.nextFloat() * 2.0f - 1.0f : 1.0f;
+        amplitudes[lfo] = gains[lfo] * held[lfo];
+    }
+
+    double sampleRate = 44100.0;
+    Random random;
+
+    // Unused lanes of the last register stay silent
+    alignas(Vec::SIMDRegisterSize) std::array<float, numSlots> phases {};
+    alignas(Vec::SIMDRegisterSize) std::array<float, numSlots> increments {};
+    alignas(Vec::SIMDRegisterSize) std::array<float, numSlots> amplitudes {};
+    alignas(Vec::SIMDRegisterSize) std::array<float, numSlots> values {};
+    std::array<size_t, numSlots> tableOffsets {};
+
+    std::array<float, numLfos> frequencies {};
+    std::array<float, numLfos> gains {};
+    std::array<float, numLfos> held {};
+    std::array<Shape, numLfos> shapes {};
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LfoBank)
+};
+}  // namespace tobanteAudio
@@ -0,0 +1,177 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "partitioned_convolver.h"
+
+namespace tobanteAudio
+{
+/**
+ * @brief Builds a linear-phase FIR from a magnitude response on a background
+ * thread & hands it to a PartitionedConvolver.
+ */
+class LinearPhaseDesigner : public Thread
+{
+public:
+    /**
+     * @brief Constructor. The kernel has fftSize - 1 taps.
+     */
+    LinearPhaseDesigner(PartitionedConvolver& c, int fftSize)
+        : Thread("LinearPhaseDesigner"), convolver(c), kernel(static_cast<size_t>(fftSize - 1))
+    {
+        jassert(isPowerOfTwo(fftSize));
+    }
+
+    /**
+     * @brief Destructor. Stops the thread.
+     */
+    ~LinearPhaseDesigner() override { stopThread(1000); }
+
+    /**
+     * @brief Returns the number of taps of the kernel.
+     */
+    int getKernelLength() const noexcept { return static_cast<int>(kernel.size()); }
+
+    /**
+     * @brief Returns the delay of the kernel in samples, half its length.
+     */
+    int getKernelDelay() const noexcept { return (getKernelLength() - 1) / 2; }
+
+    /**
+     * @brief Stores a new magnitude response, sampled at the given
+     * frequencies. The kernel is rebuilt on the background thread.
+     */
+    void requestUpdate(const std::vector<double>& frequencies, const std::vector<double>& magnitudes,
+                       double sampleRate)
+    {
+        {
+            const ScopedLock lock(requestLock);
+            requestedFrequencies = frequencies;
+            requestedMagnitudes  = magnitudes;
+            requestedSampleRate  = sampleRate;
+        }
+
+        notify();
+    }
+
+    /**
+     * @brief Builds the kernel for the last request on the calling thread.
+     */
+    void updateNow()
+    {
+        const ScopedLock lock(designLock);
+
+        {
+            const ScopedLock requestScope(requestLock);
+            designFrequencies = requestedFrequencies;
+            designMagnitudes  = requestedMagnitudes;
+            designSampleRate  = requestedSampleRate;
+        }
+
+        if (designSampleRate <= 0.0 || designFrequencies.empty()) { return; }
+
+        designKernel(designFrequencies, designMagnitudes, designSampleRate, kernel);
+        convolver.setKernel(kernel.data(), getKernelLength());
+    }
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            wait(-1);
+            if (threadShouldExit()) { return; }
+
+            updateNow();
+        }
+    }
+
+    /**
+     * @brief Designs a symmetric FIR, whose magnitude follows the response
+     * given on a (logarithmic) frequency grid. The number of taps is the size
+     * of result, which needs to be one less than a power of two.
+     *
+     * @details The response is interpolated onto the bins of an FFT, the
+     * inverse transform gives the zero-phase impulse response. It is shifted
+     * by half the kernel length & windowed.
+     */
+    static void designKernel(const std::vector<double>& frequencies, const std::vector<double>& magnitudes,
+                             double sampleRate, std::vector<float>& result)
+    {
+        jassert(frequencies.size() == magnitudes.size() && !frequencies.empty());
+
+        const auto fftSize = static_cast<int>(result.size()) + 1;
+        jassert(isPowerOfTwo(fftSize));
+
+        dsp::FFT fft(roundToInt(std::log2(fftSize)));
+        std::vector<float> spectrum(static_cast<size_t>(fftSize * 2), 0.0f);
+        for (int bin = 0; bin <= fftSize / 2; ++bin)
+        {
+            const auto frequency = bin * sampleRate / fftSize;
+            const auto magnitude = interpolate(frequencies, magnitudes, frequency);
+
+            spectrum[static_cast<size_t>(bin * 2)] = static_cast<float>(magnitude);
+        }
+
+        fft.performRealOnlyInverseTransform(spectrum.data());
+
+        std::vector<float> window(result.size());
+        dsp::WindowingFunction<float>::fillWindowingTables(window.data(), window.size(),
+                                                           dsp::WindowingFunction<float>::blackman, false);
+
+        const auto delay = fftSize / 2 - 1;
+        for (size_t i = 0; i < result.size(); ++i)
+        {
+            const auto index = (static_cast<int>(i) - delay + fftSize) % fftSize;
+            result[i]        = spectrum[static_cast<size_t>(index)] * window[i];
+        }
+    }
+
+private:
+    static double interpolate(const std::vector<double>& x, const std::vector<double>& y, double position)
+    {
+        if (position <= x.front()) { return y.front(); }
+        if (position >= x.back()) { return y.back(); }
+
+        // Linear in log frequency, which is how the plot grid is spaced
+        const auto upper = static_cast<size_t>(std::upper_bound(x.begin(), x.end(), position) - x.begin());
+        const auto lower = upper - 1;
+        const auto t     = std::log(position / x[lower]) / std::log(x[upper] / x[lower]);
+        return y[lower] + t * (y[upper] - y[lower]);
+    }
+
+    PartitionedConvolver& convolver;
+
+    CriticalSection requestLock;
+    std::vector<double> requestedFrequencies;
+    std::vector<double> requestedMagnitudes;
+    double requestedSampleRate {0.0};
+
+    // Guarded by designLock
+    CriticalSection designLock;
+    std::vector<double> designFrequencies;
+    std::vector<double> designMagnitudes;
+    double designSampleRate {0.0};
+    std::vector<float> kernel;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LinearPhaseDesigner)
+};
+
+}  // namespace tobanteAudio
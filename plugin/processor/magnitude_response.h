@@ -0,0 +1,117 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "biquad_cascade.h"
+
+namespace tobanteAudio
+{
+/**
+ * @brief Evaluates the magnitude response of cascades of second order
+ * sections on a fixed frequency grid.
+ *
+ * @details The trigonometric terms only depend on the grid & the sample rate,
+ * they are computed once in prepare. With phi = sin^2(w / 2) the squared
+ * magnitude of a section is
+ * ((b0 + b1 + b2)^2 - 4 (b0 b1 + 4 b0 b2 + b1 b2) phi + 16 b0 b2 phi^2) /
+ * ((1 + a1 + a2)^2 - 4 (a1 + 4 a2 + a1 a2) phi + 16 a2 phi^2),
+ * which unlike the cos(w) & cos(2w) form doesn't cancel for pass filters far
+ * from their cutoff. A section costs two polynomials per grid point, in loops
+ * the compiler vectorises, instead of complex exponentials. Numerators &
+ * denominators of all sections are multiplied first, so a cascade takes a
+ * single division & square root per point.
+ */
+class MagnitudeResponse
+{
+public:
+    using Coefficients = BiquadCoefficients<double>;
+
+    /**
+     * @brief Computes the trigonometric table for the grid & allocates the
+     * scratch buffers.
+     */
+    void prepare(const std::vector<double>& frequencies, double newSampleRate)
+    {
+        jassert(newSampleRate > 0.0);
+        sampleRate = newSampleRate;
+
+        phi.resize(frequencies.size());
+        numerator.resize(frequencies.size());
+        denominator.resize(frequencies.size());
+        for (size_t i = 0; i < frequencies.size(); ++i)
+        {
+            const auto halfOmega = MathConstants<double>::pi * frequencies[i] / sampleRate;
+            phi[i]               = std::sin(halfOmega) * std::sin(halfOmega);
+        }
+    }
+
+    /**
+     * @brief Returns the sample rate the table was computed for.
+     */
+    double getSampleRate() const noexcept { return sampleRate; }
+
+    /**
+     * @brief Returns the number of grid points.
+     */
+    size_t size() const noexcept { return phi.size(); }
+
+    /**
+     * @brief Writes the magnitude of a cascade of sections to magnitudes,
+     * which needs to hold size() values. No sections give a flat response.
+     */
+    void process(const Coefficients* sections, size_t numSections, double* magnitudes) noexcept
+    {
+        const auto numPoints = phi.size();
+        std::fill(numerator.begin(), numerator.end(), 1.0);
+        std::fill(denominator.begin(), denominator.end(), 1.0);
+
+        for (size_t section = 0; section < numSections; ++section)
+        {
+            const auto& c = sections[section];
+            const auto n0 = square(c.b0 + c.b1 + c.b2);
+            const auto n1 = -4.0 * (c.b0 * c.b1 + 4.0 * c.b0 * c.b2 + c.b1 * c.b2);
+            const auto n2 = 16.0 * c.b0 * c.b2;
+            const auto d0 = square(1.0 + c.a1 + c.a2);
+            const auto d1 = -4.0 * (c.a1 + 4.0 * c.a2 + c.a1 * c.a2);
+            const auto d2 = 16.0 * c.a2;
+
+            auto* const num = numerator.data();
+            auto* const den = denominator.data();
+            const auto* p   = phi.data();
+            for (size_t i = 0; i < numPoints; ++i)
+            {
+                num[i] *= n0 + p[i] * (n1 + p[i] * n2);
+                den[i] *= d0 + p[i] * (d1 + p[i] * d2);
+            }
+        }
+
+        // Rounding can push a zero of the response slightly below zero
+        for (size_t i = 0; i < numPoints; ++i)
+        { magnitudes[i] = std::sqrt(jmax(0.0, numerator[i]) / denominator[i]); }
+    }
+
+private:
+    std::vector<double> phi;
+    std::vector<double> numerator;
+    std::vector<double> denominator;
+    double sampleRate = 0.0;
+};
+}  // namespace tobanteAudio
@@ -0,0 +1,253 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "biquad_cascade.h"
+
+namespace tobanteAudio
+{
+/**
+ * @brief Computes second order sections whose magnitude matches the analog
+ * prototype up to Nyquist. Same interface as BiquadDesigner.
+ *
+ * @details Follows M. Vicanek, "Matched Second Order Digital Filters" (2016).
+ * The poles are placed by impulse invariance, the zeros are chosen so that the
+ * magnitude matches the analog one at DC, Nyquist & the centre frequency.
+ * Unlike the bilinear transform this does not cramp the response towards
+ * Nyquist. The cost per sample is the same.
+ */
+template <typename SampleType> struct MatchedDesigner
+{
+    using Coefficients = BiquadCoefficients<SampleType>;
+
+    /**
+     * @brief Returns a section which passes the signal through unchanged.
+     */
+    static Coefficients makeIdentity() noexcept { return {}; }
+
+    /**
+     * @brief Second order low-pass.
+     */
+    static Coefficients makeLowPass(double sampleRate, double frequency, double Q) noexcept
+    {
+        const auto poles = Poles {omega(sampleRate, frequency), Q};
+        const auto phi   = Phi {poles.w0};
+
+        const auto r1 = poles.magnitudeSquared(phi) * Q * Q;
+        const auto B0 = poles.A0;
+        const auto B1 = (r1 - B0 * phi.phi0) / phi.phi1;
+        const auto b0 = 0.5 * (std::sqrt(B0) + std::sqrt(jmax(0.0, B1)));
+
+        return make(b0, std::sqrt(B0) - b0, 0.0, poles);
+    }
+
+    /**
+     * @brief Second order high-pass.
+     */
+    static Coefficients makeHighPass(double sampleRate, double frequency, double Q) noexcept
+    {
+        const auto poles = Poles {omega(sampleRate, frequency), Q};
+        const auto phi   = Phi {poles.w0};
+        const auto b0    = std::sqrt(poles.magnitudeSquared(phi)) * Q / (4.0 * phi.phi1);
+
+        return make(b0, -2.0 * b0, b0, poles);
+    }
+
+    /**
+     * @brief Second order band-pass with 0 dB peak gain.
+     */
+    static Coefficients makeBandPass(double sampleRate, double frequency, double Q) noexcept
+    {
+        const auto poles = Poles {omega(sampleRate, frequency), Q};
+        const auto phi   = Phi {poles.w0};
+
+        const auto r1 = poles.magnitudeSquared(phi);
+        const auto r2 = -poles.A0 + poles.A1 + 4.0 * (phi.phi0 - phi.phi1) * poles.A2;
+        const auto B2 = (r1 - r2 * phi.phi1) / (4.0 * phi.phi1 * phi.phi1);
+        const auto B1 = r2 + 4.0 * (phi.phi1 - phi.phi0) * B2;
+        const auto b1 = -0.5 * std::sqrt(jmax(0.0, B1));
+        const auto b0 = 0.5 * (std::sqrt(jmax(0.0, B2 + b1 * b1)) - b1);
+
+        return make(b0, b1, -b0 - b1, poles);
+    }
+
+    /**
+     * @brief Second order low-shelf. Gain is a linear factor.
+     */
+    static Coefficients makeLowShelf(double sampleRate, double frequency, double Q, double gainFactor) noexcept
+    {
+        const auto A     = jmax(1.0e-6, std::sqrt(gainFactor));
+        const auto sqrtA = std::sqrt(A);
+        return match(omega(sampleRate, jmax(frequency, 2.0)),
+                     Prototype {A, A * sqrtA / Q, A * A, A, sqrtA / Q, 1.0});
+    }
+
+    /**
+     * @brief Second order high-shelf. Gain is a linear factor.
+     */
+    static Coefficients makeHighShelf(double sampleRate, double frequency, double Q, double gainFactor) noexcept
+    {
+        const auto A     = jmax(1.0e-6, std::sqrt(gainFactor));
+        const auto sqrtA = std::sqrt(A);
+        return match(omega(sampleRate, jmax(frequency, 2.0)),
+                     Prototype {A * A, A * sqrtA / Q, A, 1.0, sqrtA / Q, A});
+    }
+
+    /**
+     * @brief Second order peak (bell). Gain is a linear factor.
+     */
+    static Coefficients makePeakFilter(double sampleRate, double frequency, double Q, double gainFactor) noexcept
+    {
+        const auto A = jmax(1.0e-6, std::sqrt(gainFactor));
+        return match(omega(sampleRate, jmax(frequency, 2.0)), Prototype {1.0, A / Q, 1.0, 1.0, 1.0 / (A * Q), 1.0});
+    }
+
+private:
+    /**
+     * @brief Analog prototype (n2 s^2 + n1 s + n0) / (d2 s^2 + d1 s + d0),
+     * normalised to the centre frequency.
+     */
+    struct Prototype
+    {
+        double n2, n1, n0;
+        double d2, d1, d0;
+
+        double magnitudeSquared(double w) const noexcept
+        {
+            const auto w2  = w * w;
+            const auto num = square(n0 - n2 * w2) + square(n1 * w);
+            const auto den = square(d0 - d2 * w2) + square(d1 * w);
+            return num / den;
+        }
+    };
+
+    /**
+     * @brief Basis of the squared magnitude of a second order polynomial in
+     * z at the frequency w.
+     */
+    struct Phi
+    {
+        explicit Phi(double w) noexcept
+        {
+            phi1 = square(std::sin(0.5 * w));
+            phi0 = 1.0 - phi1;
+            phi2 = 4.0 * phi0 * phi1;
+        }
+
+        double phi0, phi1, phi2;
+    };
+
+    /**
+     * @brief Impulse invariant poles & the squared magnitude terms of the
+     * denominator at DC, Nyquist & for the cross term.
+     */
+    struct Poles
+    {
+        Poles(double w, double Q) noexcept : w0(w)
+        {
+            const auto q     = 0.5 / Q;
+            const auto decay = std::exp(-q * w0);
+            a1 = q <= 1.0 ? -2.0 * decay * std::cos(std::sqrt(1.0 - q * q) * w0)
+                          : -2.0 * decay * std::cosh(std::sqrt(q * q - 1.0) * w0);
+            a2 = decay * decay;
+            A0 = square(1.0 + a1 + a2);
+            A1 = square(1.0 - a1 + a2);
+            A2 = -4.0 * a2;
+        }
+
+        double magnitudeSquared(const Phi& phi) const noexcept
+        {
+            return A0 * phi.phi0 + A1 * phi.phi1 + A2 * phi.phi2;
+        }
+
+        double w0, a1, a2;
+        double A0, A1, A2;
+    };
+
+    static double omega(double sampleRate, double frequency) noexcept
+    {
+        return MathConstants<double>::twoPi * frequency / sampleRate;
+    }
+
+    /**
+     * @brief Matches the magnitude of the prototype at DC, Nyquist & the
+     * centre frequency. Cuts are designed as inverted boosts, so the poles are
+     * always the lower or, at the same frequency, the narrower pair.
+     */
+    static Coefficients match(double w0, const Prototype& prototype) noexcept
+    {
+        const auto polesBelowZeros = prototype.d0 * prototype.n2 <= prototype.n0 * prototype.d2;
+        const auto polesNarrower   = prototype.d1 * prototype.n2 <= prototype.n1 * prototype.d2;
+        const auto sameFrequency   = prototype.d0 * prototype.n2 == prototype.n0 * prototype.d2;
+        const auto invert          = sameFrequency ? !polesNarrower : !polesBelowZeros;
+        if (!invert) { return matchMagnitude(w0, prototype); }
+
+        const auto& p      = prototype;
+        const auto inverse = matchMagnitude(w0, Prototype {p.d2, p.d1, p.d0, p.n2, p.n1, p.n0});
+        const auto b0 = static_cast<double>(inverse.b0);
+        auto c        = Coefficients {};
+        c.b0          = static_cast<SampleType>(1.0 / b0);
+        c.b1          = static_cast<SampleType>(inverse.a1 / b0);
+        c.b2          = static_cast<SampleType>(inverse.a2 / b0);
+        c.a1          = static_cast<SampleType>(inverse.b1 / b0);
+        c.a2          = static_cast<SampleType>(inverse.b2 / b0);
+        return c;
+    }
+
+    static Coefficients matchMagnitude(double w0, const Prototype& prototype) noexcept
+    {
+        const auto poleFrequency = std::sqrt(prototype.d0 / prototype.d2);
+        const auto poleQ         = poleFrequency * prototype.d2 / prototype.d1;
+        const auto poles         = Poles {w0 * poleFrequency, poleQ};
+
+        // The centre frequency may lie above Nyquist, match just below instead
+        const auto wm  = jmin(w0, 0.9 * MathConstants<double>::pi);
+        const auto phi = Phi {wm};
+
+        const auto B0 = prototype.magnitudeSquared(0.0) * poles.A0;
+        const auto B1 = prototype.magnitudeSquared(MathConstants<double>::pi / w0) * poles.A1;
+        const auto B2 = (prototype.magnitudeSquared(wm / w0) * poles.magnitudeSquared(phi) - B0 * phi.phi0
+                         - B1 * phi.phi1)
+                        / phi.phi2;
+
+        // Minimum phase numerator from its squared magnitude terms
+        const auto sqrtB0 = std::sqrt(B0);
+        const auto sqrtB1 = std::sqrt(B1);
+        const auto w      = 0.5 * (sqrtB0 + sqrtB1);
+        const auto b0     = 0.5 * (w + std::sqrt(jmax(0.0, w * w + B2)));
+
+        return make(b0, 0.5 * (sqrtB0 - sqrtB1), w - b0, poles);
+    }
+
+    static Coefficients make(double b0, double b1, double b2, const Poles& poles) noexcept
+    {
+        auto c = Coefficients {};
+        c.b0   = static_cast<SampleType>(b0);
+        c.b1   = static_cast<SampleType>(b1);
+        c.b2   = static_cast<SampleType>(b2);
+        c.a1   = static_cast<SampleType>(poles.a1);
+        c.a2   = static_cast<SampleType>(poles.a2);
+        return c;
+    }
+};
+
+}  // namespace tobanteAudio
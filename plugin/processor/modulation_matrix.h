@@ -0,0 +1,345 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "../parameters/parameters.h"
+#include "../settings/constants.h"
+#include "triple_buffer.h"
+
+namespace tobanteAudio
+{
+/**
+ * @brief Parameters a modulation source can be connected to.
+ */
+enum class ModulationParameter
+{
+    Frequency = 0,
+    Gain,
+    Quality,
+    Output,
+};
+
+/**
+ * @brief Destination of a connection, the band is ignored for the output gain.
+ */
+struct ModulationTarget
+{
+    ModulationParameter parameter = ModulationParameter::Output;
+    int band                      = -1;
+
+    bool operator==(const ModulationTarget& other) const noexcept
+    {
+        return parameter == other.parameter && (parameter == ModulationParameter::Output || band == other.band);
+    }
+};
+
+/**
+ * @brief Routes modulation sources to band parameters & the output gain.
+ *
+ * @details The connections live in the state as children of a modulation
+ * tree, so they are saved & restored with it. Every change compacts the
+ * active connections into a list, which is handed to the audio thread through
+ * a triple buffer. The audio thread evaluates the list once per control
+ * interval & only touches the targets of its connections, an empty matrix
+ * costs nothing.
+ */
+class ModulationMatrix : private ValueTree::Listener
+{
+public:
+    static constexpr size_t maxBands       = FILTER_MAX_BANDS;
+    static constexpr size_t maxSources     = MODULATION_MAX_SOURCES;
+    static constexpr size_t maxConnections = MODULATION_MAX_CONNECTIONS;
+    static_assert(maxBands <= 64, "Modulated bands are collected in a 64 bit mask");
+
+    /**
+     * @brief A source connected to a target with a depth from -1 to 1.
+     */
+    struct Connection
+    {
+        int source = 0;
+        ModulationTarget target;
+        float depth = 0.0f;
+        bool active = true;
+    };
+
+    /**
+     * @brief Ratios the frequency, quality & gain of a band are multiplied
+     * with.
+     */
+    struct BandModulation
+    {
+        float frequency = 1.0f;
+        float quality   = 1.0f;
+        float gain      = 1.0f;
+    };
+
+    /**
+     * @brief Constructor. Follows the connections stored below the given
+     * tree, also after it was replaced.
+     */
+    explicit ModulationMatrix(ValueTree& stateTree) : root(stateTree)
+    {
+        rebuildConnections();
+        root.addListener(this);
+    }
+
+    /**
+     * @brief Destructor.
+     */
+    ~ModulationMatrix() override { root.removeListener(this); }
+
+    /**
+     * @brief Adds a connection or updates the one between the same source &
+     * target. Message thread only.
+     */
+    void setConnection(const Connection& connection)
+    {
+        auto child = findConnection(connection.source, connection.target);
+        if (!child.isValid())
+        {
+            // Filled before it is added, the audio thread sees it complete
+            child = ValueTree(Parameters::Connection);
+            writeConnection(child, connection);
+            root.getOrCreateChildWithName(Parameters::Modulation, nullptr).appendChild(child, nullptr);
+            return;
+        }
+
+        writeConnection(child, connection);
+    }
+
+    /**
+     * @brief Removes the connection between a source & a target. Message
+     * thread only.
+     */
+    void removeConnection(int source, ModulationTarget target)
+    {
+        auto child = findConnection(source, target);
+        if (child.isValid()) { child.getParent().removeChild(child, nullptr); }
+    }
+
+    /**
+     * @brief Returns all stored connections, also the inactive ones.
+     */
+    std::vector<Connection> getConnections() const
+    {
+        std::vector<Connection> result;
+        const auto tree = root.getChildWithName(Parameters::Modulation);
+        for (const auto& child : tree)
+        {
+            if (child.hasType(Parameters::Connection)) { result.push_back(readConnection(child)); }
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Sets the number of samples between two evaluations.
+     */
+    void setControlInterval(int numSamples) noexcept { controlInterval.store(jmax(1, numSamples)); }
+
+    /**
+     * @brief Returns the number of samples between two evaluations.
+     */
+    int getControlInterval() const noexcept { return controlInterval.load(); }
+
+    /**
+     * @brief Picks up changed connections. Returns true if the matrix needs
+     * to be evaluated, because of active connections or targets which still
+     * have to return to their parameters. Audio thread only.
+     */
+    bool acquireConnections() noexcept
+    {
+        connections.acquire();
+        return connections.getReadBuffer().numConnections > 0 || modulatedBands != 0 || outputModulated;
+    }
+
+    /**
+     * @brief Evaluates the connections for the current source values. Returns
+     * the mask of bands whose modulation needs to be applied, which includes
+     * the bands modulated by the previous call. Audio thread only.
+     */
+    uint64 process(const float* sourceValues, size_t numSources) noexcept
+    {
+        // Bands of the last call return to their parameters unless they are
+        // modulated again
+        const auto previous = modulatedBands;
+        forEachBand(previous, [this](size_t band) { bandModulation[band] = {}; });
+
+        modulatedBands    = 0;
+        outputModulated   = false;
+        auto outputOffset = 0.0f;
+        const auto& list  = connections.getReadBuffer();
+        for (size_t i = 0; i < list.numConnections; ++i)
+        {
+            const auto& connection = list.connections[i];
+            const auto source      = static_cast<size_t>(connection.source);
+            if (source >= numSources) { continue; }
+
+            const auto value = sourceValues[source] * connection.depth;
+            if (connection.target.parameter == ModulationParameter::Output)
+            {
+                outputOffset += value;
+                outputModulated = true;
+                continue;
+            }
+
+            const auto band = static_cast<size_t>(connection.target.band);
+            offsets[band][static_cast<size_t>(connection.target.parameter)] += value;
+            modulatedBands |= uint64 {1} << band;
+        }
+
+        // Offsets are in octaves & decibels, scaled by the range of a target
+        forEachBand(modulatedBands, [this](size_t band) {
+            auto& offset         = offsets[band];
+            auto& modulation     = bandModulation[band];
+            modulation.frequency = std::exp2(offset[0] * MODULATION_FREQUENCY_OCTAVES);
+            modulation.gain      = Decibels::decibelsToGain(offset[1] * MODULATION_GAIN_DB);
+            modulation.quality   = std::exp2(offset[2] * MODULATION_QUALITY_OCTAVES);
+            offset               = {};
+        });
+        outputGain = Decibels::decibelsToGain(outputOffset * MODULATION_GAIN_DB);
+
+        return modulatedBands | previous;
+    }
+
+    /**
+     * @brief Returns the ratios of a band after the last call to process.
+     */
+    const BandModulation& getBandModulation(size_t band) const noexcept { return bandModulation[band]; }
+
+    /**
+     * @brief Returns the factor for the output gain after the last call to
+     * process.
+     */
+    float getOutputGain() const noexcept { return outputGain; }
+
+private:
+    struct ConnectionList
+    {
+        std::array<Connection, maxConnections> connections {};
+        size_t numConnections = 0;
+    };
+
+    static bool isModulationTree(const ValueTree& tree)
+    {
+        return tree.hasType(Parameters::Connection) || tree.hasType(Parameters::Modulation);
+    }
+
+    void valueTreePropertyChanged(ValueTree& tree, const Identifier& /*property*/) override
+    {
+        if (isModulationTree(tree)) { rebuildConnections(); }
+    }
+
+    void valueTreeChildAdded(ValueTree& /*parent*/, ValueTree& child) override
+    {
+        if (isModulationTree(child)) { rebuildConnections(); }
+    }
+
+    void valueTreeChildRemoved(ValueTree& /*parent*/, ValueTree& child, int /*index*/) override
+    {
+        if (isModulationTree(child)) { rebuildConnections(); }
+    }
+
+    void valueTreeRedirected(ValueTree& /*tree*/) override { rebuildConnections(); }
+
+    /**
+     * @brief Publishes the active connections with a valid source & target.
+     */
+    void rebuildConnections()
+    {
+        const ScopedLock lock(writerLock);
+
+        auto& list          = connections.getWriteBuffer();
+        list.numConnections = 0;
+        for (const auto& connection : getConnections())
+        {
+            const auto isOutput  = connection.target.parameter == ModulationParameter::Output;
+            const auto hasSource = isPositiveAndBelow(connection.source, static_cast<int>(maxSources));
+            const auto hasBand   = isPositiveAndBelow(connection.target.band, static_cast<int>(maxBands));
+            const auto isValid   = hasSource && (isOutput || hasBand);
+            if (!connection.active || connection.depth == 0.0f || !isValid) { continue; }
+            if (list.numConnections == maxConnections) { break; }
+
+            list.connections[list.numConnections++] = connection;
+        }
+
+        connections.publish();
+    }
+
+    ValueTree findConnection(int source, ModulationTarget target) const
+    {
+        const auto tree = root.getChildWithName(Parameters::Modulation);
+        for (const auto& child : tree)
+        {
+            const auto connection = readConnection(child);
+            if (child.hasType(Parameters::Connection) && connection.source == source && connection.target == target)
+            { return child; }
+        }
+
+        return {};
+    }
+
+    static Connection readConnection(const ValueTree& tree)
+    {
+        Connection connection;
+        connection.source           = tree.getProperty(Parameters::Source, 0);
+        connection.target.parameter = static_cast<ModulationParameter>(static_cast<int>(
+            tree.getProperty(Parameters::Target, static_cast<int>(ModulationParameter::Output))));
+        connection.target.band      = tree.getProperty(Parameters::Band, -1);
+        connection.depth            = tree.getProperty(Parameters::Depth, 0.0f);
+        connection.active           = tree.getProperty(Parameters::Active, true);
+        return connection;
+    }
+
+    static void writeConnection(ValueTree& tree, const Connection& connection)
+    {
+        tree.setProperty(Parameters::Source, connection.source, nullptr);
+        tree.setProperty(Parameters::Target, static_cast<int>(connection.target.parameter), nullptr);
+        tree.setProperty(Parameters::Band, connection.target.band, nullptr);
+        tree.setProperty(Parameters::Depth, connection.depth, nullptr);
+        tree.setProperty(Parameters::Active, connection.active, nullptr);
+    }
+
+    template <typename Callback> static void forEachBand(uint64 mask, Callback&& callback)
+    {
+        for (size_t band = 0; mask != 0; ++band, mask >>= 1)
+        {
+            if ((mask & 1) != 0) { callback(band); }
+        }
+    }
+
+    ValueTree& root;
+
+    // Writers are serialised, the audio thread only reads the triple buffer
+    CriticalSection writerLock;
+    TripleBuffer<ConnectionList> connections;
+    std::atomic<int> controlInterval {MODULATION_CONTROL_INTERVAL};
+
+    // Audio thread only
+    std::array<std::array<float, 3>, maxBands> offsets {};
+    std::array<BandModulation, maxBands> bandModulation {};
+    uint64 modulatedBands = 0;
+    bool outputModulated  = false;
+    float outputGain      = 1.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulationMatrix)
+};
+}  // namespace tobanteAudio
@@ -18,59 +18,109 @@
 
 namespace tobanteAudio
 {
-ModulationSourceProcessor::ModulationSourceProcessor(int i, AudioProcessorValueTreeState& vts)
-    : BaseProcessor(vts)
-    , index(i)
-    , paramIDGain("lfo_" + String(index) + "_gain")
-    , paramIDFrequency("lfo_" + String(index) + "_freq")
+ModulationSourceProcessor::ModulationSourceProcessor(AudioProcessorValueTreeState& vts) : BaseProcessor(vts)
 {
-    oscillator.setFrequency(1.f);
-    oscillator.initialise([](float x) { return std::sin(x); });
+    auto frequencyRange = NormalisableRange<float> {LFO_FREQ_MIN, LFO_FREQ_MAX, LFO_FREQ_STEP_SIZE};
+    frequencyRange.setSkewForCentre(LFO_FREQ_SKEW);
+    const auto gainRange = NormalisableRange<float> {GAIN_MIN, LFO_GAIN_MAX, GAIN_STEP_SIZE};
+
+    // The frequency & gain of the first LFO come with the layout of the
+    // plugin & keep their place in the host's parameter list
+    for (int i = 0; i < numSources; ++i)
+    {
+        const auto name = "LFO " + String(i + 1);
+        if (state.getParameter(getFrequencyParamID(i)) == nullptr)
+        {
+            state.createAndAddParameter(std::make_unique<AudioParameterFloat>(
+                getFrequencyParamID(i), name + " freq", frequencyRange, LFO_FREQ_DEFAULT));
+        }
+        if (state.getParameter(getGainParamID(i)) == nullptr)
+        {
+            state.createAndAddParameter(
+                std::make_unique<AudioParameterFloat>(getGainParamID(i), name + " gain", gainRange, GAIN_DEFAULT));
+        }
+        state.createAndAddParameter(
+            std::make_unique<AudioParameterChoice>(getShapeParamID(i), name + " shape", getShapeNames(), 0));
+
+        const auto lfo           = static_cast<size_t>(i);
+        frequencyParameters[lfo] = state.getRawParameterValue(getFrequencyParamID(i));
+        gainParameters[lfo]      = state.getRawParameterValue(getGainParamID(i));
+        shapeParameters[lfo]     = state.getRawParameterValue(getShapeParamID(i));
+    }
 }
 
-ModulationSourceProcessor::~ModulationSourceProcessor() { analyser.stopThread(1000); }
+ModulationSourceProcessor::~ModulationSourceProcessor()
+{
+    for (auto& analyser : analysers) { analyser.stopThread(1000); }
+}
 
-void ModulationSourceProcessor::prepareToPlay(double newSampleRate, int samplesPerBlock)
+void ModulationSourceProcessor::prepareToPlay(double newSampleRate, int /*samplesPerBlock*/)
 {
     sampleRate = newSampleRate;
-
-    auto spec             = dsp::ProcessSpec {};
-    spec.sampleRate       = sampleRate;
-    spec.maximumBlockSize = static_cast<uint32>(samplesPerBlock);
-    spec.numChannels      = static_cast<uint32>(getTotalNumOutputChannels());
-
-    oscillator.prepare(spec);
-    gain.prepare(spec);
-
-    auto freqValue = state.getRawParameterValue(paramIDFrequency)->load();
-    oscillator.setFrequency(freqValue);
-
-    analyser.setupAnalyser(int(sampleRate), float(sampleRate));
+    bank.prepare(sampleRate);
+    analyserBlock.clear();
+    analyserPosition     = 0;
+    samplesSinceAnalysis = 0;
+
+    // The plots run at the rate the sources are sampled with
+    const auto controlRate = sampleRate / MODULATION_CONTROL_INTERVAL;
+    for (auto& analyser : analysers) { analyser.setupAnalyser(int(controlRate), float(controlRate)); }
 }
 
-void ModulationSourceProcessor::processBlock(AudioBuffer<float>& buffer, MidiBuffer&)
+const float* ModulationSourceProcessor::process(const int numSamples) noexcept
 {
-    float freqValue = state.getRawParameterValue(paramIDFrequency)->load();
-    float gainValue = state.getRawParameterValue(paramIDGain)->load();
+    for (size_t lfo = 0; lfo < LfoBank::numLfos; ++lfo)
+    {
+        bank.setFrequency(lfo, frequencyParameters[lfo]->load());
+        bank.setGain(lfo, gainParameters[lfo]->load());
+        bank.setShape(lfo, static_cast<LfoBank::Shape>(static_cast<int>(shapeParameters[lfo]->load())));
+    }
+
+    const auto* values = bank.process(numSamples);
+
+    // One value per control interval, longer calls repeat it
+    for (samplesSinceAnalysis += numSamples; samplesSinceAnalysis >= MODULATION_CONTROL_INTERVAL;
+         samplesSinceAnalysis -= MODULATION_CONTROL_INTERVAL)
+    {
+        for (int lfo = 0; lfo < numSources; ++lfo) { analyserBlock.setSample(lfo, analyserPosition, values[lfo]); }
+        if (++analyserPosition < analyserBlock.getNumSamples()) { continue; }
+
+        for (int lfo = 0; lfo < numSources; ++lfo) { analysers[size_t(lfo)].addAudioData(analyserBlock, lfo, 1); }
+        analyserPosition = 0;
+    }
+
+    return values;
+}
 
-    oscillator.setFrequency(freqValue);
-    gain.setGainLinear(gainValue);
+void ModulationSourceProcessor::createAnalyserPlot(const int source, Path& p, Rectangle<int>& bounds, float minFreq)
+{
+    analysers[size_t(source)].createPath(p, bounds.toFloat(), minFreq);
+}
 
-    dsp::AudioBlock<float> block(buffer);
-    dsp::ProcessContextReplacing<float> context(block);
-    oscillator.process(context);
-    gain.process(context);
+bool ModulationSourceProcessor::checkForNewAnalyserData(const int source)
+{
+    return analysers[size_t(source)].checkForNewData();
+}
 
-    analyser.addAudioData(buffer, 0, 1);
+String ModulationSourceProcessor::getFrequencyParamID(const int source) const
+{
+    return "lfo_" + String(source + 1) + "_freq";
 }
 
-void ModulationSourceProcessor::parameterChanged(const String& /*parameter*/, float /*newValue*/) { }
+String ModulationSourceProcessor::getGainParamID(const int source) const
+{
+    return "lfo_" + String(source + 1) + "_gain";
+}
 
-void ModulationSourceProcessor::createAnalyserPlot(Path& p, Rectangle<int>& bounds, float minFreq)
+String ModulationSourceProcessor::getShapeParamID(const int source) const
 {
-    analyser.createPath(p, bounds.toFloat(), minFreq);
+    return "lfo_" + String(source + 1) + "_shape";
 }
 
-bool ModulationSourceProcessor::checkForNewAnalyserData() { return analyser.checkForNewData(); }
+StringArray ModulationSourceProcessor::getShapeNames()
+{
+    return {translate("Sine"), translate("Triangle"), translate("Saw"), translate("Square"),
+            translate("Sample & Hold")};
+}
 
-}  // namespace tobanteAudio
\ No newline at end of file
+}  // namespace tobanteAudio
@@ -17,38 +17,61 @@
 #pragma once
 
 #include "../analyser/modulation_source_analyser.h"
-#include "../parameters/text_value_converter.h"
 #include "base_processor.h"
+#include "lfo_bank.h"
 
 namespace tobanteAudio
 {
 /**
- * @brief Processor class for a modulation source. Holds a dsp::Oscillator<float>.
+ * @brief Processor class for the modulation sources. Holds a bank of
+ * LFO_NUM_SOURCES LFOs, which runs at control rate.
  */
-class ModulationSourceProcessor : public BaseProcessor, public AudioProcessorValueTreeState::Listener
-
+class ModulationSourceProcessor : public BaseProcessor
 {
 public:
-    ModulationSourceProcessor(int, AudioProcessorValueTreeState&);
+    static constexpr auto numSources = static_cast<int>(LfoBank::numLfos);
+
+    /**
+     * @brief Constructor. Adds the frequency, gain & shape parameters of every
+     * LFO to the state, skipping the ones the state already has.
+     */
+    ModulationSourceProcessor(AudioProcessorValueTreeState&);
     ~ModulationSourceProcessor() override;
 
     void prepareToPlay(double /*unused*/, int /*unused*/) override;
-    void processBlock(AudioBuffer<float>& /*unused*/, MidiBuffer& /*unused*/) override;
 
-    void parameterChanged(const String& parameter, float newValue) override;
+    /**
+     * @brief Returns the values of all sources at the start of the next
+     * numSamples samples & advances them. Called once per control interval
+     * from the audio thread.
+     */
+    const float* process(int numSamples) noexcept;
+
+    void createAnalyserPlot(int source, Path&, Rectangle<int>&, float);
+    bool checkForNewAnalyserData(int source);
 
-    void createAnalyserPlot(Path&, Rectangle<int>&, float);
-    bool checkForNewAnalyserData();
+    void reset() override { bank.reset(); }
 
-    void reset() override { oscillator.reset(); }
+    String getFrequencyParamID(int source) const;
+    String getGainParamID(int source) const;
+    String getShapeParamID(int source) const;
+
+    /**
+     * @brief Names of the LFO shapes, in the order of LfoBank::Shape.
+     */
+    static StringArray getShapeNames();
 
 private:
-    int index;
-    String paramIDGain, paramIDFrequency;
-    dsp::Oscillator<float> oscillator;
-    dsp::Gain<float> gain;
-    tobanteAudio::ModulationSourceAnalyser<float> analyser;
-    FrequencyTextConverter frequencyTextConverter;
+    LfoBank bank;
+    std::array<std::atomic<float>*, LfoBank::numLfos> frequencyParameters {};
+    std::array<std::atomic<float>*, LfoBank::numLfos> gainParameters {};
+    std::array<std::atomic<float>*, LfoBank::numLfos> shapeParameters {};
+
+    // The plots are fed with the control rate values in blocks
+    std::array<tobanteAudio::ModulationSourceAnalyser<float>, LfoBank::numLfos> analysers;
+    AudioBuffer<float> analyserBlock {static_cast<int>(LfoBank::numLfos), LFO_ANALYSER_BLOCK};
+    int analyserPosition     = 0;
+    int samplesSinceAnalysis = 0;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulationSourceProcessor)
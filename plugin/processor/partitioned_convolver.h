@@ -0,0 +1,268 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "triple_buffer.h"
+
+namespace tobanteAudio
+{
+/**
+ * @brief Uniformly partitioned overlap-save convolution of all channels with
+ * one kernel.
+ *
+ * @details The kernel is split into partitions of the same size as the input
+ * blocks. Their spectra are multiplied with a frequency domain delay line of
+ * the past input spectra, so the cost per sample no longer grows with the
+ * kernel length. The latency is one partition.
+ *
+ * A new kernel can be set from any thread but the audio thread. It is handed
+ * over wait-free & faded in over one partition.
+ */
+class PartitionedConvolver
+{
+public:
+    /**
+     * @brief Allocates all buffers. Must not run concurrently with setKernel.
+     * The partition size needs to be a power of two.
+     */
+    void prepare(int numChannels, int newPartitionSize, int maxKernelLength)
+    {
+        jassert(isPowerOfTwo(newPartitionSize));
+
+        partitionSize = newPartitionSize;
+        numBins       = partitionSize + 1;
+        numPartitions = jmax(1, (maxKernelLength + partitionSize - 1) / partitionSize);
+
+        const auto fftOrder = roundToInt(std::log2(2 * partitionSize));
+        fft                 = std::make_unique<dsp::FFT>(fftOrder);
+        kernelFft           = std::make_unique<dsp::FFT>(fftOrder);
+
+        const auto spectrumSize  = static_cast<size_t>(numBins * 2);
+        const auto spectraSize   = spectrumSize * static_cast<size_t>(numPartitions);
+        const auto fftBufferSize = static_cast<size_t>(partitionSize * 4);
+
+        spectra.assign(spectraSize, 0.0f);
+        kernels.reset(spectra);
+        fading = false;
+
+        fftBuffer.assign(fftBufferSize, 0.0f);
+        kernelBuffer.assign(fftBufferSize, 0.0f);
+        accumulator.assign(spectrumSize, 0.0f);
+        fadeAccumulator.assign(spectrumSize, 0.0f);
+        fadeOutput.assign(static_cast<size_t>(partitionSize), 0.0f);
+
+        channels.resize(static_cast<size_t>(numChannels));
+        for (auto& channel : channels)
+        {
+            channel.input.assign(static_cast<size_t>(partitionSize * 2), 0.0f);
+            channel.output.assign(static_cast<size_t>(partitionSize), 0.0f);
+            channel.delayLine.assign(spectraSize, 0.0f);
+        }
+
+        reset();
+    }
+
+    /**
+     * @brief Clears the input history & pending output. Keeps the kernel.
+     */
+    void reset() noexcept
+    {
+        for (auto& channel : channels)
+        {
+            std::fill(channel.input.begin(), channel.input.end(), 0.0f);
+            std::fill(channel.output.begin(), channel.output.end(), 0.0f);
+            std::fill(channel.delayLine.begin(), channel.delayLine.end(), 0.0f);
+        }
+
+        position          = 0;
+        delayLinePosition = 0;
+    }
+
+    /**
+     * @brief Transforms the kernel into partition spectra & hands them to the
+     * audio thread. Calls need to be serialised by the caller.
+     */
+    void setKernel(const float* kernel, int length)
+    {
+        jassert(length <= numPartitions * partitionSize);
+
+        auto& target            = kernels.getWriteBuffer();
+        const auto spectrumSize = static_cast<size_t>(numBins * 2);
+        for (int partition = 0; partition < numPartitions; ++partition)
+        {
+            std::fill(kernelBuffer.begin(), kernelBuffer.end(), 0.0f);
+
+            const auto start      = partition * partitionSize;
+            const auto numSamples = jlimit(0, partitionSize, length - start);
+            if (numSamples > 0) { std::copy(kernel + start, kernel + start + numSamples, kernelBuffer.begin()); }
+
+            kernelFft->performRealOnlyForwardTransform(kernelBuffer.data(), true);
+            std::copy(kernelBuffer.begin(), kernelBuffer.begin() + static_cast<std::ptrdiff_t>(spectrumSize),
+                      target.begin() + static_cast<std::ptrdiff_t>(spectrumSize * static_cast<size_t>(partition)));
+        }
+
+        kernels.publish();
+    }
+
+    /**
+     * @brief Convolves all channels of the block in place.
+     */
+    void process(const dsp::ProcessContextReplacing<float>& context) noexcept
+    {
+        auto& block            = context.getOutputBlock();
+        const auto numChannels = jmin(block.getNumChannels(), channels.size());
+        const auto numSamples  = static_cast<int>(block.getNumSamples());
+        jassert(block.getNumChannels() <= channels.size());
+
+        for (int done = 0; done < numSamples;)
+        {
+            // Exchange samples with the current partition until it is full
+            const auto length = jmin(numSamples - done, partitionSize - position);
+            for (size_t channel = 0; channel < numChannels; ++channel)
+            {
+                auto* data   = block.getChannelPointer(channel) + done;
+                auto& buffer = channels[channel];
+                std::copy(data, data + length, buffer.input.begin() + partitionSize + position);
+                std::copy(buffer.output.begin() + position, buffer.output.begin() + position + length, data);
+            }
+
+            done += length;
+            position += length;
+            if (position == partitionSize)
+            {
+                processPartition(numChannels);
+                position = 0;
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the delay added by the input buffering.
+     */
+    int getLatencySamples() const noexcept { return partitionSize; }
+
+private:
+    struct Channel
+    {
+        // Previous & current input partition, overlap-save input of the FFT
+        std::vector<float> input;
+        std::vector<float> output;
+        std::vector<float> delayLine;
+    };
+
+    void processPartition(size_t numChannels) noexcept
+    {
+        // A fade lasts one partition, afterwards the new kernel is current
+        if (fading)
+        {
+            spectra = kernels.getReadBuffer();
+            fading  = false;
+        }
+        if (kernels.acquire()) { fading = true; }
+
+        const auto spectrumSize = static_cast<size_t>(numBins * 2);
+        delayLinePosition       = (delayLinePosition + 1) % numPartitions;
+
+        for (size_t index = 0; index < numChannels; ++index)
+        {
+            auto& channel = channels[index];
+
+            // Transform the last two partitions of input into the delay line
+            std::copy(channel.input.begin(), channel.input.end(), fftBuffer.begin());
+            std::fill(fftBuffer.begin() + partitionSize * 2, fftBuffer.end(), 0.0f);
+            fft->performRealOnlyForwardTransform(fftBuffer.data(), true);
+
+            auto* const slot = channel.delayLine.data() + spectrumSize * static_cast<size_t>(delayLinePosition);
+            std::copy(fftBuffer.begin(), fftBuffer.begin() + static_cast<std::ptrdiff_t>(spectrumSize), slot);
+            std::copy(channel.input.begin() + partitionSize, channel.input.end(), channel.input.begin());
+
+            convolve(channel, spectra.data(), accumulator);
+            transformBack(accumulator, channel.output.data());
+
+            if (fading)
+            {
+                convolve(channel, kernels.getReadBuffer().data(), fadeAccumulator);
+                transformBack(fadeAccumulator, fadeOutput.data());
+
+                const auto step = 1.0f / static_cast<float>(partitionSize);
+                for (int i = 0; i < partitionSize; ++i)
+                {
+                    const auto gain = (static_cast<float>(i) + 0.5f) * step;
+                    auto& sample    = channel.output[static_cast<size_t>(i)];
+                    sample          = sample + gain * (fadeOutput[static_cast<size_t>(i)] - sample);
+                }
+            }
+        }
+    }
+
+    void convolve(const Channel& channel, const float* kernelSpectra, std::vector<float>& result) const noexcept
+    {
+        const auto spectrumSize = static_cast<size_t>(numBins * 2);
+        std::fill(result.begin(), result.end(), 0.0f);
+
+        // Partition p of the kernel meets the input from p partitions ago
+        for (int partition = 0; partition < numPartitions; ++partition)
+        {
+            const auto slot = (delayLinePosition - partition + numPartitions) % numPartitions;
+            const auto* x   = channel.delayLine.data() + spectrumSize * static_cast<size_t>(slot);
+            const auto* h   = kernelSpectra + spectrumSize * static_cast<size_t>(partition);
+
+            for (size_t bin = 0; bin < spectrumSize; bin += 2)
+            {
+                result[bin] += x[bin] * h[bin] - x[bin + 1] * h[bin + 1];
+                result[bin + 1] += x[bin] * h[bin + 1] + x[bin + 1] * h[bin];
+            }
+        }
+    }
+
+    void transformBack(const std::vector<float>& spectrum, float* output) noexcept
+    {
+        // Only the second half is free of circular aliasing
+        std::copy(spectrum.begin(), spectrum.end(), fftBuffer.begin());
+        std::fill(fftBuffer.begin() + static_cast<std::ptrdiff_t>(spectrum.size()), fftBuffer.end(), 0.0f);
+        fft->performRealOnlyInverseTransform(fftBuffer.data());
+        std::copy(fftBuffer.begin() + partitionSize, fftBuffer.begin() + partitionSize * 2, output);
+    }
+
+    int partitionSize {0};
+    int numBins {0};
+    int numPartitions {0};
+    int position {0};
+    int delayLinePosition {0};
+    bool fading {false};
+
+    std::unique_ptr<dsp::FFT> fft;
+    std::unique_ptr<dsp::FFT> kernelFft;
+
+    // Kernel spectra, written by setKernel, read by the audio thread
+    tobanteAudio::TripleBuffer<std::vector<float>> kernels;
+    std::vector<float> kernelBuffer;
+
+    // Audio thread only
+    std::vector<float> spectra;
+    std::vector<float> fftBuffer;
+    std::vector<float> accumulator;
+    std::vector<float> fadeAccumulator;
+    std::vector<float> fadeOutput;
+    std::vector<Channel> channels;
+};
+
+}  // namespace tobanteAudio
@@ -0,0 +1,223 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "biquad_cascade.h"
+#include "magnitude_response.h"
+
+namespace tobanteAudio
+{
+/**
+ * @brief Computes the magnitude responses & plot paths of the bands on a
+ * background thread.
+ *
+ * @details The message thread copies the designed sections of every band
+ * into a request. The worker evaluates them on the response grid, multiplies
+ * the summed response & builds the paths. Finished curves are handed back by
+ * swapping buffers, so neither side allocates once the sizes have settled.
+ */
+class ResponseCurveWorker : public Thread
+{
+public:
+    using Coefficients = BiquadCoefficients<double>;
+
+    /**
+     * @brief Most sections of one curve, a 96 dB/oct slope.
+     */
+    static constexpr size_t maxSections = 8;
+
+    /**
+     * @brief Sections of one band & whether it is part of the summed response.
+     */
+    struct Curve
+    {
+        std::array<Coefficients, maxSections> sections {};
+        size_t numSections = 0;
+        bool summed        = false;
+    };
+
+    /**
+     * @brief Everything the curves are computed from.
+     */
+    struct Request
+    {
+        std::vector<double> frequencies;
+        double sampleRate = 0.0;
+        std::vector<Curve> curves;
+        Rectangle<int> bounds;
+        float pixelsPerDouble = 0.0f;
+    };
+
+    /**
+     * @brief Finished magnitudes & paths, one per curve plus the sum.
+     */
+    struct Result
+    {
+        std::vector<std::vector<double>> magnitudes;
+        std::vector<double> summedMagnitudes;
+        std::vector<Path> paths;
+        Path summedPath;
+    };
+
+    /**
+     * @brief Constructor.
+     */
+    ResponseCurveWorker() : Thread("ResponseCurveWorker") { }
+
+    /**
+     * @brief Destructor. Stops the thread.
+     */
+    ~ResponseCurveWorker() override { stopThread(1000); }
+
+    /**
+     * @brief Stores a new request, the curves are computed on the background
+     * thread. A request which wasn't picked up yet is replaced.
+     */
+    void requestUpdate(const Request& request)
+    {
+        {
+            const ScopedLock lock(requestLock);
+            requested  = request;
+            hasRequest = true;
+        }
+
+        notify();
+    }
+
+    /**
+     * @brief Computes the curves for the last request on the calling thread.
+     */
+    void updateNow()
+    {
+        const ScopedLock lock(workLock);
+
+        {
+            const ScopedLock requestScope(requestLock);
+            if (!hasRequest) { return; }
+            std::swap(work, requested);
+            hasRequest = false;
+        }
+
+        computeCurves(work, computed);
+
+        const ScopedLock resultScope(resultLock);
+        std::swap(finished, computed);
+        hasResult = true;
+    }
+
+    /**
+     * @brief Swaps the last finished curves into result. Returns false if no
+     * curves were finished since the last call.
+     */
+    bool getResult(Result& result)
+    {
+        const ScopedLock lock(resultLock);
+        if (!hasResult) { return false; }
+
+        std::swap(result, finished);
+        hasResult = false;
+        return true;
+    }
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            wait(-1);
+            if (threadShouldExit()) { return; }
+
+            updateNow();
+        }
+    }
+
+private:
+    void computeCurves(const Request& request, Result& result)
+    {
+        const auto numPoints = request.frequencies.size();
+        const auto isValid   = request.sampleRate > 0.0 && numPoints > 1;
+        if (isValid && (response.getSampleRate() != request.sampleRate || response.size() != numPoints))
+        { response.prepare(request.frequencies, request.sampleRate); }
+
+        result.magnitudes.resize(request.curves.size());
+        result.paths.resize(request.curves.size());
+        result.summedMagnitudes.assign(numPoints, 1.0);
+        for (size_t i = 0; i < request.curves.size(); ++i)
+        {
+            const auto& curve = request.curves[i];
+            auto& magnitudes  = result.magnitudes[i];
+            magnitudes.resize(numPoints);
+            if (isValid) { response.process(curve.sections.data(), curve.numSections, magnitudes.data()); }
+            else
+            {
+                std::fill(magnitudes.begin(), magnitudes.end(), 1.0);
+            }
+
+            if (curve.summed)
+            {
+                FloatVectorOperations::multiply(result.summedMagnitudes.data(), magnitudes.data(),
+                                                static_cast<int>(numPoints));
+            }
+            createPath(result.paths[i], magnitudes, request.bounds, request.pixelsPerDouble);
+        }
+
+        createPath(result.summedPath, result.summedMagnitudes, request.bounds, request.pixelsPerDouble);
+    }
+
+    static void createPath(Path& path, const std::vector<double>& magnitudes, Rectangle<int> bounds,
+                           float pixelsPerDouble)
+    {
+        path.clear();
+        if (bounds.isEmpty() || magnitudes.size() < 2) { return; }
+
+        // Zeros of the response are drawn at -120 dB instead of infinity
+        const auto xFactor = static_cast<double>(bounds.getWidth()) / (magnitudes.size() - 1);
+        const auto centreY = static_cast<double>(bounds.getCentreY());
+        for (size_t i = 0; i < magnitudes.size(); ++i)
+        {
+            const auto x = static_cast<float>(roundToInt(bounds.getX() + i * xFactor));
+            const auto y = static_cast<float>(
+                roundToInt(centreY - pixelsPerDouble * std::log2(jmax(magnitudes[i], 1.0e-6))));
+
+            if (i == 0) { path.startNewSubPath(x, y); }
+            else
+            {
+                path.lineTo(x, y);
+            }
+        }
+    }
+
+    CriticalSection requestLock;
+    Request requested;
+    bool hasRequest {false};
+
+    // Guarded by workLock
+    CriticalSection workLock;
+    Request work;
+    Result computed;
+    MagnitudeResponse response;
+
+    CriticalSection resultLock;
+    Result finished;
+    bool hasResult {false};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ResponseCurveWorker)
+};
+}  // namespace tobanteAudio
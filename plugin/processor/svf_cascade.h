@@ -0,0 +1,404 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "channel_routing.h"
+#include "fast_math.h"
+#include "svf_designer.h"
+
+namespace tobanteAudio
+{
+/**
+ * @brief Cascade of state variable filter sections, processed for all
+ * channels in a single pass. Same interface as BiquadCascade.
+ *
+ * @details Each SIMD lane holds one channel. Unlike the direct form biquads
+ * the sections can be modulated at audio rate: process() optionally takes one
+ * buffer of cutoff ratios per section, the cutoff is then prewarped with
+ * fastTan for every sample. Lanes of channels a section isn't routed to only
+ * mix in the input. Bypassed & identity sections are skipped by the kernel.
+ */
+template <typename SampleType, size_t MaxSections> class SvfCascade
+{
+public:
+    using Vec = dsp::SIMDRegister<SampleType>;
+
+    /**
+     * @brief Number of channels processed by one pass of the kernel.
+     */
+    static constexpr size_t lanes = Vec::SIMDNumElements;
+
+    using Coefficients = SvfCoefficients<SampleType>;
+
+    /**
+     * @brief Constructor. All sections start as identity, routed to all
+     * channels.
+     */
+    SvfCascade()
+    {
+        skipped.fill(true);
+        for (size_t section = 0; section < MaxSections; ++section) { updateKernelCoefficients(section); }
+    }
+
+    /**
+     * @brief Allocates the filter state for the channel count in spec.
+     */
+    void prepare(const dsp::ProcessSpec& spec)
+    {
+        numGroups = (static_cast<size_t>(spec.numChannels) + lanes - 1) / lanes;
+        state1.resize(numGroups * MaxSections);
+        state2.resize(numGroups * MaxSections);
+        for (auto* registers : {&m0, &m1, &m2}) { registers->resize(numGroups * MaxSections); }
+        for (size_t section = 0; section < MaxSections; ++section) { updateKernelCoefficients(section); }
+        reset();
+    }
+
+    /**
+     * @brief Clears the filter state of all sections.
+     */
+    void reset() noexcept
+    {
+        std::fill(state1.begin(), state1.end(), Vec::expand(SampleType {0}));
+        std::fill(state2.begin(), state2.end(), Vec::expand(SampleType {0}));
+    }
+
+    /**
+     * @brief Clears the filter state of a single section.
+     */
+    void resetSection(size_t section) noexcept
+    {
+        jassert(section < MaxSections);
+        for (size_t group = 0; group < numGroups; ++group)
+        {
+            state1[group * MaxSections + section] = Vec::expand(SampleType {0});
+            state2[group * MaxSections + section] = Vec::expand(SampleType {0});
+        }
+    }
+
+    /**
+     * @brief Sets the coefficients of a section.
+     */
+    void setCoefficients(size_t section, const Coefficients& c) noexcept
+    {
+        jassert(section < MaxSections);
+        coefficients[section] = c;
+        updateKernelCoefficients(section);
+    }
+
+    /**
+     * @brief Sets the coefficients of a section from coefficients of another
+     * precision.
+     */
+    template <typename OtherType>
+    void setCoefficients(size_t section, const SvfCoefficients<OtherType>& c) noexcept
+    {
+        setCoefficients(section, Coefficients {static_cast<SampleType>(c.omega), static_cast<SampleType>(c.gScale),
+                                               static_cast<SampleType>(c.k), static_cast<SampleType>(c.m0),
+                                               static_cast<SampleType>(c.m1), static_cast<SampleType>(c.m2)});
+    }
+
+    /**
+     * @brief Returns the coefficients of a section.
+     */
+    const Coefficients& getCoefficients(size_t section) const noexcept { return coefficients[section]; }
+
+    /**
+     * @brief A bypassed section passes its input through unchanged. The
+     * sections state is cleared, so it starts from silence once re-enabled.
+     */
+    void setBypassed(size_t section, bool shouldBeBypassed) noexcept
+    {
+        jassert(section < MaxSections);
+        if (bypassed[section] == shouldBeBypassed) { return; }
+
+        bypassed[section] = shouldBeBypassed;
+        updateKernelCoefficients(section);
+        resetSection(section);
+    }
+
+    /**
+     * @brief Returns true if the section is bypassed.
+     */
+    bool isBypassed(size_t section) const noexcept { return bypassed[section]; }
+
+    /**
+     * @brief Sets the channels a section filters. The sections state is
+     * cleared.
+     */
+    void setRouting(size_t section, ChannelRouting newRouting) noexcept
+    {
+        jassert(section < MaxSections);
+        if (routing[section] == newRouting) { return; }
+
+        routing[section] = newRouting;
+        updateKernelCoefficients(section);
+        resetSection(section);
+        order.update(routing, skipped);
+    }
+
+    /**
+     * @brief Returns the channels a section filters.
+     */
+    ChannelRouting getRouting(size_t section) const noexcept { return routing[section]; }
+
+    /**
+     * @brief Sets the number of sections which are processed. Sections at or
+     * above this index are skipped by the kernel. Newly enabled sections start
+     * from silence.
+     */
+    void setNumActiveSections(size_t newNumActiveSections) noexcept
+    {
+        std::array<size_t, MaxSections> indices {};
+        for (size_t section = 0; section < MaxSections; ++section) { indices[section] = section; }
+        setSequence(indices, newNumActiveSections);
+    }
+
+    /**
+     * @brief Sets the sections which are processed & the order they run in.
+     * Sections missing from the sequence are skipped by the kernel, sections
+     * which join it start from silence.
+     */
+    void setSequence(const std::array<size_t, MaxSections>& sequence, size_t length) noexcept
+    {
+        length = jmin(length, MaxSections);
+        for (size_t position = 0; position < length; ++position)
+        {
+            if (!order.isInSequence(sequence[position])) { resetSection(sequence[position]); }
+        }
+
+        order.setSequence(sequence, length);
+        order.update(routing, skipped);
+    }
+
+    /**
+     * @brief Returns the number of sections in the sequence, including the
+     * skipped ones.
+     */
+    size_t getNumActiveSections() const noexcept { return order.getSequenceLength(); }
+
+    /**
+     * @brief Returns the number of sections the kernel runs, the active
+     * sections which are neither bypassed nor identity.
+     */
+    size_t getNumProcessedSections() const noexcept { return order.size(); }
+
+    /**
+     * @brief Processes all channels of the block in place.
+     *
+     * @param frequencyRatios Optional, one pointer per section. A section
+     * with a non-null pointer has its cutoff multiplied by the ratio for
+     * every sample of the block.
+     */
+    void process(const dsp::ProcessContextReplacing<SampleType>& context,
+                 const SampleType* const* frequencyRatios = nullptr) noexcept
+    {
+        if (context.isBypassed || order.size() == 0) { return; }
+
+        auto& block            = context.getOutputBlock();
+        const auto numChannels = block.getNumChannels();
+        const auto numSamples  = block.getNumSamples();
+        jassert((numChannels + lanes - 1) / lanes <= numGroups);
+
+        // Kernel specialised for the number of processed sections.
+        const auto kernel = kernels[order.size()];
+
+        for (size_t group = 0; group * lanes < numChannels; ++group)
+        {
+            const auto firstChannel = group * lanes;
+            const auto numLanes     = jmin(lanes, numChannels - firstChannel);
+
+            std::array<SampleType*, lanes> channels {};
+            for (size_t lane = 0; lane < numLanes; ++lane)
+            { channels[lane] = block.getChannelPointer(firstChannel + lane); }
+
+            (this->*kernel)(channels.data(), numLanes, numSamples, frequencyRatios, group);
+        }
+    }
+
+private:
+    using Kernel = void (SvfCascade::*)(SampleType* const*, size_t, size_t, const SampleType* const*,
+                                        size_t) noexcept;
+
+    /**
+     * @brief Integrator gains of a section for the prewarped cutoff g.
+     */
+    struct Gains
+    {
+        SampleType a1, a2, a3;
+    };
+
+    static Gains makeGains(SampleType g, SampleType k) noexcept
+    {
+        const auto a1 = SampleType {1} / (SampleType {1} + g * (g + k));
+        const auto a2 = g * a1;
+        return {a1, a2, g * a2};
+    }
+
+    static SampleType prewarp(SampleType omega) noexcept
+    {
+        // Keeps the cutoff below Nyquist, where tan has its pole
+        constexpr auto maxOmega = MathConstants<SampleType>::halfPi * SampleType(0.995);
+        return fastTan(jlimit(SampleType(1.0e-6), maxOmega, omega));
+    }
+
+    void updateKernelCoefficients(size_t section) noexcept
+    {
+        const auto c     = bypassed[section] ? Coefficients {} : coefficients[section];
+        const auto gains = makeGains(prewarp(c.omega) * c.gScale, c.k);
+        a1[section]      = Vec::expand(gains.a1);
+        a2[section]      = Vec::expand(gains.a2);
+        a3[section]      = Vec::expand(gains.a3);
+
+        // Lanes the section isn't routed to pass the input through
+        for (size_t group = 0; group < numGroups; ++group)
+        {
+            const auto index = group * MaxSections + section;
+            for (size_t lane = 0; lane < lanes; ++lane)
+            {
+                const auto isRouted = isRoutedTo(routing[section], group * lanes + lane);
+                m0[index].set(lane, isRouted ? c.m0 : SampleType {1});
+                m1[index].set(lane, isRouted ? c.m1 : SampleType {0});
+                m2[index].set(lane, isRouted ? c.m2 : SampleType {0});
+            }
+        }
+
+        // Sections start from silence once they filter again
+        const auto shouldSkip = bypassed[section] || (c.m0 == SampleType {1} && c.m1 == SampleType {0}
+                                                      && c.m2 == SampleType {0});
+        if (shouldSkip == skipped[section]) { return; }
+
+        skipped[section] = shouldSkip;
+        if (!shouldSkip) { resetSection(section); }
+        order.update(routing, skipped);
+    }
+
+    template <size_t NumSections>
+    void processGroup(SampleType* const* channels, size_t numLanes, size_t numSamples,
+                      const SampleType* const* frequencyRatios, size_t group) noexcept
+    {
+        auto* s1        = &state1[group * MaxSections];
+        auto* s2        = &state2[group * MaxSections];
+        const auto* cm0 = &m0[group * MaxSections];
+        const auto* cm1 = &m1[group * MaxSections];
+        const auto* cm2 = &m2[group * MaxSections];
+
+        // Only the first two channels are encoded to mid/side
+        const auto midSide = group == 0 && numLanes >= 2;
+        std::array<MidSideTransition, NumSections + 1> transitions {};
+        for (size_t position = 0; midSide && position < NumSections; ++position)
+        { transitions[position] = order.getTransition(position); }
+        const auto decodeAtEnd = midSide && order.isMidSideAtEnd();
+
+        // Work on local copies of the state of the processed sections, so it
+        // can stay in registers.
+        std::array<Vec, NumSections + 1> ic1;
+        std::array<Vec, NumSections + 1> ic2;
+        for (size_t position = 0; position < NumSections; ++position)
+        {
+            ic1[position] = s1[order[position]];
+            ic2[position] = s2[order[position]];
+        }
+
+        // Modulated sections get new integrator gains for every sample
+        std::array<const SampleType*, NumSections + 1> ratios {};
+        if (frequencyRatios != nullptr)
+        {
+            for (size_t position = 0; position < NumSections; ++position)
+            { ratios[position] = frequencyRatios[order[position]]; }
+        }
+
+        alignas(Vec::SIMDRegisterSize) std::array<SampleType, lanes> frame {};
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            for (size_t lane = 0; lane < numLanes; ++lane) { frame[lane] = channels[lane][i]; }
+            auto x = Vec::fromRawArray(frame.data());
+
+            for (size_t position = 0; position < NumSections; ++position)
+            {
+                if (transitions[position] != MidSideTransition::None)
+                {
+                    x.copyToRawArray(frame.data());
+                    applyMidSideTransition(transitions[position], frame.data());
+                    x = Vec::fromRawArray(frame.data());
+                }
+
+                const auto section = order[position];
+                auto g1            = a1[section];
+                auto g2            = a2[section];
+                auto g3            = a3[section];
+                if (ratios[position] != nullptr)
+                {
+                    const auto& c    = coefficients[section];
+                    const auto gains = makeGains(prewarp(c.omega * ratios[position][i]) * c.gScale, c.k);
+                    g1               = Vec::expand(gains.a1);
+                    g2               = Vec::expand(gains.a2);
+                    g3               = Vec::expand(gains.a3);
+                }
+
+                const auto v3 = x - ic2[position];
+                const auto v1 = g1 * ic1[position] + g2 * v3;
+                const auto v2 = ic2[position] + g2 * ic1[position] + g3 * v3;
+                ic1[position] = v1 * SampleType {2} - ic1[position];
+                ic2[position] = v2 * SampleType {2} - ic2[position];
+                x             = cm0[section] * x + cm1[section] * v1 + cm2[section] * v2;
+            }
+
+            x.copyToRawArray(frame.data());
+            if (decodeAtEnd) { decodeMidSide(frame.data()); }
+            for (size_t lane = 0; lane < numLanes; ++lane) { channels[lane][i] = frame[lane]; }
+        }
+
+        for (size_t position = 0; position < NumSections; ++position)
+        {
+            s1[order[position]] = ic1[position];
+            s2[order[position]] = ic2[position];
+        }
+    }
+
+    template <size_t... NumSections>
+    static constexpr std::array<Kernel, sizeof...(NumSections)> makeKernels(std::index_sequence<NumSections...>)
+    {
+        return {{&SvfCascade::processGroup<NumSections>...}};
+    }
+
+    static constexpr auto kernels = makeKernels(std::make_index_sequence<MaxSections + 1> {});
+
+    std::array<Coefficients, MaxSections> coefficients {};
+    std::array<bool, MaxSections> bypassed {};
+    std::array<bool, MaxSections> skipped {};
+    std::array<ChannelRouting, MaxSections> routing {};
+    SectionOrder<MaxSections> order;
+
+    // Integrator gains broadcast to every lane, one register per section.
+    std::array<Vec, MaxSections> a1 {}, a2 {}, a3 {};
+
+    // Mixing gains per lane, MaxSections registers per channel group.
+    std::vector<Vec> m0, m1, m2;
+
+    // Integrator state, MaxSections registers per channel group.
+    std::vector<Vec> state1;
+    std::vector<Vec> state2;
+    size_t numGroups {0};
+};
+
+}  // namespace tobanteAudio
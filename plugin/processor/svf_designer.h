@@ -0,0 +1,132 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "fast_math.h"
+
+namespace tobanteAudio
+{
+/**
+ * @brief Parameters of one state variable filter section.
+ *
+ * @details The cutoff is stored as the normalised angle pi * f / fs, so it can
+ * be modulated before the prewarping. The output is the mix m0 * input +
+ * m1 * band + m2 * low.
+ */
+template <typename SampleType> struct SvfCoefficients
+{
+    SampleType omega {0};
+    SampleType gScale {1};
+    SampleType k {1};
+    SampleType m0 {1};
+    SampleType m1 {0};
+    SampleType m2 {0};
+};
+
+/**
+ * @brief Computes state variable filter sections with the same responses as
+ * BiquadDesigner.
+ *
+ * @details Topology-preserving transform (trapezoidal) SVF after A. Simper,
+ * "Linear Trapezoidal Integrated SVF". The states are the integrator
+ * memories, so the filter stays well behaved when the cutoff changes every
+ * sample.
+ */
+template <typename SampleType> struct SvfDesigner
+{
+    using Coefficients = SvfCoefficients<SampleType>;
+
+    /**
+     * @brief Returns a section which passes the signal through unchanged.
+     */
+    static Coefficients makeIdentity() noexcept { return {}; }
+
+    /**
+     * @brief Second order low-pass.
+     */
+    static Coefficients makeLowPass(double sampleRate, double frequency, double Q) noexcept
+    {
+        return make(sampleRate, frequency, 1.0, 1.0 / Q, 0.0, 0.0, 1.0);
+    }
+
+    /**
+     * @brief Second order high-pass.
+     */
+    static Coefficients makeHighPass(double sampleRate, double frequency, double Q) noexcept
+    {
+        return make(sampleRate, frequency, 1.0, 1.0 / Q, 1.0, -1.0 / Q, -1.0);
+    }
+
+    /**
+     * @brief Second order band-pass with 0 dB peak gain.
+     */
+    static Coefficients makeBandPass(double sampleRate, double frequency, double Q) noexcept
+    {
+        return make(sampleRate, frequency, 1.0, 1.0 / Q, 0.0, 1.0 / Q, 0.0);
+    }
+
+    /**
+     * @brief Second order low-shelf. Gain is a linear factor.
+     */
+    static Coefficients makeLowShelf(double sampleRate, double frequency, double Q, double gainFactor) noexcept
+    {
+        const auto A = jmax(1.0e-6, std::sqrt(gainFactor));
+        const auto k = 1.0 / Q;
+        return make(sampleRate, jmax(frequency, 2.0), 1.0 / std::sqrt(A), k, 1.0, k * (A - 1.0), A * A - 1.0);
+    }
+
+    /**
+     * @brief Second order high-shelf. Gain is a linear factor.
+     */
+    static Coefficients makeHighShelf(double sampleRate, double frequency, double Q, double gainFactor) noexcept
+    {
+        const auto A = jmax(1.0e-6, std::sqrt(gainFactor));
+        const auto k = 1.0 / Q;
+        return make(sampleRate, jmax(frequency, 2.0), std::sqrt(A), k, A * A, k * (1.0 - A) * A, 1.0 - A * A);
+    }
+
+    /**
+     * @brief Second order peak (bell). Gain is a linear factor.
+     */
+    static Coefficients makePeakFilter(double sampleRate, double frequency, double Q, double gainFactor) noexcept
+    {
+        const auto A = jmax(1.0e-6, std::sqrt(gainFactor));
+        const auto k = 1.0 / (Q * A);
+        return make(sampleRate, jmax(frequency, 2.0), 1.0, k, 1.0, k * (A * A - 1.0), 0.0);
+    }
+
+private:
+    static Coefficients make(double sampleRate, double frequency, double gScale, double k, double m0, double m1,
+                             double m2) noexcept
+    {
+        auto c   = Coefficients {};
+        c.omega  = static_cast<SampleType>(MathConstants<double>::pi * frequency / sampleRate);
+        c.gScale = static_cast<SampleType>(gScale);
+        c.k      = static_cast<SampleType>(k);
+        c.m0     = static_cast<SampleType>(m0);
+        c.m1     = static_cast<SampleType>(m1);
+        c.m2     = static_cast<SampleType>(m2);
+        return c;
+    }
+};
+
+}  // namespace tobanteAudio
@@ -0,0 +1,87 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+namespace tobanteAudio
+{
+/**
+ * @brief Wait-free handoff of a value from one writer to one reader thread.
+ *
+ * @details The writer fills the write buffer & publishes it, the reader picks
+ * up the most recently published value with acquire(). Both sides only swap
+ * an atomic index, neither of them ever blocks. Values published while the
+ * reader is busy replace each other, the reader always sees the latest one.
+ */
+template <typename T> class TripleBuffer
+{
+public:
+    /**
+     * @brief Returns the buffer owned by the writer.
+     */
+    T& getWriteBuffer() noexcept { return buffers[writeIndex]; }
+
+    /**
+     * @brief Hands the write buffer over to the reader.
+     */
+    void publish() noexcept
+    {
+        const auto previous = shared.exchange(static_cast<uint8>(writeIndex | newDataFlag), std::memory_order_acq_rel);
+        writeIndex          = static_cast<uint8>(previous & indexMask);
+    }
+
+    /**
+     * @brief Makes the most recently published value the read buffer. Returns
+     * false if nothing new was published since the last call.
+     */
+    bool acquire() noexcept
+    {
+        if ((shared.load(std::memory_order_acquire) & newDataFlag) == 0) { return false; }
+
+        const auto previous = shared.exchange(static_cast<uint8>(readIndex), std::memory_order_acq_rel);
+        readIndex           = static_cast<uint8>(previous & indexMask);
+        return true;
+    }
+
+    /**
+     * @brief Returns the buffer owned by the reader.
+     */
+    const T& getReadBuffer() const noexcept { return buffers[readIndex]; }
+
+    /**
+     * @brief Sets all three buffers to the value & drops unread data. Must not
+     * run concurrently with the writer or the reader.
+     */
+    void reset(const T& value)
+    {
+        for (auto& buffer : buffers) { buffer = value; }
+        shared.store(static_cast<uint8>(shared.load() & indexMask));
+    }
+
+private:
+    static constexpr uint8 indexMask   = 0x3;
+    static constexpr uint8 newDataFlag = 0x4;
+
+    std::array<T, 3> buffers {};
+    uint8 writeIndex {0};
+    uint8 readIndex {2};
+    std::atomic<uint8> shared {1};
+};
+
+}  // namespace tobanteAudio
@@ -40,6 +40,98 @@ constexpr auto FILTER_Q_MIN          = 0.1f;
 constexpr auto FILTER_Q_MAX          = 10.0f;
 constexpr auto FILTER_Q_STEP_SIZE    = 0.1f;
 
+/**
+ * @brief Ramp time for frequency, quality & gain changes.
+ */
+constexpr auto FILTER_SMOOTHING_SECONDS = 0.05;
+/**
+ * @brief Default number of samples between two coefficient updates while
+ * parameters are ramping.
+ */
+constexpr auto FILTER_CONTROL_INTERVAL = 32;
+/**
+ * @brief Upper limit for the number of bands.
+ */
+constexpr auto FILTER_MAX_BANDS = 32;
+/**
+ * @brief Number of bands in a new instance.
+ */
+constexpr auto FILTER_DEFAULT_NUM_BANDS = 6;
+/**
+ * @brief Sections shared by the high & low-passes steeper than 12 dB/oct,
+ * enough for four 96 dB/oct bands. Slopes which don't fit are lowered.
+ */
+constexpr auto FILTER_MAX_SLOPE_SECTIONS = 28;
+
+// Dynamic bands
+constexpr auto DYNAMIC_THRESHOLD_MIN = -60.0f;
+constexpr auto DYNAMIC_THRESHOLD_MAX = 0.0f;
+constexpr auto DYNAMIC_RATIO_MIN     = 1.0f;
+constexpr auto DYNAMIC_RATIO_MAX     = 20.0f;
+constexpr auto DYNAMIC_ATTACK_MIN    = 0.1f;
+constexpr auto DYNAMIC_ATTACK_MAX    = 200.0f;
+constexpr auto DYNAMIC_RELEASE_MIN   = 5.0f;
+constexpr auto DYNAMIC_RELEASE_MAX   = 2000.0f;
+
+// Oversampling
+/**
+ * @brief Highest oversampling order, 2^3 = 8x.
+ */
+constexpr auto OVERSAMPLING_MAX_ORDER = 3;
+
+// Linear phase
+/**
+ * @brief FFT size the linear-phase kernel is designed with. The kernel has one
+ * tap less & half of that as delay.
+ */
+constexpr auto LINEAR_PHASE_FFT_SIZE = 8192;
+/**
+ * @brief Partition size of the linear-phase convolution, adds the same
+ * latency.
+ */
+constexpr auto LINEAR_PHASE_PARTITION_SIZE = 256;
+
+// Silence
+/**
+ * @brief Level below which the decaying filter tails count as silent, the
+ * input has to be digital silence.
+ */
+constexpr auto SILENCE_THRESHOLD_DB = -120.0;
+/**
+ * @brief SILENCE_THRESHOLD_DB as a linear level.
+ */
+constexpr auto SILENCE_THRESHOLD_LEVEL = 1.0e-6;
+/**
+ * @brief Longest tail of a band, bounds poles close to the unit circle.
+ */
+constexpr auto SILENCE_MAX_TAIL_SECONDS = 10.0;
+/**
+ * @brief Cache budget of one sub-block in the fused pipeline, half of a
+ * typical L1 data cache.
+ */
+constexpr auto PIPELINE_CACHE_BYTES = 16 * 1024;
+
+// Modulation
+/**
+ * @brief Sources the modulation matrix can route, one per LFO.
+ */
+constexpr auto MODULATION_MAX_SOURCES = 8;
+/**
+ * @brief Connections the matrix evaluates, empty cells of the matrix cost
+ * nothing.
+ */
+constexpr auto MODULATION_MAX_CONNECTIONS = 64;
+/**
+ * @brief Default number of samples between two evaluations of the matrix.
+ */
+constexpr auto MODULATION_CONTROL_INTERVAL = 64;
+/**
+ * @brief Range of a connection at full depth & a source at full scale.
+ */
+constexpr auto MODULATION_FREQUENCY_OCTAVES = 2.0f;
+constexpr auto MODULATION_QUALITY_OCTAVES   = 2.0f;
+constexpr auto MODULATION_GAIN_DB           = MAX_DB;
+
 // LFO
 constexpr auto LFO_GAIN_MAX       = 1.0f;
 constexpr auto LFO_FREQ_MIN       = 0.01f;
@@ -47,6 +139,18 @@ constexpr auto LFO_FREQ_MAX       = 10.0f;
 constexpr auto LFO_FREQ_STEP_SIZE = 0.01f;
 constexpr auto LFO_FREQ_SKEW      = 1.0f;
 constexpr auto LFO_FREQ_DEFAULT   = 0.3f;
+/**
+ * @brief LFOs of the bank, each one is a source of the modulation matrix.
+ */
+constexpr auto LFO_NUM_SOURCES = 4;
+/**
+ * @brief Points per period of the LFO wavetables.
+ */
+constexpr auto LFO_TABLE_SIZE = 1024;
+/**
+ * @brief Control rate values collected before they are handed to the plots.
+ */
+constexpr auto LFO_ANALYSER_BLOCK = 32;
 
 // UI
 /**
@@ -57,5 +161,23 @@ const int GLOBAL_REFRESH_RATE_HZ = 60;
  * @brief Click radius for band handles in analyser plot.
  */
 const int HANDLE_CLICK_RADIUS = 10;
+/**
+ * @brief Number of blocks the level meter averages the RMS over.
+ */
+const int METER_RMS_WINDOW = 8;
+/**
+ * @brief Points of the response grid before a plot sets its width.
+ */
+const int RESPONSE_DEFAULT_POINTS = 300;
+/**
+ * @brief Pixels of the analyser plot per point of the response grid.
+ */
+const int RESPONSE_PIXELS_PER_POINT = 2;
+/**
+ * @brief Bounds of the response grid. The lower one keeps narrow bands
+ * resolved for the linear-phase kernel, which is designed from the grid.
+ */
+const int RESPONSE_MIN_POINTS = 256;
+const int RESPONSE_MAX_POINTS = 2048;
 
 }  // namespace tobanteAudio
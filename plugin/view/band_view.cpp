@@ -39,8 +39,28 @@ BandView::BandView(int const i, const Colour c)
         type.addItem(type_string, j + 1);
     }
 
+    // Add all slopes to combo box
+    slope.clear();
+    for (int j = 0; j < tobanteAudio::EqualizerProcessor::LastSlopeID; ++j)
+    {
+        using EQ                = tobanteAudio::EqualizerProcessor;
+        auto const slope_string = EQ::getFilterSlopeName(static_cast<EQ::FilterSlope>(j));
+        slope.addItem(slope_string, j + 1);
+    }
+
+    // Add all channel routings to combo box
+    routing.clear();
+    for (int j = 0; j <= static_cast<int>(tobanteAudio::ChannelRouting::Side); ++j)
+    {
+        using EQ                  = tobanteAudio::EqualizerProcessor;
+        auto const routing_string = EQ::getChannelRoutingName(static_cast<tobanteAudio::ChannelRouting>(j));
+        routing.addItem(routing_string, j + 1);
+    }
+
     // Make controls visible
     addAndMakeVisible(type);
+    addAndMakeVisible(slope);
+    addAndMakeVisible(routing);
     addAndMakeVisible(gain);
     addAndMakeVisible(quality);
     addAndMakeVisible(frequency);
@@ -56,6 +76,8 @@ BandView::BandView(int const i, const Colour c)
     frequency.setTooltip(translate("Filter's frequency"));
     quality.setTooltip(translate("Filter's steepness (Quality)"));
     gain.setTooltip(translate("Filter's gain"));
+    slope.setTooltip(translate("Slope of the high & low-pass filters"));
+    routing.setTooltip(translate("Channels this filter is applied to"));
 
     // Solo
     solo.setClickingTogglesState(true);
@@ -88,6 +110,12 @@ void BandView::resized()
     // TYPE
     type.setBounds(bounds.removeFromTop(type_height));
 
+    // SLOPE
+    slope.setBounds(bounds.removeFromTop(type_height));
+
+    // ROUTING
+    routing.setBounds(bounds.removeFromTop(type_height));
+
     // FREQUENCY
     auto freq_bounds = bounds.removeFromBottom(bounds.getHeight() / 2);
     frequency.setBounds(freq_bounds);
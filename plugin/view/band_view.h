@@ -37,6 +37,8 @@ public:
     void resized() override;
 
     ComboBox type;
+    ComboBox slope;
+    ComboBox routing;
     Slider frequency;
     Slider quality;
     Slider gain;
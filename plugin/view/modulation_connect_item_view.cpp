@@ -23,15 +23,17 @@ ModulationConnectItemView::ModulationConnectItemView(int i)
     : index(i), active(translate("A")), amount(Slider::LinearHorizontal, Slider::NoTextBox)
 {
     // Toogle Button
+    active.setClickingTogglesState(true);
+    active.setToggleState(true, NotificationType::dontSendNotification);
     addAndMakeVisible(active);
 
     // Slider
     amount.setRange(-1.0, 1.0, 0.0);
     addAndMakeVisible(amount);
 
-    // Label
+    // Target, filled by the controller
     target.setJustificationType(Justification::centred);
-    target.setText("Target: " + String(index), NotificationType::dontSendNotification);
+    target.setTextWhenNothingSelected("Target: " + String(index));
     addAndMakeVisible(target);
 }
 
@@ -42,8 +44,8 @@ void ModulationConnectItemView::resized()
 
     // Button
     active.setBounds(area.removeFromRight(area.getWidth() / 6).reduced(0, 5));
-    // Labels
-    target.setBounds(area);
+    // Target
+    target.setBounds(area.reduced(0, 5));
 
     // Sliders
     amount.setBounds(sliderArea);
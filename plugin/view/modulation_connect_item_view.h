@@ -35,7 +35,7 @@ public:
 
     TextButton active;
     Slider amount;
-    Label target;
+    ComboBox target;
 
 #if TOBANTEAUDIO_LIVE_MOCK
 public:
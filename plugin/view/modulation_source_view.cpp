@@ -36,6 +36,10 @@ ModulationSourceView::ModulationSourceView(int i)
     addAndMakeVisible(freqLabel);
     addAndMakeVisible(gainLabel);
 
+    // Shape, same order as the parameter choices
+    shape.addItemList(ModulationSourceProcessor::getShapeNames(), 1);
+    addAndMakeVisible(shape);
+
     // Button
     addAndMakeVisible(toggleConnectView);
 
@@ -81,7 +85,7 @@ void ModulationSourceView::paint(Graphics& g)
     // Label
     g.setFont(16.0f);
     g.setColour(Colour(0xff00ff08));
-    g.drawFittedText("LFO", plotFrame.reduced(12), Justification::topRight, 1);
+    g.drawFittedText("LFO " + String(index), plotFrame.reduced(12), Justification::topRight, 1);
 
     // LFO path
     g.setColour(Colour(0xff00ff08).withMultipliedAlpha(0.9f).brighter());
@@ -106,6 +110,7 @@ void ModulationSourceView::resized()
     // Button
     auto button_area = area.removeFromBottom(area.getHeight() / 6).reduced(1);
     toggleConnectView.setBounds(button_area.removeFromLeft(button_area.getWidth() / 2));
+    shape.setBounds(button_area);
 
     // LFO plot
     auto reduced_area = area.reduced(3, 3);
@@ -45,6 +45,7 @@ public:
     Slider frequency;
     Slider gain;
     Label freqLabel, gainLabel;
+    ComboBox shape;
 
     // Plot
     Rectangle<int> plotFrame;
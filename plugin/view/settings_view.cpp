@@ -15,10 +15,59 @@
  */
 
 #include "settings_view.h"
+#include "../settings/constants.h"
 
 namespace tobanteAudio
 {
-SettingsView::SettingsView() { rows.emplace_back(String("Settings")); }
+SettingsView::SettingsView()
+{
+    rows.emplace_back(String("Settings"));
+
+    // Band count
+    for (int i = 1; i <= FILTER_MAX_BANDS; ++i) { numBands.addItem(String(i), i); }
+    numBandsLabel.setText(translate("Bands"), dontSendNotification);
+    numBandsLabel.setJustificationType(Justification::centredRight);
+    numBandsLabel.attachToComponent(&numBands, true);
+    numBands.setTooltip(translate("Number of EQ bands"));
+    addAndMakeVisible(numBands);
+
+    // Oversampling, items are added by the parameter attachment
+    oversamplingLabel.setText(translate("Oversampling"), dontSendNotification);
+    oversamplingLabel.setJustificationType(Justification::centredRight);
+    oversamplingLabel.attachToComponent(&oversampling, true);
+    oversampling.setTooltip(translate("Runs the filters at a multiple of the sample rate"));
+    addAndMakeVisible(oversampling);
+
+    oversamplingFilterLabel.setText(translate("Resampling"), dontSendNotification);
+    oversamplingFilterLabel.setJustificationType(Justification::centredRight);
+    oversamplingFilterLabel.attachToComponent(&oversamplingFilter, true);
+    oversamplingFilter.setTooltip(translate("Half-band filters used for oversampling"));
+    addAndMakeVisible(oversamplingFilter);
+
+    phaseLabel.setText(translate("Phase"), dontSendNotification);
+    phaseLabel.setJustificationType(Justification::centredRight);
+    phaseLabel.attachToComponent(&phase, true);
+    phase.setTooltip(translate("Linear phase avoids phase shifts at the cost of latency"));
+    addAndMakeVisible(phase);
+
+    designLabel.setText(translate("Design"), dontSendNotification);
+    designLabel.setJustificationType(Justification::centredRight);
+    designLabel.attachToComponent(&design, true);
+    design.setTooltip(translate("Matched filters keep their analog shape up to Nyquist"));
+    addAndMakeVisible(design);
+
+    topologyLabel.setText(translate("Topology"), dontSendNotification);
+    topologyLabel.setJustificationType(Justification::centredRight);
+    topologyLabel.attachToComponent(&topology, true);
+    topology.setTooltip(translate("State variable filters can be modulated at audio rate"));
+    addAndMakeVisible(topology);
+
+    analyserLabel.setText(translate("Analyser"), dontSendNotification);
+    analyserLabel.setJustificationType(Justification::centredRight);
+    analyserLabel.attachToComponent(&analyser, true);
+    analyser.setTooltip(translate("Shows the spectrum of both channels, mid or side"));
+    addAndMakeVisible(analyser);
+}
 
 void SettingsView::paint(Graphics& g)
 {
@@ -30,11 +79,21 @@ void SettingsView::paint(Graphics& g)
     g.setColour(Colours::black);
     g.setFont(32.0f);
 
-    auto bounds       = getLocalBounds();
+    auto bounds       = getLocalBounds().removeFromTop(getHeight() / 2);
     const auto height = static_cast<int>(bounds.getHeight() / rows.size());
     for (const auto& row : rows) { g.drawText(row, bounds.removeFromTop(height), Justification::centred, true); }
 }
 
-void SettingsView::resized() { }
+void SettingsView::resized()
+{
+    auto area = getLocalBounds().removeFromBottom(getHeight() / 2);
+    numBands.setBounds(area.removeFromTop(30).withSizeKeepingCentre(120, 30));
+    oversampling.setBounds(area.removeFromTop(40).withSizeKeepingCentre(120, 30));
+    oversamplingFilter.setBounds(area.removeFromTop(40).withSizeKeepingCentre(120, 30));
+    phase.setBounds(area.removeFromTop(40).withSizeKeepingCentre(120, 30));
+    design.setBounds(area.removeFromTop(40).withSizeKeepingCentre(120, 30));
+    topology.setBounds(area.removeFromTop(40).withSizeKeepingCentre(120, 30));
+    analyser.setBounds(area.removeFromTop(40).withSizeKeepingCentre(120, 30));
+}
 
 }  // namespace tobanteAudio
\ No newline at end of file
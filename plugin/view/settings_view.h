@@ -31,6 +31,22 @@ public:
     void paint(Graphics& g) override;
     void resized() override;
 
+    Label numBandsLabel;
+    ComboBox numBands;
+
+    Label oversamplingLabel;
+    ComboBox oversampling;
+    Label oversamplingFilterLabel;
+    ComboBox oversamplingFilter;
+    Label phaseLabel;
+    ComboBox phase;
+    Label designLabel;
+    ComboBox design;
+    Label topologyLabel;
+    ComboBox topology;
+    Label analyserLabel;
+    ComboBox analyser;
+
 private:
     std::vector<String> rows;
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SettingsView)
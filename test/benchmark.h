@@ -0,0 +1,55 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+namespace tobanteAudio::tests
+{
+/**
+ * @brief Category of the performance measurements. They are excluded from the
+ * default test run.
+ */
+const String BenchmarkCategory = "Benchmarks";
+
+/**
+ * @brief Runs the callable a number of times & returns the average run time
+ * in seconds.
+ */
+template <typename Callable> double measureAverageSeconds(int iterations, Callable&& callable)
+{
+    const auto start = Time::getHighResolutionTicks();
+    for (int i = 0; i < iterations; ++i) { callable(); }
+    const auto end = Time::getHighResolutionTicks();
+
+    return Time::highResolutionTicksToSeconds(end - start) / iterations;
+}
+
+/**
+ * @brief Fills all channels of the buffer with white noise.
+ */
+template <typename SampleType> void fillWithNoise(AudioBuffer<SampleType>& buffer, Random& random)
+{
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        auto* data = buffer.getWritePointer(channel);
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        { data[i] = static_cast<SampleType>(random.nextFloat() * 2.0f - 1.0f); }
+    }
+}
+}  // namespace tobanteAudio::tests
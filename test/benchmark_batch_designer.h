@@ -0,0 +1,91 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "benchmark.h"
+#include "processor/biquad_batch_designer.h"
+#include "processor/biquad_designer.h"
+
+namespace tobanteAudio::tests
+{
+class BenchmarkBatchDesigner : public UnitTest
+{
+public:
+    BenchmarkBatchDesigner() : UnitTest("Batch Designer Cost", BenchmarkCategory) { }
+
+    void runTest() override
+    {
+        beginTest("Cost of designing every section of 32 bands");
+
+        constexpr auto sampleRate  = 48000.0;
+        constexpr auto numSections = size_t {32};
+        constexpr auto iterations  = 20000;
+
+        auto random = getRandom();
+        std::array<double, numSections> frequencies {};
+        std::array<double, numSections> qualities {};
+        for (size_t i = 0; i < numSections; ++i)
+        {
+            frequencies[i] = 20.0 * std::pow(1000.0, random.nextDouble());
+            qualities[i]   = 0.3 + random.nextDouble() * 3.0;
+        }
+
+        auto sink            = 0.0;
+        const auto reference = measureAverageSeconds(iterations, [&] {
+            for (size_t i = 0; i < numSections; ++i)
+            {
+                const auto c = dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, float(frequencies[i]),
+                                                                             float(qualities[i]), 2.0f);
+                sink += c->coefficients[1];
+            }
+        });
+
+        const auto scalar = measureAverageSeconds(iterations, [&] {
+            for (size_t i = 0; i < numSections; ++i)
+            { sink += BiquadDesigner<double>::makePeakFilter(sampleRate, frequencies[i], qualities[i], 2.0).a1; }
+        });
+
+        BiquadBatchDesigner<double, numSections> designer;
+        const auto batch = measureAverageSeconds(iterations, [&] {
+            designer.clear();
+            for (size_t i = 0; i < numSections; ++i)
+            { designer.add(BiquadShape::Peak, frequencies[i], qualities[i], 2.0); }
+            designer.design(sampleRate);
+            sink += designer.getCoefficients(numSections - 1).a1;
+        });
+
+        BiquadBatchDesigner<float, numSections> floatDesigner;
+        const auto floatBatch = measureAverageSeconds(iterations, [&] {
+            floatDesigner.clear();
+            for (size_t i = 0; i < numSections; ++i)
+            { floatDesigner.add(BiquadShape::Peak, frequencies[i], qualities[i], 2.0); }
+            floatDesigner.design(sampleRate);
+            sink += floatDesigner.getCoefficients(numSections - 1).a1;
+        });
+
+        logMessage("dsp::IIR::Coefficients: " + String(reference * 1.0e6, 3) + " us");
+        logMessage("BiquadDesigner: " + String(scalar * 1.0e6, 3) + " us");
+        logMessage("BiquadBatchDesigner<double>: " + String(batch * 1.0e6, 3) + " us");
+        logMessage("BiquadBatchDesigner<float>: " + String(floatBatch * 1.0e6, 3) + " us");
+        expect(std::isfinite(sink));
+    }
+};
+}  // namespace tobanteAudio::tests
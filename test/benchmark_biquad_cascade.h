@@ -0,0 +1,168 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "benchmark.h"
+#include "processor/biquad_cascade.h"
+#include "test_biquad_cascade.h"
+
+namespace tobanteAudio::tests
+{
+class BenchmarkBiquadCascade : public UnitTest
+{
+public:
+    BenchmarkBiquadCascade() : UnitTest("Biquad Cascade Throughput", BenchmarkCategory) { }
+
+    void runTest() override
+    {
+        beginTest("Throughput per channel, BiquadCascade vs. ProcessorChain");
+
+        constexpr auto sampleRate = 44100.0;
+        constexpr auto blockSize  = 512;
+        constexpr auto iterations = 2000;
+
+        const auto coefficients = makeReferenceCoefficients(sampleRate);
+
+        for (auto numChannels : {1, 2, 4, 8})
+        {
+            const auto spec = dsp::ProcessSpec {sampleRate, blockSize, static_cast<uint32>(numChannels)};
+            auto random     = getRandom();
+
+            AudioBuffer<float> buffer(numChannels, blockSize);
+            fillWithNoise(buffer, random);
+            dsp::AudioBlock<float> block(buffer);
+
+            ReferenceChain chain;
+            chain.prepare(spec);
+            setReferenceCoefficients(chain, coefficients);
+
+            BiquadCascade<float, 6> cascade;
+            cascade.prepare(spec);
+            for (size_t i = 0; i < coefficients.size(); ++i) { cascade.setCoefficients(i, *coefficients[i]); }
+
+            const auto chainSeconds = measureAverageSeconds(
+                iterations, [&]() { chain.process(dsp::ProcessContextReplacing<float>(block)); });
+            const auto cascadeSeconds = measureAverageSeconds(
+                iterations, [&]() { cascade.process(dsp::ProcessContextReplacing<float>(block)); });
+
+            const auto samplesPerChannel = static_cast<double>(blockSize);
+            const auto chainRate         = samplesPerChannel / chainSeconds / 1.0e6;
+            const auto cascadeRate       = samplesPerChannel / cascadeSeconds / 1.0e6;
+
+            logMessage(String(numChannels) + " channel(s): ProcessorChain " + String(chainRate, 1)
+                       + " MSamples/s per channel, BiquadCascade " + String(cascadeRate, 1)
+                       + " MSamples/s per channel, speedup " + String(chainSeconds / cascadeSeconds, 2) + "x");
+        }
+
+        beginTest("Cost per channel of surround & ambisonic beds, BiquadCascade vs. ProcessorChain");
+
+        const auto beds = std::array<std::pair<const char*, int>, 4> {
+            std::make_pair("5.1", 6), std::make_pair("7.1", 8), std::make_pair("7.1.4", 12),
+            std::make_pair("3rd order ambisonics", 16)};
+
+        for (const auto& [name, numChannels] : beds)
+        {
+            const auto spec = dsp::ProcessSpec {sampleRate, blockSize, static_cast<uint32>(numChannels)};
+            auto random     = getRandom();
+
+            AudioBuffer<float> buffer(numChannels, blockSize);
+            fillWithNoise(buffer, random);
+            dsp::AudioBlock<float> block(buffer);
+
+            ReferenceChain chain;
+            chain.prepare(spec);
+            setReferenceCoefficients(chain, coefficients);
+
+            BiquadCascade<float, 6> cascade;
+            cascade.prepare(spec);
+            for (size_t i = 0; i < coefficients.size(); ++i) { cascade.setCoefficients(i, *coefficients[i]); }
+
+            const auto chainSeconds = measureAverageSeconds(
+                iterations, [&]() { chain.process(dsp::ProcessContextReplacing<float>(block)); });
+            const auto cascadeSeconds = measureAverageSeconds(
+                iterations, [&]() { cascade.process(dsp::ProcessContextReplacing<float>(block)); });
+
+            // Nanoseconds per sample of one channel
+            const auto samples     = static_cast<double>(blockSize * numChannels);
+            const auto chainCost   = chainSeconds / samples * 1.0e9;
+            const auto cascadeCost = cascadeSeconds / samples * 1.0e9;
+
+            logMessage(String(name) + " (" + String(numChannels) + " channels): ProcessorChain "
+                       + String(chainCost, 2) + " ns, BiquadCascade " + String(cascadeCost, 2)
+                       + " ns per channel & sample, speedup " + String(chainSeconds / cascadeSeconds, 2) + "x");
+        }
+
+        beginTest("Block time by number of filtering bands, the others set to no filter");
+
+        for (auto numFiltering : {2, 4, 6})
+        {
+            constexpr auto numChannels = 2;
+            const auto spec            = dsp::ProcessSpec {sampleRate, blockSize, numChannels};
+            auto random                = getRandom();
+
+            AudioBuffer<float> buffer(numChannels, blockSize);
+            fillWithNoise(buffer, random);
+            dsp::AudioBlock<float> block(buffer);
+
+            BiquadCascade<float, 6> cascade;
+            cascade.prepare(spec);
+            for (size_t i = 0; i < coefficients.size(); ++i) { cascade.setCoefficients(i, *coefficients[i]); }
+            for (auto i = static_cast<size_t>(numFiltering); i < coefficients.size(); ++i)
+            { cascade.setCoefficients(i, BiquadCoefficients<float> {}); }
+
+            const auto seconds = measureAverageSeconds(
+                iterations, [&]() { cascade.process(dsp::ProcessContextReplacing<float>(block)); });
+
+            logMessage(String(numFiltering) + " of 6 bands filtering: " + String(seconds * 1.0e6, 2)
+                       + " us per block");
+        }
+
+        beginTest("Block time by number of active sections");
+
+        for (auto numSections : {4, 8, 16, 32})
+        {
+            constexpr auto numChannels = 2;
+            const auto spec            = dsp::ProcessSpec {sampleRate, blockSize, numChannels};
+            auto random                = getRandom();
+
+            AudioBuffer<float> buffer(numChannels, blockSize);
+            fillWithNoise(buffer, random);
+            dsp::AudioBlock<float> block(buffer);
+
+            // Gentle peaks spread over the spectrum keep the output bounded
+            BiquadCascade<float, 32> cascade;
+            cascade.prepare(spec);
+            for (size_t i = 0; i < 32; ++i)
+            {
+                const auto frequency = 40.0f * std::pow(2.0f, static_cast<float>(i) / 4.0f);
+                cascade.setCoefficients(i, *dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, frequency, 1.0f,
+                                                                                          1.05f));
+            }
+            cascade.setNumActiveSections(static_cast<size_t>(numSections));
+
+            const auto seconds = measureAverageSeconds(
+                iterations, [&]() { cascade.process(dsp::ProcessContextReplacing<float>(block)); });
+
+            logMessage(String(numSections) + " of 32 sections: " + String(seconds * 1.0e6, 2) + " us per block");
+        }
+    }
+};
+}  // namespace tobanteAudio::tests
@@ -0,0 +1,69 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "benchmark.h"
+#include "processor_host.h"
+
+namespace tobanteAudio::tests
+{
+class BenchmarkDynamicBands : public UnitTest
+{
+public:
+    BenchmarkDynamicBands() : UnitTest("Dynamic Band Cost", BenchmarkCategory) { }
+
+    void runTest() override
+    {
+        beginTest("Cost of a block, static vs. dynamic bands");
+
+        constexpr auto sampleRate = 48000.0;
+        constexpr auto blockSize  = 512;
+        constexpr auto iterations = 2000;
+
+        const auto staticSeconds  = measure(sampleRate, blockSize, iterations, false);
+        const auto dynamicSeconds = measure(sampleRate, blockSize, iterations, true);
+
+        logMessage(String(FILTER_DEFAULT_NUM_BANDS) + " bands: static " + String(staticSeconds * 1.0e6, 2)
+                   + " us, dynamic " + String(dynamicSeconds * 1.0e6, 2) + " us per block, ratio "
+                   + String(dynamicSeconds / staticSeconds, 2) + "x");
+    }
+
+private:
+    double measure(double sampleRate, int blockSize, int iterations, bool dynamic)
+    {
+        EqualizerHost host;
+        auto& equalizer = host.getEqualizer();
+        for (int band = 0; band < FILTER_DEFAULT_NUM_BANDS; ++band)
+        {
+            host.setParameter(equalizer.getDynamicParamID(band), dynamic ? 1.0f : 0.0f);
+            host.setParameter(equalizer.getThresholdParamID(band), -40.0f);
+        }
+        host.prepare(sampleRate, blockSize);
+
+        auto random = getRandom();
+        AudioBuffer<float> buffer(2, blockSize);
+        fillWithNoise(buffer, random);
+        MidiBuffer midi;
+
+        return measureAverageSeconds(iterations, [&]() { equalizer.processBlock(buffer, midi); });
+    }
+};
+}  // namespace tobanteAudio::tests
@@ -0,0 +1,80 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "benchmark.h"
+#include "processor/lfo_bank.h"
+
+namespace tobanteAudio::tests
+{
+class BenchmarkLfoBank : public UnitTest
+{
+public:
+    BenchmarkLfoBank() : UnitTest("LFO Bank Cost", BenchmarkCategory) { }
+
+    void runTest() override
+    {
+        beginTest("Cost of the LFOs for one block");
+        {
+            constexpr auto sampleRate = 48000.0;
+            constexpr auto blockSize  = 512;
+            constexpr auto iterations = 2000;
+            constexpr auto numLfos    = static_cast<int>(LfoBank::numLfos);
+
+            // One oscillator per LFO, evaluated for every sample
+            dsp::ProcessSpec spec {sampleRate, static_cast<uint32>(blockSize), 1};
+            std::array<dsp::Oscillator<float>, LfoBank::numLfos> oscillators;
+            for (auto& oscillator : oscillators)
+            {
+                oscillator.initialise([](float x) { return std::sin(x); });
+                oscillator.prepare(spec);
+                oscillator.setFrequency(LFO_FREQ_DEFAULT);
+            }
+
+            AudioBuffer<float> buffer(numLfos, blockSize);
+            auto sink            = 0.0f;
+            const auto reference = measureAverageSeconds(iterations, [&] {
+                for (int lfo = 0; lfo < numLfos; ++lfo)
+                {
+                    dsp::AudioBlock<float> block(buffer.getArrayOfWritePointers() + lfo, 1, blockSize);
+                    oscillators[static_cast<size_t>(lfo)].process(dsp::ProcessContextReplacing<float>(block));
+                }
+                sink += buffer.getSample(0, 0);
+            });
+
+            // The bank, sampled once per control interval
+            LfoBank bank;
+            bank.prepare(sampleRate);
+            for (size_t lfo = 0; lfo < LfoBank::numLfos; ++lfo)
+            { bank.setShape(lfo, static_cast<LfoBank::Shape>(lfo % static_cast<size_t>(LfoBank::LastShape))); }
+
+            const auto control = measureAverageSeconds(iterations, [&] {
+                for (int start = 0; start < blockSize; start += MODULATION_CONTROL_INTERVAL)
+                { sink += bank.process(MODULATION_CONTROL_INTERVAL)[0]; }
+            });
+
+            logMessage("dsp::Oscillator per sample: " + String(reference * 1.0e6, 3) + " us");
+            logMessage("LfoBank per control interval: " + String(control * 1.0e6, 3) + " us");
+            expect(std::isfinite(sink));
+        }
+    }
+};
+}  // namespace tobanteAudio::tests
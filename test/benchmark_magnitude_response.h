@@ -0,0 +1,103 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "benchmark.h"
+#include "processor/biquad_designer.h"
+#include "processor/magnitude_response.h"
+#include "processor_host.h"
+
+namespace tobanteAudio::tests
+{
+class BenchmarkMagnitudeResponse : public UnitTest
+{
+public:
+    BenchmarkMagnitudeResponse() : UnitTest("Magnitude Response Cost", BenchmarkCategory) { }
+
+    void runTest() override
+    {
+        beginTest("Cost of the response of a steep high-pass");
+        {
+            constexpr auto sampleRate  = 48000.0;
+            constexpr auto numSections = size_t {8};
+            constexpr auto iterations  = 5000;
+
+            std::vector<double> frequencies(300);
+            for (size_t i = 0; i < frequencies.size(); ++i) { frequencies[i] = 20.0 * std::pow(2.0, i / 30.0); }
+            std::vector<double> magnitudes(frequencies.size());
+            std::vector<double> sectionMagnitudes(frequencies.size());
+
+            std::array<BiquadCoefficients<double>, numSections> sections {};
+            for (auto& section : sections) { section = BiquadDesigner<double>::makeHighPass(sampleRate, 500.0, 0.7); }
+
+            auto sink            = 0.0;
+            const auto reference = measureAverageSeconds(iterations, [&] {
+                std::fill(magnitudes.begin(), magnitudes.end(), 1.0);
+                for (const auto& c : sections)
+                {
+                    dsp::IIR::Coefficients<float>::Ptr coefficients = new dsp::IIR::Coefficients<float>(
+                        float(c.b0), float(c.b1), float(c.b2), 1.0f, float(c.a1), float(c.a2));
+                    coefficients->getMagnitudeForFrequencyArray(frequencies.data(), sectionMagnitudes.data(),
+                                                                frequencies.size(), sampleRate);
+                    FloatVectorOperations::multiply(magnitudes.data(), sectionMagnitudes.data(),
+                                                    static_cast<int>(magnitudes.size()));
+                }
+                sink += magnitudes[150];
+            });
+
+            MagnitudeResponse response;
+            response.prepare(frequencies, sampleRate);
+            const auto table = measureAverageSeconds(iterations, [&] {
+                response.process(sections.data(), sections.size(), magnitudes.data());
+                sink += magnitudes[150];
+            });
+
+            logMessage("dsp::IIR::Coefficients: " + String(reference * 1.0e6, 3) + " us");
+            logMessage("MagnitudeResponse: " + String(table * 1.0e6, 3) + " us");
+            expect(std::isfinite(sink));
+        }
+
+        beginTest("Cost of dragging a band handle");
+        {
+            EqualizerHost host;
+            host.prepare(48000.0, 512);
+            auto& equalizer = host.getEqualizer();
+
+            auto frequency  = 100.0f;
+            const auto drag = measureAverageSeconds(1000, [&] {
+                frequency = frequency > 10000.0f ? 100.0f : frequency * 1.01f;
+                host.setParameter(equalizer.getFrequencyParamID(0), frequency);
+                equalizer.handleBandChanges();
+            });
+
+            // The same with the curves the worker computes in the background
+            const auto curves = measureAverageSeconds(1000, [&] {
+                frequency = frequency > 10000.0f ? 100.0f : frequency * 1.01f;
+                host.setParameter(equalizer.getFrequencyParamID(0), frequency);
+                equalizer.handleBandChanges();
+                equalizer.updateResponsesNow();
+            });
+
+            logMessage("Parameter change on the message thread: " + String(drag * 1.0e6, 3) + " us");
+            logMessage("Parameter change & curves: " + String(curves * 1.0e6, 3) + " us");
+        }
+    }
+};
+}  // namespace tobanteAudio::tests
@@ -0,0 +1,65 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "benchmark.h"
+#include "processor/modulation_matrix.h"
+
+namespace tobanteAudio::tests
+{
+class BenchmarkModulationMatrix : public UnitTest
+{
+public:
+    BenchmarkModulationMatrix() : UnitTest("Modulation Matrix Cost", BenchmarkCategory) { }
+
+    void runTest() override
+    {
+        beginTest("Cost of one evaluation per number of connections");
+        {
+            constexpr auto iterations = 100000;
+
+            std::array<float, MODULATION_MAX_SOURCES> sources {};
+            for (size_t i = 0; i < sources.size(); ++i) { sources[i] = 1.0f / static_cast<float>(i + 1); }
+
+            for (const auto numConnections : {0, 4, MODULATION_MAX_CONNECTIONS})
+            {
+                ValueTree tree("state");
+                ModulationMatrix matrix(tree);
+                for (int i = 0; i < numConnections; ++i)
+                {
+                    // Spreads the connections over all sources, bands & parameters
+                    const auto parameter = static_cast<ModulationParameter>(i % 3);
+                    const auto target    = ModulationTarget {parameter, (i / 3) % FILTER_MAX_BANDS};
+                    matrix.setConnection({i % MODULATION_MAX_SOURCES, target, 0.5f, true});
+                }
+
+                auto sink          = uint64 {0};
+                const auto seconds = measureAverageSeconds(iterations, [&] {
+                    if (matrix.acquireConnections()) { sink |= matrix.process(sources.data(), sources.size()); }
+                });
+
+                logMessage(String(numConnections) + " connections: " + String(seconds * 1.0e9, 1) + " ns");
+                expect(numConnections == 0 || sink != 0);
+            }
+        }
+    }
+};
+}  // namespace tobanteAudio::tests
@@ -0,0 +1,108 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "benchmark.h"
+#include "processor_host.h"
+
+namespace tobanteAudio::tests
+{
+class BenchmarkPipeline : public UnitTest
+{
+public:
+    BenchmarkPipeline() : UnitTest("Fused Block Pipeline", BenchmarkCategory) { }
+
+    void runTest() override
+    {
+        beginTest("Cost per sample, stage by stage over the block vs. fused cache sized sub-blocks");
+
+        constexpr auto sampleRate   = 48000.0;
+        constexpr auto totalSamples = 1 << 19;
+
+        const auto layouts = std::array<std::pair<const char*, AudioChannelSet>, 2> {
+            std::make_pair("Stereo", AudioChannelSet::stereo()),
+            std::make_pair("7.1.4", AudioChannelSet::create7point1point4())};
+
+        for (const auto& [name, layout] : layouts)
+        {
+            for (auto blockSize = 64; blockSize <= 8192; blockSize *= 2)
+            {
+                const auto iterations   = totalSamples / blockSize;
+                const auto wholeSeconds = measure(layout, sampleRate, blockSize, iterations, false);
+                const auto fusedSeconds = measure(layout, sampleRate, blockSize, iterations, true);
+
+                // Nanoseconds per sample of one channel
+                const auto samples   = static_cast<double>(blockSize * layout.size());
+                const auto wholeCost = wholeSeconds / samples * 1.0e9;
+                const auto fusedCost = fusedSeconds / samples * 1.0e9;
+
+                logMessage(String(name) + ", " + String(blockSize) + " samples: stage by stage "
+                           + String(wholeCost, 2) + " ns, fused " + String(fusedCost, 2)
+                           + " ns per channel & sample, speedup " + String(wholeSeconds / fusedSeconds, 2) + "x");
+            }
+        }
+    }
+
+private:
+    /**
+     * @brief Average time of one block through equalizer, output gain &
+     * meter, the same stages ModEQProcessor runs.
+     */
+    double measure(const AudioChannelSet& layout, double sampleRate, int blockSize, int iterations, bool fused)
+    {
+        const auto numChannels = layout.size();
+
+        EqualizerHost host;
+        auto& equalizer = host.getEqualizer();
+        host.prepare(sampleRate, blockSize, layout);
+
+        dsp::Gain<float> gain;
+        gain.setGainLinear(0.5f);
+        gain.prepare({sampleRate, static_cast<uint32>(blockSize), static_cast<uint32>(numChannels)});
+
+        FFAU::LevelMeterSource meter;
+        meter.resize(numChannels, METER_RMS_WINDOW);
+
+        auto random = getRandom();
+        AudioBuffer<float> buffer(numChannels, blockSize);
+        AudioBuffer<float> input(numChannels, blockSize);
+        fillWithNoise(input, random);
+        MidiBuffer midi;
+
+        const auto subBlockSize = fused ? EqualizerProcessor::getPipelineBlockSize(numChannels, sizeof(float))
+                                        : blockSize;
+        return measureAverageSeconds(iterations, [&]() {
+            // Keeps the level constant, the gain would fade the noise out
+            buffer.makeCopyOf(input, true);
+            for (int start = 0; start < blockSize; start += subBlockSize)
+            {
+                const auto length = jmin(subBlockSize, blockSize - start);
+                AudioBuffer<float> subBlock(buffer.getArrayOfWritePointers(), numChannels, start, length);
+                equalizer.processSubBlock(subBlock, start);
+
+                dsp::AudioBlock<float> ioBuffer(subBlock);
+                gain.process(dsp::ProcessContextReplacing<float>(ioBuffer));
+            }
+            meter.measureBlock(buffer);
+        });
+    }
+};
+}  // namespace tobanteAudio::tests
@@ -0,0 +1,71 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "benchmark.h"
+#include "processor_host.h"
+
+namespace tobanteAudio::tests
+{
+class BenchmarkPrecision : public UnitTest
+{
+public:
+    BenchmarkPrecision() : UnitTest("Equalizer Precision Cost", BenchmarkCategory) { }
+
+    void runTest() override
+    {
+        beginTest("Cost of a block, float vs. double processing");
+
+        constexpr auto sampleRate = 96000.0;
+        constexpr auto blockSize  = 512;
+        constexpr auto iterations = 2000;
+
+        for (auto numBands : {6, 16, 32})
+        {
+            const auto singleSeconds = measure<float>(sampleRate, blockSize, iterations, numBands);
+            const auto doubleSeconds = measure<double>(sampleRate, blockSize, iterations, numBands);
+
+            logMessage(String(numBands) + " bands: float " + String(singleSeconds * 1.0e6, 2) + " us, double "
+                       + String(doubleSeconds * 1.0e6, 2) + " us per block, ratio "
+                       + String(doubleSeconds / singleSeconds, 2) + "x");
+        }
+    }
+
+private:
+    template <typename SampleType> double measure(double sampleRate, int blockSize, int iterations, int numBands)
+    {
+        constexpr auto isDouble = std::is_same<SampleType, double>::value;
+        const auto precision    = isDouble ? AudioProcessor::doublePrecision : AudioProcessor::singlePrecision;
+
+        EqualizerHost host;
+        auto& equalizer = host.getEqualizer();
+        equalizer.setNumBands(numBands);
+        host.prepare(sampleRate, blockSize, 2, precision);
+
+        auto random = getRandom();
+        AudioBuffer<SampleType> buffer(2, blockSize);
+        fillWithNoise(buffer, random);
+        MidiBuffer midi;
+
+        return measureAverageSeconds(iterations, [&]() { equalizer.processBlock(buffer, midi); });
+    }
+};
+}  // namespace tobanteAudio::tests
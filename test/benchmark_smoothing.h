@@ -0,0 +1,78 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "benchmark.h"
+#include "processor_host.h"
+
+namespace tobanteAudio::tests
+{
+class BenchmarkSmoothing : public UnitTest
+{
+public:
+    BenchmarkSmoothing() : UnitTest("Coefficient Smoothing Cost", BenchmarkCategory) { }
+
+    void runTest() override
+    {
+        beginTest("Cost of a block while all bands ramp, per control interval");
+
+        constexpr auto sampleRate = 48000.0;
+        constexpr auto blockSize  = 512;
+        constexpr auto numBlocks  = 2000;
+
+        for (auto interval : {1, 8, 16, 32, 64, 128, blockSize})
+        {
+            EqualizerHost host;
+            auto& equalizer = host.getEqualizer();
+            equalizer.setControlInterval(interval);
+            host.prepare(sampleRate, blockSize);
+
+            auto random = getRandom();
+            AudioBuffer<float> buffer(2, blockSize);
+            MidiBuffer midi;
+
+            auto ticks = int64 {0};
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                // New targets every few blocks, so the bands never settle.
+                if (block % 4 == 0)
+                {
+                    for (int band = 0; band < equalizer.getNumBands(); ++band)
+                    {
+                        host.setParameter(equalizer.getFrequencyParamID(band), 200.0f + random.nextFloat() * 5000.0f);
+                        host.setParameter(equalizer.getGainParamID(band), 0.5f + random.nextFloat());
+                    }
+                }
+
+                fillWithNoise(buffer, random);
+                const auto start = Time::getHighResolutionTicks();
+                equalizer.processBlock(buffer, midi);
+                ticks += Time::getHighResolutionTicks() - start;
+            }
+
+            const auto seconds = Time::highResolutionTicksToSeconds(ticks) / numBlocks;
+            const auto load    = seconds / (blockSize / sampleRate) * 100.0;
+            logMessage("Control interval " + String(interval) + " samples: " + String(seconds * 1.0e6, 2)
+                       + " us per block (" + String(load, 3) + "% of one core)");
+        }
+    }
+};
+}  // namespace tobanteAudio::tests
@@ -0,0 +1,95 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "benchmark.h"
+#include "processor/biquad_cascade.h"
+#include "processor/biquad_designer.h"
+#include "processor/svf_cascade.h"
+#include "processor/svf_designer.h"
+
+namespace tobanteAudio::tests
+{
+class BenchmarkSvfCascade : public UnitTest
+{
+public:
+    BenchmarkSvfCascade() : UnitTest("SVF Cascade Modulation", BenchmarkCategory) { }
+
+    void runTest() override
+    {
+        beginTest("Block time of 32 bands, static vs. modulated every sample");
+
+        constexpr auto sampleRate  = 48000.0;
+        constexpr auto blockSize   = 512;
+        constexpr auto numChannels = 2;
+        constexpr auto numSections = 32;
+        constexpr auto iterations  = 2000;
+
+        const auto spec = dsp::ProcessSpec {sampleRate, blockSize, numChannels};
+        auto random     = getRandom();
+
+        AudioBuffer<float> buffer(numChannels, blockSize);
+        fillWithNoise(buffer, random);
+        dsp::AudioBlock<float> block(buffer);
+
+        // Gentle peaks spread over the spectrum keep the output bounded
+        BiquadCascade<float, numSections> biquads;
+        SvfCascade<float, numSections> svfs;
+        biquads.prepare(spec);
+        svfs.prepare(spec);
+        for (size_t i = 0; i < numSections; ++i)
+        {
+            const auto frequency = 40.0 * std::pow(2.0, static_cast<double>(i) / 4.0);
+            biquads.setCoefficients(i, BiquadDesigner<double>::makePeakFilter(sampleRate, frequency, 1.0, 1.05));
+            svfs.setCoefficients(i, SvfDesigner<double>::makePeakFilter(sampleRate, frequency, 1.0, 1.05));
+        }
+
+        // A slow vibrato of one semitone on every band
+        std::vector<float> ratios(blockSize);
+        for (size_t i = 0; i < ratios.size(); ++i)
+        {
+            const auto phase = MathConstants<float>::twoPi * static_cast<float>(i) / static_cast<float>(blockSize);
+            ratios[i]        = std::pow(2.0f, std::sin(phase) / 12.0f);
+        }
+        std::array<const float*, numSections> modulation {};
+        modulation.fill(ratios.data());
+
+        const auto biquadSeconds = measureAverageSeconds(
+            iterations, [&]() { biquads.process(dsp::ProcessContextReplacing<float>(block)); });
+        const auto svfSeconds = measureAverageSeconds(
+            iterations, [&]() { svfs.process(dsp::ProcessContextReplacing<float>(block)); });
+        const auto modulatedSeconds = measureAverageSeconds(
+            iterations, [&]() { svfs.process(dsp::ProcessContextReplacing<float>(block), modulation.data()); });
+
+        // Share of one core needed to run in real time
+        const auto blockSeconds = blockSize / sampleRate;
+        const auto describe     = [&](const String& name, double seconds) {
+            logMessage(name + ": " + String(seconds * 1.0e6, 2) + " us per block, "
+                       + String(100.0 * seconds / blockSeconds, 2) + " % of one core");
+        };
+
+        describe("BiquadCascade", biquadSeconds);
+        describe("SvfCascade", svfSeconds);
+        describe("SvfCascade, modulated", modulatedSeconds);
+    }
+};
+}  // namespace tobanteAudio::tests
@@ -0,0 +1,102 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "processor/equalizer_processor.h"
+
+namespace tobanteAudio::tests
+{
+/**
+ * @brief Owns an EqualizerProcessor together with the parameter state it
+ * needs, without creating the whole plugin.
+ */
+class EqualizerHost
+{
+public:
+    EqualizerHost() : state(owner, nullptr, "tobanteAudioModEQTest", {}), equalizer(state) { }
+
+    /**
+     * @brief Prepares the equalizer for the given channel count & precision.
+     */
+    void prepare(double sampleRate, int blockSize, int numChannels = 2,
+                 AudioProcessor::ProcessingPrecision precision = AudioProcessor::singlePrecision)
+    {
+        const auto channels = numChannels == 1 ? AudioChannelSet::mono() : AudioChannelSet::stereo();
+        prepare(sampleRate, blockSize, channels, precision);
+    }
+
+    /**
+     * @brief Prepares the equalizer for the given channel layout & precision.
+     */
+    void prepare(double sampleRate, int blockSize, const AudioChannelSet& channels,
+                 AudioProcessor::ProcessingPrecision precision = AudioProcessor::singlePrecision)
+    {
+        AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(channels);
+        layout.outputBuses.add(channels);
+
+        equalizer.setBusesLayout(layout);
+        equalizer.setProcessingPrecision(precision);
+        equalizer.prepareToPlay(sampleRate, blockSize);
+    }
+
+    /**
+     * @brief Sets a parameter to a new plain value & notifies the equalizer.
+     */
+    void setParameter(const String& parameterID, float newValue)
+    {
+        if (auto* parameter = state.getParameter(parameterID))
+        { parameter->setValueNotifyingHost(parameter->convertTo0to1(newValue)); }
+    }
+
+    EqualizerProcessor& getEqualizer() noexcept { return equalizer; }
+    AudioProcessorValueTreeState& getState() noexcept { return state; }
+
+private:
+    /**
+     * @brief Processor which only holds the parameters.
+     */
+    class ParameterOwner : public AudioProcessor
+    {
+    public:
+        const String getName() const override { return "ParameterOwner"; }
+        void prepareToPlay(double /*sampleRate*/, int /*maximumExpectedSamplesPerBlock*/) override { }
+        void releaseResources() override { }
+        void processBlock(AudioBuffer<float>& /*buffer*/, MidiBuffer& /*midiMessages*/) override { }
+        double getTailLengthSeconds() const override { return 0; }
+        bool acceptsMidi() const override { return false; }
+        bool producesMidi() const override { return false; }
+        AudioProcessorEditor* createEditor() override { return nullptr; }
+        bool hasEditor() const override { return false; }
+        int getNumPrograms() override { return 1; }
+        int getCurrentProgram() override { return 0; }
+        void setCurrentProgram(int /*index*/) override { }
+        const String getProgramName(int /*index*/) override { return {}; }
+        void changeProgramName(int /*index*/, const String& /*newName*/) override { }
+        void getStateInformation(MemoryBlock& /*destData*/) override { }
+        void setStateInformation(const void* /*data*/, int /*sizeInBytes*/) override { }
+    };
+
+    ParameterOwner owner;
+    AudioProcessorValueTreeState state;
+    EqualizerProcessor equalizer;
+};
+}  // namespace tobanteAudio::tests
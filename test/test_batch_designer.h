@@ -0,0 +1,127 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "processor/biquad_batch_designer.h"
+#include "processor/biquad_cascade.h"
+
+namespace tobanteAudio::tests
+{
+class TestBatchDesigner : public UnitTest
+{
+public:
+    TestBatchDesigner() : UnitTest("Batch Designer") { }
+
+    void runTest() override
+    {
+        beginTest("Double precision batches match the JUCE factories");
+        expectLessThan(getMaxError<double>(), BiquadBatchDesigner<double, 1>::maxAbsoluteError);
+
+        beginTest("Single precision batches match the JUCE factories");
+        expectLessThan(getMaxError<float>(), BiquadBatchDesigner<float, 1>::maxAbsoluteError);
+
+        beginTest("Identity sections stay exact");
+        {
+            BiquadBatchDesigner<double, 3> designer;
+            designer.add(BiquadShape::Identity, 1000.0, 0.7, 2.0);
+            designer.design(48000.0);
+            expect(designer.getCoefficients(0).isIdentity());
+        }
+    }
+
+private:
+    static constexpr size_t maxSections = 37;
+
+    struct Section
+    {
+        BiquadShape shape;
+        double frequency;
+        double quality;
+        double gain;
+    };
+
+    template <typename SampleType> double getMaxError()
+    {
+        using Reference = dsp::IIR::Coefficients<double>;
+        using Cascade   = BiquadCascade<double, 1>;
+
+        auto random   = getRandom();
+        auto maxError = 0.0;
+        BiquadBatchDesigner<SampleType, maxSections> designer;
+        std::array<Section, maxSections> sections {};
+
+        for (const auto sampleRate : {44100.0, 48000.0, 96000.0, 192000.0})
+        {
+            for (int batch = 0; batch < 100; ++batch)
+            {
+                // Frequencies up to 0.45 * fs, Q from 0.1 to 10, gains of +-24 dB
+                designer.clear();
+                for (auto& section : sections)
+                {
+                    section.shape     = static_cast<BiquadShape>(random.nextInt(7));
+                    section.frequency = 2.0 * std::pow(0.225 * sampleRate, random.nextDouble());
+                    section.quality   = 0.1 * std::pow(100.0, random.nextDouble());
+                    section.gain      = Decibels::decibelsToGain(random.nextDouble() * 48.0 - 24.0);
+                    designer.add(section.shape, section.frequency, section.quality, section.gain);
+                }
+                designer.design(sampleRate);
+
+                for (size_t i = 0; i < sections.size(); ++i)
+                {
+                    const auto& section = sections[i];
+                    const auto actual   = designer.getCoefficients(i);
+                    const auto expected = [&]() -> Cascade::Coefficients {
+                        const auto f = section.frequency;
+                        const auto q = section.quality;
+                        const auto g = section.gain;
+                        switch (section.shape)
+                        {
+                        case BiquadShape::LowPass:
+                            return Cascade::makeCoefficients(*Reference::makeLowPass(sampleRate, f, q));
+                        case BiquadShape::HighPass:
+                            return Cascade::makeCoefficients(*Reference::makeHighPass(sampleRate, f, q));
+                        case BiquadShape::BandPass:
+                            return Cascade::makeCoefficients(*Reference::makeBandPass(sampleRate, f, q));
+                        case BiquadShape::LowShelf:
+                            return Cascade::makeCoefficients(*Reference::makeLowShelf(sampleRate, f, q, g));
+                        case BiquadShape::HighShelf:
+                            return Cascade::makeCoefficients(*Reference::makeHighShelf(sampleRate, f, q, g));
+                        case BiquadShape::Peak:
+                            return Cascade::makeCoefficients(*Reference::makePeakFilter(sampleRate, f, q, g));
+                        case BiquadShape::Identity:
+                        default:
+                            return {};
+                        }
+                    }();
+
+                    maxError = jmax(maxError, std::abs(static_cast<double>(actual.b0) - expected.b0),
+                                    std::abs(static_cast<double>(actual.b1) - expected.b1),
+                                    std::abs(static_cast<double>(actual.b2) - expected.b2));
+                    maxError = jmax(maxError, std::abs(static_cast<double>(actual.a1) - expected.a1),
+                                    std::abs(static_cast<double>(actual.a2) - expected.a2));
+                }
+            }
+        }
+
+        return maxError;
+    }
+};
+}  // namespace tobanteAudio::tests
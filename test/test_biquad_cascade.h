@@ -0,0 +1,229 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "benchmark.h"
+#include "processor/biquad_cascade.h"
+
+namespace tobanteAudio::tests
+{
+/**
+ * @brief The filter chain used by the EqualizerProcessor before the
+ * BiquadCascade. Used as a reference.
+ */
+using ReferenceFilter = dsp::ProcessorDuplicator<dsp::IIR::Filter<float>, dsp::IIR::Coefficients<float>>;
+using ReferenceChain  = dsp::ProcessorChain<ReferenceFilter, ReferenceFilter, ReferenceFilter, ReferenceFilter,
+                                           ReferenceFilter, ReferenceFilter>;
+
+/**
+ * @brief Returns the coefficients of the default 6 band setup.
+ */
+inline std::array<dsp::IIR::Coefficients<float>::Ptr, 6> makeReferenceCoefficients(double sampleRate)
+{
+    using Coefficients = dsp::IIR::Coefficients<float>;
+    return {
+        Coefficients::makeHighPass(sampleRate, 20.0f, 0.707f),         //
+        Coefficients::makeLowShelf(sampleRate, 250.0f, 1.0f, 2.0f),    //
+        Coefficients::makePeakFilter(sampleRate, 500.0f, 1.0f, 0.5f),  //
+        Coefficients::makePeakFilter(sampleRate, 1000.0f, 4.0f, 1.5f), //
+        Coefficients::makeHighShelf(sampleRate, 5000.0f, 1.0f, 0.7f),  //
+        Coefficients::makeLowPass(sampleRate, 12000.0f, 0.707f),       //
+    };
+}
+
+/**
+ * @brief Copies the coefficients into the reference chain.
+ */
+inline void setReferenceCoefficients(ReferenceChain& chain,
+                                     const std::array<dsp::IIR::Coefficients<float>::Ptr, 6>& coefficients)
+{
+    *chain.get<0>().state = *coefficients[0];
+    *chain.get<1>().state = *coefficients[1];
+    *chain.get<2>().state = *coefficients[2];
+    *chain.get<3>().state = *coefficients[3];
+    *chain.get<4>().state = *coefficients[4];
+    *chain.get<5>().state = *coefficients[5];
+}
+
+class TestBiquadCascade : public UnitTest
+{
+public:
+    TestBiquadCascade() : UnitTest("Biquad Cascade") { }
+
+    void runTest() override
+    {
+        constexpr auto sampleRate  = 44100.0;
+        constexpr auto numChannels = 2;
+        constexpr auto blockSize   = 512;
+        constexpr auto numBlocks   = 16;
+
+        const auto coefficients = makeReferenceCoefficients(sampleRate);
+        const auto spec         = dsp::ProcessSpec {sampleRate, blockSize, numChannels};
+
+        beginTest("BiquadCascade matches the ProcessorChain");
+        {
+            ReferenceChain chain;
+            chain.prepare(spec);
+            setReferenceCoefficients(chain, coefficients);
+
+            BiquadCascade<float, 6> cascade;
+            cascade.prepare(spec);
+            for (size_t i = 0; i < coefficients.size(); ++i) { cascade.setCoefficients(i, *coefficients[i]); }
+
+            expectMatchesReference(chain, cascade, numChannels, blockSize, numBlocks);
+        }
+
+        beginTest("BiquadCascade matches the ProcessorChain with bypassed sections");
+        {
+            ReferenceChain chain;
+            chain.prepare(spec);
+            setReferenceCoefficients(chain, coefficients);
+            chain.setBypassed<1>(true);
+            chain.setBypassed<4>(true);
+
+            BiquadCascade<float, 6> cascade;
+            cascade.prepare(spec);
+            for (size_t i = 0; i < coefficients.size(); ++i) { cascade.setCoefficients(i, *coefficients[i]); }
+            cascade.setBypassed(1, true);
+            cascade.setBypassed(4, true);
+
+            expectMatchesReference(chain, cascade, numChannels, blockSize, numBlocks);
+        }
+
+        beginTest("BiquadCascade skips identity & bypassed sections");
+        {
+            ReferenceChain chain;
+            chain.prepare(spec);
+            setReferenceCoefficients(chain, coefficients);
+            chain.setBypassed<2>(true);
+            chain.setBypassed<4>(true);
+
+            BiquadCascade<float, 6> cascade;
+            cascade.prepare(spec);
+            for (size_t i = 0; i < coefficients.size(); ++i) { cascade.setCoefficients(i, *coefficients[i]); }
+            cascade.setCoefficients(2, BiquadCoefficients<float> {});
+            cascade.setBypassed(4, true);
+
+            expect(cascade.getNumActiveSections() == 6);
+            expect(cascade.getNumProcessedSections() == 4);
+            expectMatchesReference(chain, cascade, numChannels, blockSize, numBlocks);
+
+            cascade.setCoefficients(2, *coefficients[2]);
+            cascade.setBypassed(4, false);
+            expect(cascade.getNumProcessedSections() == 6);
+        }
+
+        beginTest("BiquadCascade handles more channels than SIMD lanes");
+        {
+            constexpr auto manyChannels = 11;
+            const auto manySpec         = dsp::ProcessSpec {sampleRate, blockSize, manyChannels};
+
+            ReferenceChain chain;
+            chain.prepare(manySpec);
+            setReferenceCoefficients(chain, coefficients);
+
+            BiquadCascade<float, 6> cascade;
+            cascade.prepare(manySpec);
+            for (size_t i = 0; i < coefficients.size(); ++i) { cascade.setCoefficients(i, *coefficients[i]); }
+
+            expectMatchesReference(chain, cascade, manyChannels, blockSize, numBlocks);
+        }
+
+        beginTest("BiquadCascade skips inactive sections");
+        {
+            ReferenceChain chain;
+            chain.prepare(spec);
+            setReferenceCoefficients(chain, coefficients);
+            chain.setBypassed<4>(true);
+            chain.setBypassed<5>(true);
+
+            BiquadCascade<float, 6> cascade;
+            cascade.prepare(spec);
+            for (size_t i = 0; i < coefficients.size(); ++i) { cascade.setCoefficients(i, *coefficients[i]); }
+            cascade.setNumActiveSections(4);
+
+            expect(cascade.getNumActiveSections() == 4);
+            expectMatchesReference(chain, cascade, numChannels, blockSize, numBlocks);
+        }
+
+        beginTest("BiquadCascade runs the sections in the order of the sequence");
+        {
+            ReferenceChain chain;
+            chain.prepare(spec);
+            setReferenceCoefficients(chain, coefficients);
+
+            // Stored in reverse, the sequence restores the order of the chain
+            BiquadCascade<float, 6> cascade;
+            cascade.prepare(spec);
+            auto sequence = std::array<size_t, 6> {};
+            for (size_t i = 0; i < coefficients.size(); ++i)
+            {
+                cascade.setCoefficients(coefficients.size() - 1 - i, *coefficients[i]);
+                sequence[i] = coefficients.size() - 1 - i;
+            }
+            cascade.setSequence(sequence, sequence.size());
+
+            expect(cascade.getNumActiveSections() == 6);
+            expectMatchesReference(chain, cascade, numChannels, blockSize, numBlocks);
+
+            // Switched coefficients don't commute with the other sections, the
+            // transient depends on the order
+            const auto peak       = dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, 1000.0f, 4.0f, 4.0f);
+            *chain.get<3>().state = *peak;
+            cascade.setCoefficients(2, *peak);
+            expectMatchesReference(chain, cascade, numChannels, blockSize, numBlocks);
+        }
+    }
+
+private:
+    void expectMatchesReference(ReferenceChain& chain, BiquadCascade<float, 6>& cascade, int numChannels,
+                                int blockSize, int numBlocks)
+    {
+        auto random = getRandom();
+        AudioBuffer<float> expected(numChannels, blockSize);
+        AudioBuffer<float> actual(numChannels, blockSize);
+
+        auto maxError = 0.0f;
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            fillWithNoise(expected, random);
+            actual.makeCopyOf(expected, true);
+
+            dsp::AudioBlock<float> expectedBlock(expected);
+            chain.process(dsp::ProcessContextReplacing<float>(expectedBlock));
+
+            dsp::AudioBlock<float> actualBlock(actual);
+            cascade.process(dsp::ProcessContextReplacing<float>(actualBlock));
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    const auto error = std::abs(expected.getSample(channel, i) - actual.getSample(channel, i));
+                    maxError         = jmax(maxError, error);
+                }
+            }
+        }
+
+        expectLessThan(maxError, 1.0e-4f);
+    }
+};
+}  // namespace tobanteAudio::tests
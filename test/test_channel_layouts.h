@@ -0,0 +1,93 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "benchmark.h"
+#include "processor_host.h"
+
+namespace tobanteAudio::tests
+{
+class TestChannelLayouts : public UnitTest
+{
+public:
+    TestChannelLayouts() : UnitTest("Channel Layouts") { }
+
+    void runTest() override
+    {
+        constexpr auto sampleRate = 48000.0;
+        constexpr auto blockSize  = 512;
+        constexpr auto numBlocks  = 8;
+
+        const auto layouts = std::array<AudioChannelSet, 4> {
+            AudioChannelSet::create5point1(), AudioChannelSet::create7point1(),
+            AudioChannelSet::create7point1point4(), AudioChannelSet::ambisonic(3)};
+
+        beginTest("Surround & ambisonic layouts are supported");
+        {
+            expect(EqualizerProcessor::isChannelLayoutSupported(AudioChannelSet::mono()));
+            expect(EqualizerProcessor::isChannelLayoutSupported(AudioChannelSet::stereo()));
+            for (const auto& layout : layouts) { expect(EqualizerProcessor::isChannelLayoutSupported(layout)); }
+
+            expect(EqualizerProcessor::isAmbisonic(AudioChannelSet::ambisonic(1)));
+            expect(!EqualizerProcessor::isAmbisonic(AudioChannelSet::create7point1point4()));
+            expect(!EqualizerProcessor::isChannelLayoutSupported(AudioChannelSet::discreteChannels(17)));
+        }
+
+        beginTest("Every channel of a bed matches stereo processing");
+        for (const auto& layout : layouts)
+        {
+            const auto numChannels = layout.size();
+
+            EqualizerHost stereoHost;
+            EqualizerHost bedHost;
+            stereoHost.prepare(sampleRate, blockSize);
+            bedHost.prepare(sampleRate, blockSize, layout);
+
+            auto random = getRandom();
+            AudioBuffer<float> stereo(2, blockSize);
+            AudioBuffer<float> bed(numChannels, blockSize);
+            MidiBuffer midi;
+
+            auto maxError = 0.0f;
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                fillWithNoise(stereo, random);
+                for (int channel = 0; channel < numChannels; ++channel)
+                { bed.copyFrom(channel, 0, stereo, channel % 2, 0, blockSize); }
+
+                stereoHost.getEqualizer().processBlock(stereo, midi);
+                bedHost.getEqualizer().processBlock(bed, midi);
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    for (int i = 0; i < blockSize; ++i)
+                    {
+                        const auto error = std::abs(stereo.getSample(channel % 2, i) - bed.getSample(channel, i));
+                        maxError         = jmax(maxError, error);
+                    }
+                }
+            }
+
+            expectLessThan(maxError, 1.0e-6f, layout.getDescription());
+        }
+    }
+};
+}  // namespace tobanteAudio::tests
@@ -0,0 +1,366 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "benchmark.h"
+#include "processor/biquad_cascade.h"
+#include "processor/biquad_designer.h"
+#include "processor/channel_routing.h"
+#include "processor/svf_cascade.h"
+#include "processor/svf_designer.h"
+#include "processor_host.h"
+#include "test_svf_cascade.h"
+
+namespace tobanteAudio::tests
+{
+class TestChannelRouting : public UnitTest
+{
+public:
+    TestChannelRouting() : UnitTest("Channel Routing") { }
+
+    void runTest() override
+    {
+        constexpr auto sampleRate  = 48000.0;
+        constexpr auto numChannels = 3;
+        constexpr auto blockSize   = 512;
+        constexpr auto numBlocks   = 16;
+
+        const auto spec = dsp::ProcessSpec {sampleRate, blockSize, numChannels};
+
+        beginTest("A left section leaves the other channels untouched");
+        {
+            BiquadCascade<float, 1> cascade;
+            cascade.prepare(spec);
+            cascade.setCoefficients(0, BiquadDesigner<double>::makeLowPass(sampleRate, 500.0, 0.707));
+            cascade.setRouting(0, ChannelRouting::Left);
+
+            auto random = getRandom();
+            AudioBuffer<float> input(numChannels, blockSize);
+            AudioBuffer<float> output(numChannels, blockSize);
+            fillWithNoise(input, random);
+            output.makeCopyOf(input, true);
+
+            dsp::AudioBlock<float> ioBlock(output);
+            cascade.process(dsp::ProcessContextReplacing<float>(ioBlock));
+
+            auto leftChange = 0.0f;
+            auto maxChange  = 0.0f;
+            for (int i = 0; i < blockSize; ++i)
+            {
+                leftChange = jmax(leftChange, std::abs(input.getSample(0, i) - output.getSample(0, i)));
+                maxChange  = jmax(maxChange, std::abs(input.getSample(1, i) - output.getSample(1, i)),
+                                 std::abs(input.getSample(2, i) - output.getSample(2, i)));
+            }
+
+            expectGreaterThan(leftChange, 0.1f);
+            expectEquals(maxChange, 0.0f);
+        }
+
+        beginTest("A mid section filters the mid signal only");
+        {
+            BiquadCascade<double, 1> routed;
+            BiquadCascade<double, 1> reference;
+            routed.prepare(spec);
+            reference.prepare(spec);
+            routed.setCoefficients(0, BiquadDesigner<double>::makePeakFilter(sampleRate, 1000.0, 1.0, 4.0));
+            reference.setCoefficients(0, BiquadDesigner<double>::makePeakFilter(sampleRate, 1000.0, 1.0, 4.0));
+            routed.setRouting(0, ChannelRouting::Mid);
+
+            auto random = getRandom();
+            AudioBuffer<double> input(numChannels, blockSize);
+            AudioBuffer<double> output(numChannels, blockSize);
+            AudioBuffer<double> mid(1, blockSize);
+
+            auto maxError = 0.0;
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                fillWithNoise(input, random);
+                output.makeCopyOf(input, true);
+                for (int i = 0; i < blockSize; ++i)
+                { mid.setSample(0, i, (input.getSample(0, i) + input.getSample(1, i)) * 0.5); }
+
+                dsp::AudioBlock<double> outputBlock(output);
+                dsp::AudioBlock<double> midBlock(mid);
+                routed.process(dsp::ProcessContextReplacing<double>(outputBlock));
+                reference.process(dsp::ProcessContextReplacing<double>(midBlock));
+
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    const auto side        = (input.getSample(0, i) - input.getSample(1, i)) * 0.5;
+                    const auto outputMid   = (output.getSample(0, i) + output.getSample(1, i)) * 0.5;
+                    const auto outputSide  = (output.getSample(0, i) - output.getSample(1, i)) * 0.5;
+                    const auto outputThird = output.getSample(2, i);
+                    maxError = jmax(maxError, std::abs(outputMid - mid.getSample(0, i)), std::abs(outputSide - side));
+                    maxError = jmax(maxError, std::abs(outputThird - input.getSample(2, i)));
+                }
+            }
+
+            expectLessThan(maxError, 1.0e-12);
+        }
+
+        // Left/right sections don't commute with the mid/side matrix
+        beginTest("A left & a side section run in their order");
+        {
+            expectLessThan(getOrderError(ChannelRouting::Left, ChannelRouting::Side, spec, numBlocks), 1.0e-12);
+            expectLessThan(getOrderError(ChannelRouting::Side, ChannelRouting::Left, spec, numBlocks), 1.0e-12);
+        }
+
+        beginTest("The sections of a steep left pass run before a later side band");
+        {
+            using EQ             = EqualizerProcessor;
+            constexpr auto slope = EQ::Butterworth48;
+
+            EqualizerHost host;
+            auto& equalizer = host.getEqualizer();
+            for (int band = 0; band < equalizer.getNumBands(); ++band)
+            { host.setParameter(equalizer.getActiveParamID(band), band < 2 ? 1.0f : 0.0f); }
+            host.setParameter(equalizer.getTypeParamID(0), static_cast<float>(EQ::HighPass));
+            host.setParameter(equalizer.getFrequencyParamID(0), 500.0f);
+            host.setParameter(equalizer.getSlopeParamID(0), static_cast<float>(slope));
+            host.setParameter(equalizer.getRoutingParamID(0), static_cast<float>(ChannelRouting::Left));
+            host.setParameter(equalizer.getTypeParamID(1), static_cast<float>(EQ::Peak));
+            host.setParameter(equalizer.getFrequencyParamID(1), 1000.0f);
+            host.setParameter(equalizer.getQualityParamID(1), 1.0f);
+            host.setParameter(equalizer.getGainParamID(1), 4.0f);
+            host.setParameter(equalizer.getRoutingParamID(1), static_cast<float>(ChannelRouting::Side));
+            host.prepare(sampleRate, blockSize, 2, AudioProcessor::doublePrecision);
+
+            // Reference chain band by band, all sections of the high-pass on
+            // the left channel before the peak on the side signal
+            constexpr auto numSections = size_t {4};
+            expectEquals(static_cast<int>(EQ::getNumSlopeSections(slope)), static_cast<int>(numSections));
+
+            const auto monoSpec = dsp::ProcessSpec {sampleRate, blockSize, 1};
+            std::array<BiquadCascade<double, 1>, numSections + 1> references;
+            std::array<ChannelRouting, numSections + 1> routings {};
+            for (size_t section = 0; section < numSections; ++section)
+            {
+                const auto quality = EQ::getSlopeQuality(slope, numSections, section);
+                const auto c       = BiquadDesigner<double>::makeHighPass(sampleRate, 500.0, quality);
+                references[section].setCoefficients(0, c);
+                routings[section] = ChannelRouting::Left;
+            }
+            const auto peak = BiquadDesigner<double>::makePeakFilter(sampleRate, 1000.0, 1.0, 4.0);
+            references[numSections].setCoefficients(0, peak);
+            routings[numSections] = ChannelRouting::Side;
+            for (auto& reference : references) { reference.prepare(monoSpec); }
+
+            auto random = getRandom();
+            AudioBuffer<double> expected(2, blockSize);
+            AudioBuffer<double> actual(2, blockSize);
+            AudioBuffer<double> routedChannel(1, blockSize);
+            MidiBuffer midi;
+
+            auto maxError = 0.0;
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                fillWithNoise(expected, random);
+                actual.makeCopyOf(expected, true);
+                equalizer.processBlock(actual, midi);
+                for (size_t section = 0; section < references.size(); ++section)
+                { processRouted(expected, references[section], routings[section], routedChannel); }
+
+                for (int channel = 0; channel < 2; ++channel)
+                {
+                    for (int i = 0; i < blockSize; ++i)
+                    {
+                        const auto error = std::abs(expected.getSample(channel, i) - actual.getSample(channel, i));
+                        maxError         = jmax(maxError, error);
+                    }
+                }
+            }
+
+            expectLessThan(maxError, 1.0e-6);
+        }
+
+        beginTest("SvfCascade routing matches the BiquadCascade");
+        {
+            const auto routings = std::array<ChannelRouting, 6> {ChannelRouting::Mid,   ChannelRouting::Left,
+                                                                 ChannelRouting::Side,  ChannelRouting::Stereo,
+                                                                 ChannelRouting::Right, ChannelRouting::Mid};
+
+            BiquadCascade<float, 6> biquads;
+            biquads.prepare(spec);
+            setReferenceSections<BiquadDesigner<double>>(biquads, sampleRate);
+
+            SvfCascade<float, 6> svfs;
+            svfs.prepare(spec);
+            setReferenceSections<SvfDesigner<double>>(svfs, sampleRate);
+
+            for (size_t section = 0; section < routings.size(); ++section)
+            {
+                biquads.setRouting(section, routings[section]);
+                svfs.setRouting(section, routings[section]);
+            }
+
+            auto random = getRandom();
+            AudioBuffer<float> expected(numChannels, blockSize);
+            AudioBuffer<float> actual(numChannels, blockSize);
+
+            auto maxError = 0.0f;
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                fillWithNoise(expected, random);
+                actual.makeCopyOf(expected, true);
+
+                dsp::AudioBlock<float> expectedBlock(expected);
+                dsp::AudioBlock<float> actualBlock(actual);
+                biquads.process(dsp::ProcessContextReplacing<float>(expectedBlock));
+                svfs.process(dsp::ProcessContextReplacing<float>(actualBlock));
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    for (int i = 0; i < blockSize; ++i)
+                    {
+                        const auto error = std::abs(expected.getSample(channel, i) - actual.getSample(channel, i));
+                        maxError         = jmax(maxError, error);
+                    }
+                }
+            }
+
+            expectLessThan(maxError, 1.0e-4f);
+        }
+
+        beginTest("Side bands pass a mono signal unchanged");
+        {
+            EqualizerHost host;
+            auto& equalizer = host.getEqualizer();
+            for (int band = 0; band < equalizer.getNumBands(); ++band)
+            { host.setParameter(equalizer.getRoutingParamID(band), static_cast<float>(ChannelRouting::Side)); }
+            host.prepare(sampleRate, blockSize);
+
+            auto random = getRandom();
+            AudioBuffer<float> input(2, blockSize);
+            AudioBuffer<float> output(2, blockSize);
+            MidiBuffer midi;
+
+            auto maxError = 0.0f;
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                fillWithNoise(input, random);
+                input.copyFrom(1, 0, input, 0, 0, blockSize);
+                output.makeCopyOf(input, true);
+                equalizer.processBlock(output, midi);
+
+                for (int channel = 0; channel < 2; ++channel)
+                {
+                    for (int i = 0; i < blockSize; ++i)
+                    {
+                        const auto error = std::abs(input.getSample(channel, i) - output.getSample(channel, i));
+                        maxError         = jmax(maxError, error);
+                    }
+                }
+            }
+
+            expectLessThan(maxError, 1.0e-6f);
+        }
+    }
+
+private:
+    /**
+     * @brief Largest difference between a cascade of a low pass & a peak with
+     * the given routings & the two filters applied one after the other.
+     */
+    double getOrderError(ChannelRouting first, ChannelRouting second, const dsp::ProcessSpec& spec, int numBlocks)
+    {
+        const auto blockSize = static_cast<int>(spec.maximumBlockSize);
+        const auto lowPass   = BiquadDesigner<double>::makeLowPass(spec.sampleRate, 500.0, 0.707);
+        const auto peak      = BiquadDesigner<double>::makePeakFilter(spec.sampleRate, 1000.0, 1.0, 4.0);
+
+        BiquadCascade<double, 2> routed;
+        routed.prepare(spec);
+        routed.setCoefficients(0, lowPass);
+        routed.setCoefficients(1, peak);
+        routed.setRouting(0, first);
+        routed.setRouting(1, second);
+
+        // Mono reference sections, one per filter
+        const auto monoSpec = dsp::ProcessSpec {spec.sampleRate, spec.maximumBlockSize, 1};
+        std::array<BiquadCascade<double, 1>, 2> references;
+        for (auto& reference : references) { reference.prepare(monoSpec); }
+        references[0].setCoefficients(0, lowPass);
+        references[1].setCoefficients(0, peak);
+
+        auto random = getRandom();
+        AudioBuffer<double> input(static_cast<int>(spec.numChannels), blockSize);
+        AudioBuffer<double> output(static_cast<int>(spec.numChannels), blockSize);
+        AudioBuffer<double> expected(2, blockSize);
+        AudioBuffer<double> routedChannel(1, blockSize);
+
+        auto maxError = 0.0;
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            fillWithNoise(input, random);
+            output.makeCopyOf(input, true);
+            expected.makeCopyOf(input, true);
+
+            dsp::AudioBlock<double> outputBlock(output);
+            routed.process(dsp::ProcessContextReplacing<double>(outputBlock));
+
+            const auto routings = std::array<ChannelRouting, 2> {first, second};
+            for (size_t section = 0; section < routings.size(); ++section)
+            { processRouted(expected, references[section], routings[section], routedChannel); }
+
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    const auto error = std::abs(expected.getSample(channel, i) - output.getSample(channel, i));
+                    maxError         = jmax(maxError, error);
+                }
+            }
+        }
+
+        return maxError;
+    }
+
+    /**
+     * @brief Filters the channel of the first two the routing selects with a
+     * mono section, encoded to mid/side if needed.
+     */
+    static void processRouted(AudioBuffer<double>& buffer, BiquadCascade<double, 1>& section, ChannelRouting routing,
+                              AudioBuffer<double>& routedChannel)
+    {
+        const auto numSamples = buffer.getNumSamples();
+        const auto midSide    = isMidSide(routing);
+        const auto channel    = isRoutedTo(routing, 0) ? size_t {0} : size_t {1};
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto frame = std::array<double, 2> {buffer.getSample(0, i), buffer.getSample(1, i)};
+            if (midSide) { encodeMidSide(frame.data()); }
+            routedChannel.setSample(0, i, frame[channel]);
+        }
+
+        dsp::AudioBlock<double> channelBlock(routedChannel);
+        section.process(dsp::ProcessContextReplacing<double>(channelBlock));
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto frame = std::array<double, 2> {buffer.getSample(0, i), buffer.getSample(1, i)};
+            if (midSide) { encodeMidSide(frame.data()); }
+            frame[channel] = routedChannel.getSample(0, i);
+            if (midSide) { decodeMidSide(frame.data()); }
+            buffer.setSample(0, i, frame[0]);
+            buffer.setSample(1, i, frame[1]);
+        }
+    }
+};
+}  // namespace tobanteAudio::tests
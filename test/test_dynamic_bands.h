@@ -0,0 +1,147 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "processor/band_detector.h"
+#include "processor_host.h"
+
+namespace tobanteAudio::tests
+{
+class TestDynamicBands : public UnitTest
+{
+public:
+    TestDynamicBands() : UnitTest("Dynamic Bands") { }
+
+    void runTest() override
+    {
+        constexpr auto sampleRate = 48000.0;
+
+        beginTest("Detector reduces the gain of loud bands only");
+        {
+            BandDetector<8> detector;
+            detector.prepare(sampleRate, 32);
+            detector.setNumActiveBands(3);
+            detector.setBand(0, 500.0f, 1.0f, -30.0f, 4.0f, 10.0f, 100.0f);
+            detector.setBand(1, 5000.0f, 1.0f, -30.0f, 4.0f, 10.0f, 100.0f);
+            detector.setBand(2, 500.0f, 1.0f, -30.0f, 4.0f, 10.0f, 100.0f);
+            detector.setEnabled(0, true);
+            detector.setEnabled(1, true);
+
+            AudioBuffer<float> buffer(2, 32);
+            auto phase = 0.0;
+            for (int block = 0; block < 3000; ++block)
+            {
+                phase = fillWithSine(buffer, 0.5, 500.0, sampleRate, phase);
+                detector.process(dsp::AudioBlock<float> {buffer});
+            }
+
+            // -6 dBFS is 24 dB over the threshold, 4:1 takes 18 dB off
+            expectWithinAbsoluteError(Decibels::gainToDecibels(detector.getGain(0)), -18.0f, 1.5f);
+            expectGreaterThan(Decibels::gainToDecibels(detector.getGain(1)), -3.0f);
+            expectEquals(detector.getGain(2), 1.0f);
+        }
+
+        beginTest("Dynamic band follows the input level");
+        {
+            EqualizerHost host;
+            auto& equalizer = host.getEqualizer();
+            host.setParameter(equalizer.getDynamicParamID(2), 1.0f);
+            host.setParameter(equalizer.getThresholdParamID(2), -30.0f);
+            host.setParameter(equalizer.getRatioParamID(2), 4.0f);
+            host.prepare(sampleRate, 512);
+
+            // The "Low Mids" peak sits at 500 Hz
+            expectWithinAbsoluteError(measureLevel(host, 0.01, 500.0, sampleRate), -40.0, 0.1);
+            expectWithinAbsoluteError(measureLevel(host, 0.5, 500.0, sampleRate), -24.0, 2.0);
+
+            host.setParameter(equalizer.getDynamicParamID(2), 0.0f);
+            expectWithinAbsoluteError(measureLevel(host, 0.5, 500.0, sampleRate), -6.0, 0.1);
+        }
+
+        beginTest("Band keyed by the sidechain ducks with the sidechain level");
+        {
+            EqualizerHost host;
+            auto& equalizer = host.getEqualizer();
+            host.setParameter(equalizer.getDynamicParamID(2), 1.0f);
+            host.setParameter(equalizer.getThresholdParamID(2), -30.0f);
+            host.setParameter(equalizer.getRatioParamID(2), 4.0f);
+            host.setParameter(equalizer.getKeyParamID(2), 1.0f);
+            host.prepare(sampleRate, 512);
+
+            // A loud input alone doesn't duck, neither does a missing sidechain
+            expectWithinAbsoluteError(measureLevel(host, 0.5, 500.0, sampleRate, 0.01), -6.0, 0.1);
+            expectWithinAbsoluteError(measureLevel(host, 0.01, 500.0, sampleRate, 0.5), -57.0, 2.0);
+            expectWithinAbsoluteError(measureLevel(host, 0.5, 500.0, sampleRate), -6.0, 0.1);
+        }
+    }
+
+private:
+    static double fillWithSine(AudioBuffer<float>& buffer, double amplitude, double frequency, double sampleRate,
+                               double phase)
+    {
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            const auto sample = static_cast<float>(amplitude * std::sin(phase));
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            { buffer.setSample(channel, i, sample); }
+            phase += MathConstants<double>::twoPi * frequency / sampleRate;
+        }
+
+        return phase;
+    }
+
+    /**
+     * @brief Peak level of a sine after the equalizer in dBFS, measured once
+     * the detector has settled. A negative sidechain amplitude leaves the
+     * sidechain disconnected.
+     */
+    static double measureLevel(EqualizerHost& host, double amplitude, double frequency, double sampleRate,
+                               double sidechainAmplitude = -1.0)
+    {
+        constexpr auto blockSize = 512;
+        constexpr auto numBlocks = 192;
+        constexpr auto numSkip   = 160;
+
+        AudioBuffer<float> buffer(2, blockSize);
+        AudioBuffer<float> sidechain(sidechainAmplitude < 0.0 ? 0 : 2, blockSize);
+        MidiBuffer midi;
+
+        auto phase      = 0.0;
+        auto sumSquares = 0.0;
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            fillWithSine(sidechain, sidechainAmplitude, frequency, sampleRate, phase);
+            phase = fillWithSine(buffer, amplitude, frequency, sampleRate, phase);
+
+            host.getEqualizer().setSidechain(sidechainAmplitude < 0.0 ? nullptr : &sidechain);
+            host.getEqualizer().processBlock(buffer, midi);
+            if (block < numSkip) { continue; }
+
+            for (int i = 0; i < blockSize; ++i) { sumSquares += square(static_cast<double>(buffer.getSample(0, i))); }
+        }
+        host.getEqualizer().setSidechain(static_cast<const AudioBuffer<float>*>(nullptr));
+
+        // A sine has an RMS of 1 / sqrt(2)
+        const auto rms = std::sqrt(sumSquares / ((numBlocks - numSkip) * blockSize));
+        return Decibels::gainToDecibels(rms * MathConstants<double>::sqrt2, -200.0);
+    }
+};
+}  // namespace tobanteAudio::tests
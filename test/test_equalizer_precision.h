@@ -0,0 +1,138 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "benchmark.h"
+#include "processor/biquad_cascade.h"
+#include "processor/biquad_designer.h"
+#include "processor_host.h"
+
+namespace tobanteAudio::tests
+{
+class TestEqualizerPrecision : public UnitTest
+{
+public:
+    TestEqualizerPrecision() : UnitTest("Equalizer Precision") { }
+
+    void runTest() override
+    {
+        beginTest("Double precision path matches the float path");
+        {
+            constexpr auto sampleRate = 48000.0;
+            constexpr auto blockSize  = 512;
+            constexpr auto numBlocks  = 16;
+
+            EqualizerHost singleHost;
+            EqualizerHost doubleHost;
+            singleHost.prepare(sampleRate, blockSize);
+            doubleHost.prepare(sampleRate, blockSize, 2, AudioProcessor::doublePrecision);
+
+            auto random = getRandom();
+            AudioBuffer<float> singleBuffer(2, blockSize);
+            AudioBuffer<double> doubleBuffer(2, blockSize);
+            MidiBuffer midi;
+
+            auto maxError = 0.0;
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                fillWithNoise(singleBuffer, random);
+                doubleBuffer.makeCopyOf(singleBuffer);
+
+                singleHost.getEqualizer().processBlock(singleBuffer, midi);
+                doubleHost.getEqualizer().processBlock(doubleBuffer, midi);
+
+                for (int channel = 0; channel < 2; ++channel)
+                {
+                    for (int i = 0; i < blockSize; ++i)
+                    {
+                        const auto expected = static_cast<double>(singleBuffer.getSample(channel, i));
+                        const auto error    = std::abs(expected - doubleBuffer.getSample(channel, i));
+                        maxError            = jmax(maxError, error);
+                    }
+                }
+            }
+
+            expectLessThan(maxError, 1.0e-3);
+        }
+
+        beginTest("Double precision avoids quantisation of low & narrow peaks");
+        {
+            // 30 Hz, Q 10 at 192 kHz puts the poles very close to the unit circle
+            constexpr auto sampleRate = 192000.0;
+            constexpr auto blockSize  = 4096;
+            constexpr auto numBlocks  = 8;
+
+            const auto coefficients = BiquadDesigner<double>::makePeakFilter(sampleRate, 30.0, 10.0, 4.0);
+            const auto spec         = dsp::ProcessSpec {sampleRate, blockSize, 1};
+
+            BiquadCascade<float, 1> singleCascade;
+            BiquadCascade<double, 1> doubleCascade;
+            singleCascade.prepare(spec);
+            doubleCascade.prepare(spec);
+            singleCascade.setCoefficients(0, coefficients);
+            doubleCascade.setCoefficients(0, coefficients);
+
+            auto random = getRandom();
+            AudioBuffer<float> input(1, blockSize);
+            AudioBuffer<float> singleBuffer(1, blockSize);
+            AudioBuffer<double> doubleBuffer(1, blockSize);
+
+            // Reference in long double with the unrounded coefficients
+            auto s1          = 0.0L;
+            auto s2          = 0.0L;
+            auto singleError = 0.0L;
+            auto doubleError = 0.0L;
+            auto energy      = 0.0L;
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                fillWithNoise(input, random);
+                singleBuffer.makeCopyOf(input);
+                doubleBuffer.makeCopyOf(input);
+
+                dsp::AudioBlock<float> singleBlock(singleBuffer);
+                dsp::AudioBlock<double> doubleBlock(doubleBuffer);
+                singleCascade.process(dsp::ProcessContextReplacing<float>(singleBlock));
+                doubleCascade.process(dsp::ProcessContextReplacing<double>(doubleBlock));
+
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    const auto x = static_cast<long double>(input.getSample(0, i));
+                    const auto y = x * coefficients.b0 + s1;
+                    s1           = x * coefficients.b1 - y * coefficients.a1 + s2;
+                    s2           = x * coefficients.b2 - y * coefficients.a2;
+
+                    singleError += square(singleBuffer.getSample(0, i) - y);
+                    doubleError += square(doubleBuffer.getSample(0, i) - y);
+                    energy += square(y);
+                }
+            }
+
+            const auto singleRelativeError = static_cast<double>(std::sqrt(singleError / energy));
+            const auto doubleRelativeError = static_cast<double>(std::sqrt(doubleError / energy));
+            logMessage("Relative error float: " + String(singleRelativeError) + ", double: "
+                       + String(doubleRelativeError));
+
+            expectLessThan(doubleRelativeError, 1.0e-9);
+            expectGreaterThan(singleRelativeError, doubleRelativeError * 1000.0);
+        }
+    }
+};
+}  // namespace tobanteAudio::tests
@@ -0,0 +1,170 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "parameters/parameters.h"
+#include "processor/biquad_designer.h"
+#include "processor_host.h"
+
+namespace tobanteAudio::tests
+{
+class TestFilterSlopes : public UnitTest
+{
+public:
+    TestFilterSlopes() : UnitTest("Filter Slopes") { }
+
+    void runTest() override
+    {
+        using EQ = EqualizerProcessor;
+
+        constexpr auto sampleRate = 48000.0;
+        constexpr auto cutoff     = 1000.0;
+
+        for (int slope = EQ::Butterworth24; slope < EQ::LastSlopeID; ++slope)
+        {
+            const auto filterSlope = static_cast<EQ::FilterSlope>(slope);
+            beginTest("High-pass sections follow " + EQ::getFilterSlopeName(filterSlope));
+
+            const auto numSections     = EQ::getNumSlopeSections(filterSlope);
+            const auto isLinkwitzRiley = slope % 2 == 0;
+            const auto octave          = getMagnitude(filterSlope, cutoff / 8.0, cutoff, sampleRate)
+                                / getMagnitude(filterSlope, cutoff / 4.0, cutoff, sampleRate);
+
+            // Both designs fall with 12 dB/oct per section, Butterworth is
+            // 3 dB & Linkwitz-Riley 6 dB down at the cutoff
+            const auto atCutoff = Decibels::gainToDecibels(getMagnitude(filterSlope, cutoff, cutoff, sampleRate));
+            expectWithinAbsoluteError(Decibels::gainToDecibels(octave, -400.0), -12.04 * numSections, 0.5);
+            expectWithinAbsoluteError(atCutoff, isLinkwitzRiley ? -6.02 : -3.01, 0.05);
+        }
+
+        beginTest("Steep bands are applied by the equalizer");
+        {
+            EqualizerHost host;
+            host.setParameter(host.getEqualizer().getFrequencyParamID(0), static_cast<float>(cutoff));
+            host.setParameter(host.getEqualizer().getSlopeParamID(0), static_cast<float>(EQ::Butterworth96));
+            host.setParameter(host.getEqualizer().getSlopeParamID(5), static_cast<float>(EQ::LinkwitzRiley96));
+            host.prepare(sampleRate, 512);
+
+            // The low-pass of the last band takes the next slope sections
+            expectLessThan(measureGain(host, cutoff / 2.0, sampleRate), -90.0);
+            expectWithinAbsoluteError(measureGain(host, cutoff * 4.0, sampleRate), 0.0, 0.1);
+            expectWithinAbsoluteError(measureGain(host, 12000.0, sampleRate), -6.02, 0.2);
+
+            host.setParameter(host.getEqualizer().getSlopeParamID(0), static_cast<float>(EQ::Slope12));
+            expectWithinAbsoluteError(measureGain(host, cutoff / 2.0, sampleRate), -12.3, 0.5);
+        }
+
+        beginTest("Slopes beyond the shared sections are lowered & plotted as heard");
+        {
+            EqualizerHost host;
+            auto& equalizer = host.getEqualizer();
+            for (int i = 0; i < 5; ++i)
+            {
+                host.setParameter(equalizer.getTypeParamID(i), static_cast<float>(EQ::HighPass));
+                host.setParameter(equalizer.getFrequencyParamID(i), 100.0f + 10.0f * static_cast<float>(i));
+                host.setParameter(equalizer.getSlopeParamID(i), static_cast<float>(EQ::LinkwitzRiley96));
+                host.setParameter(equalizer.getActiveParamID(i), 1.0f);
+            }
+            host.prepare(sampleRate, 512);
+            equalizer.handleBandChanges();
+            equalizer.updateResponsesNow();
+
+            // Four bands take all sections, the fifth is left with one
+            for (int i = 0; i < 4; ++i) { expectEquals(int(equalizer.getBand(i)->slope), int(EQ::LinkwitzRiley96)); }
+            expectEquals(int(equalizer.getBand(4)->slope), int(EQ::Slope12));
+
+            const auto& frequencies = equalizer.getFrequencies();
+            const auto& magnitudes  = equalizer.getMagnitudes();
+            for (const auto frequency : {160.0, 300.0, 1000.0})
+            {
+                const auto index = static_cast<size_t>(
+                    std::lower_bound(frequencies.begin(), frequencies.end(), frequency) - frequencies.begin());
+                const auto plotted = Decibels::gainToDecibels(magnitudes[index], -200.0);
+                expectWithinAbsoluteError(measureGain(host, frequencies[index], sampleRate), plotted, 0.2);
+            }
+
+            // Freed sections are available again
+            host.setParameter(equalizer.getSlopeParamID(0), static_cast<float>(EQ::Slope12));
+            host.setParameter(equalizer.getSlopeParamID(4), static_cast<float>(EQ::LinkwitzRiley96));
+            equalizer.handleBandChanges();
+            expectEquals(int(equalizer.getBand(4)->slope), int(EQ::LinkwitzRiley96));
+        }
+    }
+
+private:
+    /**
+     * @brief Magnitude of the high-pass cascade a band with the given slope is
+     * made of.
+     */
+    static double getMagnitude(EqualizerProcessor::FilterSlope slope, double frequency, double cutoff,
+                               double sampleRate)
+    {
+        const auto numSections = EqualizerProcessor::getNumSlopeSections(slope);
+        const auto z           = std::polar(1.0, -MathConstants<double>::twoPi * frequency / sampleRate);
+
+        auto magnitude = 1.0;
+        for (size_t i = 0; i < numSections; ++i)
+        {
+            const auto quality = EqualizerProcessor::getSlopeQuality(slope, numSections, i);
+            const auto c       = BiquadDesigner<double>::makeHighPass(sampleRate, cutoff, quality);
+            magnitude *= std::abs((c.b0 + c.b1 * z + c.b2 * z * z) / (1.0 + c.a1 * z + c.a2 * z * z));
+        }
+
+        return magnitude;
+    }
+
+    /**
+     * @brief Level of a sine after the equalizer in dB, measured once the
+     * filters have settled.
+     */
+    static double measureGain(EqualizerHost& host, double frequency, double sampleRate)
+    {
+        constexpr auto blockSize = 512;
+        constexpr auto numBlocks = 96;
+        constexpr auto numSkip   = 64;
+
+        AudioBuffer<float> buffer(2, blockSize);
+        MidiBuffer midi;
+
+        auto phase      = 0.0;
+        auto sumSquares = 0.0;
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const auto sample = static_cast<float>(std::sin(phase));
+                buffer.setSample(0, i, sample);
+                buffer.setSample(1, i, sample);
+                phase += MathConstants<double>::twoPi * frequency / sampleRate;
+            }
+
+            host.getEqualizer().processBlock(buffer, midi);
+            if (block < numSkip) { continue; }
+
+            for (int i = 0; i < blockSize; ++i) { sumSquares += square(static_cast<double>(buffer.getSample(0, i))); }
+        }
+
+        // A sine has an RMS of 1 / sqrt(2)
+        const auto rms = std::sqrt(sumSquares / ((numBlocks - numSkip) * blockSize));
+        return Decibels::gainToDecibels(rms * MathConstants<double>::sqrt2, -200.0);
+    }
+};
+}  // namespace tobanteAudio::tests
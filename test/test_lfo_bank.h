@@ -0,0 +1,113 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "processor/lfo_bank.h"
+
+namespace tobanteAudio::tests
+{
+class TestLfoBank : public UnitTest
+{
+public:
+    TestLfoBank() : UnitTest("LFO Bank") { }
+
+    void runTest() override
+    {
+        // A 1Hz LFO at 1kHz is sampled at quarter periods by steps of 250
+        constexpr auto sampleRate = 1000.0;
+        constexpr auto quarter    = 250;
+
+        beginTest("Shapes at quarter periods");
+        {
+            const auto expected = std::array<std::array<float, 4>, 4> {{
+                {0.0f, 1.0f, 0.0f, -1.0f},     // Sine
+                {0.0f, 1.0f, 0.0f, -1.0f},     // Triangle
+                {-1.0f, -0.5f, 0.0f, 0.5f},    // Saw
+                {1.0f, 1.0f, -1.0f, -1.0f},    // Square
+            }};
+
+            LfoBank bank;
+            bank.prepare(sampleRate);
+            for (size_t lfo = 0; lfo < LfoBank::numLfos; ++lfo)
+            {
+                bank.setFrequency(lfo, 1.0f);
+                bank.setShape(lfo, static_cast<LfoBank::Shape>(lfo % expected.size()));
+            }
+
+            for (size_t step = 0; step < 8; ++step)
+            {
+                const auto* values = bank.process(quarter);
+                for (size_t lfo = 0; lfo < LfoBank::numLfos; ++lfo)
+                { expectWithinAbsoluteError(values[lfo], expected[lfo % expected.size()][step % 4], 1.0e-4f); }
+            }
+        }
+
+        beginTest("Every LFO has its own frequency & gain");
+        {
+            LfoBank bank;
+            bank.prepare(sampleRate);
+            bank.setFrequency(0, 1.0f);
+            bank.setFrequency(1, 2.0f);
+            bank.setGain(1, 0.5f);
+
+            bank.process(quarter / 2);
+            const auto* values = bank.getValues();
+            expectWithinAbsoluteError(values[0], 0.0f, 1.0e-6f);
+
+            // An eighth period of the first is a quarter period of the second
+            values = bank.process(quarter);
+            expectWithinAbsoluteError(values[0], std::sin(MathConstants<float>::halfPi / 2.0f), 1.0e-4f);
+            expectWithinAbsoluteError(values[1], 0.5f, 1.0e-4f);
+        }
+
+        beginTest("Sample & hold changes once per period");
+        {
+            LfoBank bank;
+            bank.prepare(sampleRate);
+            bank.setFrequency(0, 1.0f);
+            bank.setShape(0, LfoBank::SampleAndHold);
+
+            auto numChanges = 0;
+            auto previous   = bank.process(quarter)[0];
+            for (int step = 1; step < 40; ++step)
+            {
+                const auto value = bank.process(quarter)[0];
+                expect(value >= -1.0f && value <= 1.0f);
+                if (value != previous) { ++numChanges; }
+                if (step % 4 != 0) { expectEquals(value, previous); }
+                previous = value;
+            }
+
+            // Two draws in a row may only match by chance
+            expectGreaterThan(numChanges, 5);
+        }
+
+        beginTest("Phases wrap for long steps");
+        {
+            LfoBank bank;
+            bank.prepare(sampleRate);
+            bank.setFrequency(0, 3.0f);
+            bank.process(2250);
+            expectWithinAbsoluteError(bank.process(quarter)[0], -1.0f, 1.0e-4f);
+        }
+    }
+};
+}  // namespace tobanteAudio::tests
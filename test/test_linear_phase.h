@@ -0,0 +1,130 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "benchmark.h"
+#include "parameters/parameters.h"
+#include "processor/linear_phase_designer.h"
+#include "processor/partitioned_convolver.h"
+#include "processor_host.h"
+
+namespace tobanteAudio::tests
+{
+class TestLinearPhase : public UnitTest
+{
+public:
+    TestLinearPhase() : UnitTest("Linear Phase") { }
+
+    void runTest() override
+    {
+        constexpr auto sampleRate = 48000.0;
+        constexpr auto blockSize  = 512;
+
+        beginTest("Partitioned convolution matches direct convolution");
+        {
+            constexpr auto partitionSize = 64;
+            constexpr auto kernelLength  = 300;
+            constexpr auto numSamples    = 2048;
+
+            auto random = getRandom();
+            std::vector<float> kernel(kernelLength);
+            for (auto& tap : kernel) { tap = random.nextFloat() * 2.0f - 1.0f; }
+
+            PartitionedConvolver convolver;
+            convolver.prepare(1, partitionSize, kernelLength);
+            convolver.setKernel(kernel.data(), kernelLength);
+
+            AudioBuffer<float> buffer(1, numSamples);
+            fillWithNoise(buffer, random);
+            AudioBuffer<float> input;
+            input.makeCopyOf(buffer);
+
+            // Odd sized chunks, so the partitions don't line up with the blocks
+            const auto fullBlock = dsp::AudioBlock<float> {buffer};
+            for (size_t start = 0; start < numSamples; start += 100)
+            {
+                auto block = fullBlock.getSubBlock(start, jmin<size_t>(100, numSamples - start));
+                convolver.process(dsp::ProcessContextReplacing<float>(block));
+            }
+
+            // The first partition fades the kernel in
+            auto maxError = 0.0;
+            for (auto i = 2 * partitionSize; i < numSamples; ++i)
+            {
+                auto expected = 0.0;
+                for (auto k = 0; k < kernelLength && k <= i - partitionSize; ++k)
+                { expected += kernel[static_cast<size_t>(k)] * input.getSample(0, i - partitionSize - k); }
+                maxError = jmax(maxError, std::abs(expected - buffer.getSample(0, i)));
+            }
+
+            expectLessThan(maxError, 1.0e-4);
+        }
+
+        beginTest("Designed kernel is symmetric");
+        {
+            std::vector<double> frequencies {20.0, 200.0, 2000.0, 20000.0};
+            std::vector<double> magnitudes {0.5, 2.0, 1.0, 0.25};
+            std::vector<float> kernel(1023);
+            LinearPhaseDesigner::designKernel(frequencies, magnitudes, sampleRate, kernel);
+
+            for (size_t i = 0; i < kernel.size() / 2; ++i)
+            { expectWithinAbsoluteError(kernel[i], kernel[kernel.size() - 1 - i], 1.0e-6f); }
+        }
+
+        beginTest("Linear phase reports its latency & delays a flat response");
+        {
+            EqualizerHost host;
+            auto& equalizer = host.getEqualizer();
+            host.prepare(sampleRate, blockSize);
+            expectEquals(equalizer.getLatencySamples(), 0);
+
+            host.setParameter(Parameters::Phase, 1.0f);
+            const auto latency = equalizer.getLatencySamples();
+            expectEquals(latency, LINEAR_PHASE_PARTITION_SIZE + (LINEAR_PHASE_FFT_SIZE - 2) / 2);
+
+            auto random = getRandom();
+            constexpr auto numBlocks = 64;
+            AudioBuffer<float> input(1, blockSize * numBlocks);
+            fillWithNoise(input, random);
+            AudioBuffer<float> output(1, blockSize * numBlocks);
+            AudioBuffer<float> buffer(2, blockSize);
+            MidiBuffer midi;
+
+            for (auto block = 0; block < numBlocks; ++block)
+            {
+                for (auto channel = 0; channel < 2; ++channel)
+                { buffer.copyFrom(channel, 0, input, 0, block * blockSize, blockSize); }
+                equalizer.processBlock(buffer, midi);
+                output.copyFrom(0, block * blockSize, buffer, 0, 0, blockSize);
+            }
+
+            auto maxError = 0.0f;
+            for (auto i = latency + blockSize; i < output.getNumSamples(); ++i)
+            { maxError = jmax(maxError, std::abs(output.getSample(0, i) - input.getSample(0, i - latency))); }
+            expectLessThan(maxError, 1.0e-3f);
+
+            host.setParameter(Parameters::Phase, 0.0f);
+            expectEquals(equalizer.getLatencySamples(), 0);
+        }
+    }
+};
+}  // namespace tobanteAudio::tests
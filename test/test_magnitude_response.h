@@ -0,0 +1,91 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "processor/biquad_designer.h"
+#include "processor/magnitude_response.h"
+
+namespace tobanteAudio::tests
+{
+class TestMagnitudeResponse : public UnitTest
+{
+public:
+    TestMagnitudeResponse() : UnitTest("Magnitude Response") { }
+
+    void runTest() override
+    {
+        using Designer = BiquadDesigner<double>;
+
+        constexpr auto sampleRate = 48000.0;
+        std::vector<double> frequencies(300);
+        for (size_t i = 0; i < frequencies.size(); ++i) { frequencies[i] = 20.0 * std::pow(2.0, i / 30.0); }
+
+        MagnitudeResponse response;
+        response.prepare(frequencies, sampleRate);
+        std::vector<double> actual(frequencies.size());
+        std::vector<double> expected(frequencies.size());
+        std::vector<double> product(frequencies.size());
+
+        const auto sections = std::array<Designer::Coefficients, 6> {
+            Designer::makeHighPass(sampleRate, 2000.0, 0.7),
+            Designer::makeLowPass(sampleRate, 50.0, 0.7),
+            Designer::makePeakFilter(sampleRate, 1000.0, 5.0, 4.0),
+            Designer::makeLowShelf(sampleRate, 200.0, 0.7, 0.25),
+            Designer::makeHighShelf(sampleRate, 8000.0, 0.7, 4.0),
+            Designer::makeBandPass(sampleRate, 300.0, 3.0),
+        };
+
+        beginTest("Single sections match the JUCE evaluation");
+        std::fill(product.begin(), product.end(), 1.0);
+        for (const auto& section : sections)
+        {
+            response.process(&section, 1, actual.data());
+            getReference(section, frequencies, sampleRate, expected);
+            expectLessThan(getMaxRelativeError(actual, expected), 1.0e-9);
+            for (size_t i = 0; i < product.size(); ++i) { product[i] *= expected[i]; }
+        }
+
+        beginTest("Cascades are the product of their sections");
+        response.process(sections.data(), sections.size(), actual.data());
+        expectLessThan(getMaxRelativeError(actual, product), 1.0e-9);
+
+        beginTest("No sections give a flat response");
+        response.process(sections.data(), 0, actual.data());
+        for (const auto magnitude : actual) { expectEquals(magnitude, 1.0); }
+    }
+
+private:
+    static void getReference(const BiquadCoefficients<double>& c, const std::vector<double>& frequencies,
+                             double sampleRate, std::vector<double>& magnitudes)
+    {
+        const auto coefficients = dsp::IIR::Coefficients<double>(c.b0, c.b1, c.b2, 1.0, c.a1, c.a2);
+        coefficients.getMagnitudeForFrequencyArray(frequencies.data(), magnitudes.data(), frequencies.size(),
+                                                   sampleRate);
+    }
+
+    static double getMaxRelativeError(const std::vector<double>& actual, const std::vector<double>& expected)
+    {
+        auto maxError = 0.0;
+        for (size_t i = 0; i < actual.size(); ++i)
+        { maxError = jmax(maxError, std::abs(actual[i] - expected[i]) / jmax(expected[i], 1.0e-12)); }
+        return maxError;
+    }
+};
+}  // namespace tobanteAudio::tests
@@ -15,6 +15,35 @@
  */
 
 #include "test_main.h"
+#include "benchmark.h"
+#include "benchmark_batch_designer.h"
+#include "benchmark_biquad_cascade.h"
+#include "benchmark_dynamic_bands.h"
+#include "benchmark_lfo_bank.h"
+#include "benchmark_magnitude_response.h"
+#include "benchmark_modulation_matrix.h"
+#include "benchmark_pipeline.h"
+#include "benchmark_precision.h"
+#include "benchmark_smoothing.h"
+#include "benchmark_svf_cascade.h"
+#include "test_batch_designer.h"
+#include "test_biquad_cascade.h"
+#include "test_channel_layouts.h"
+#include "test_channel_routing.h"
+#include "test_dynamic_bands.h"
+#include "test_equalizer_precision.h"
+#include "test_filter_slopes.h"
+#include "test_lfo_bank.h"
+#include "test_linear_phase.h"
+#include "test_magnitude_response.h"
+#include "test_matched_designer.h"
+#include "test_modulation_matrix.h"
+#include "test_oversampling.h"
+#include "test_parameter_dispatch.h"
+#include "test_response_grid.h"
+#include "test_silence.h"
+#include "test_sub_blocks.h"
+#include "test_svf_cascade.h"
 #include "test_text_converters.h"
 
 namespace tobanteAudio::tests
@@ -23,10 +52,52 @@ namespace tobanteAudio::tests
 // returned by UnitTest::getAllTests(), so the test will be included when you
 // call UnitTestRunner::runAllTests()
 static TestTextValueConverters test_text_value_converters;
+static TestBiquadCascade test_biquad_cascade;
+static TestEqualizerPrecision test_equalizer_precision;
+static TestOversampling test_oversampling;
+static TestLinearPhase test_linear_phase;
+static TestMatchedDesigner test_matched_designer;
+static TestSvfCascade test_svf_cascade;
+static TestFilterSlopes test_filter_slopes;
+static TestDynamicBands test_dynamic_bands;
+static TestChannelRouting test_channel_routing;
+static TestChannelLayouts test_channel_layouts;
+static TestSilence test_silence;
+static TestSubBlocks test_sub_blocks;
+static TestParameterDispatch test_parameter_dispatch;
+static TestBatchDesigner test_batch_designer;
+static TestMagnitudeResponse test_magnitude_response;
+static TestResponseGrid test_response_grid;
+static TestModulationMatrix test_modulation_matrix;
+static TestLfoBank test_lfo_bank;
+
+// Benchmarks
+static BenchmarkBiquadCascade benchmark_biquad_cascade;
+static BenchmarkSmoothing benchmark_smoothing;
+static BenchmarkPrecision benchmark_precision;
+static BenchmarkSvfCascade benchmark_svf_cascade;
+static BenchmarkDynamicBands benchmark_dynamic_bands;
+static BenchmarkPipeline benchmark_pipeline;
+static BenchmarkBatchDesigner benchmark_batch_designer;
+static BenchmarkMagnitudeResponse benchmark_magnitude_response;
+static BenchmarkModulationMatrix benchmark_modulation_matrix;
+static BenchmarkLfoBank benchmark_lfo_bank;
 
 void run()
+{
+    Array<UnitTest*> tests;
+    for (auto* test : UnitTest::getAllTests())
+    {
+        if (test->getCategory() != BenchmarkCategory) { tests.add(test); }
+    }
+
+    UnitTestRunner testRunner;
+    testRunner.runTests(tests);
+}
+
+void runBenchmarks()
 {
     UnitTestRunner testRunner;
-    testRunner.runAllTests();
+    testRunner.runTestsInCategory(BenchmarkCategory);
 }
 }  // namespace tobanteAudio::tests
\ No newline at end of file
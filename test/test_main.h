@@ -22,5 +22,13 @@
 // tobanteAudio
 namespace tobanteAudio::tests
 {
+/**
+ * @brief Runs all unit tests, except the benchmarks.
+ */
 void run();
+
+/**
+ * @brief Runs the performance measurements.
+ */
+void runBenchmarks();
 }
\ No newline at end of file
@@ -0,0 +1,148 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "processor/biquad_designer.h"
+#include "processor/matched_designer.h"
+
+namespace tobanteAudio::tests
+{
+class TestMatchedDesigner : public UnitTest
+{
+public:
+    TestMatchedDesigner() : UnitTest("Matched Designer") { }
+
+    void runTest() override
+    {
+        constexpr auto sampleRate = 48000.0;
+        constexpr auto Q          = 0.707;
+
+        for (const auto frequency : {1000.0, 10000.0, 16000.0})
+        {
+            for (const auto gain : {0.25, 4.0})
+            {
+                beginTest("Matched design follows the analog response at " + String(frequency) + " Hz, gain "
+                          + String(gain));
+
+                const auto A     = std::sqrt(gain);
+                const auto sqrtA = std::sqrt(A);
+                const auto peak  = Analog {1.0, A / Q, 1.0, 1.0, 1.0 / (A * Q), 1.0};
+                const auto low   = Analog {A, A * sqrtA / Q, A * A, A, sqrtA / Q, 1.0};
+                const auto high  = Analog {A * A, A * sqrtA / Q, A, 1.0, sqrtA / Q, A};
+
+                using Bilinear = BiquadDesigner<double>;
+                using Matched  = MatchedDesigner<double>;
+
+                const auto bilinearPeak = error(Bilinear::makePeakFilter(sampleRate, frequency, Q, gain), peak,
+                                                frequency, sampleRate);
+                const auto matchedPeak
+                    = error(Matched::makePeakFilter(sampleRate, frequency, Q, gain), peak, frequency, sampleRate);
+                const auto bilinearLow = error(Bilinear::makeLowShelf(sampleRate, frequency, Q, gain), low,
+                                               frequency, sampleRate);
+                const auto matchedLow
+                    = error(Matched::makeLowShelf(sampleRate, frequency, Q, gain), low, frequency, sampleRate);
+                const auto bilinearHigh = error(Bilinear::makeHighShelf(sampleRate, frequency, Q, gain), high,
+                                                frequency, sampleRate);
+                const auto matchedHigh
+                    = error(Matched::makeHighShelf(sampleRate, frequency, Q, gain), high, frequency, sampleRate);
+
+                expectLessOrEqual(matchedPeak, bilinearPeak);
+                expectLessOrEqual(matchedLow, bilinearLow);
+                expectLessOrEqual(matchedHigh, bilinearHigh);
+                expectLessThan(matchedPeak, 1.5);
+                expectLessThan(matchedLow, 0.5);
+                expectLessThan(matchedHigh, 0.5);
+            }
+        }
+
+        beginTest("Matched pass filters follow the analog response near Nyquist");
+        {
+            const auto lowPass  = Analog {0.0, 0.0, 1.0, 1.0, 1.0 / Q, 1.0};
+            const auto highPass = Analog {1.0, 0.0, 0.0, 1.0, 1.0 / Q, 1.0};
+            const auto bandPass = Analog {0.0, 1.0 / Q, 0.0, 1.0, 1.0 / Q, 1.0};
+
+            for (const auto frequency : {10000.0, 16000.0})
+            {
+                expectLessThan(error(MatchedDesigner<double>::makeLowPass(sampleRate, frequency, Q), lowPass,
+                                     frequency, sampleRate),
+                               1.0);
+                expectLessThan(error(MatchedDesigner<double>::makeHighPass(sampleRate, frequency, Q), highPass,
+                                     frequency, sampleRate),
+                               1.0);
+                expectLessThan(error(MatchedDesigner<double>::makeBandPass(sampleRate, frequency, Q), bandPass,
+                                     frequency, sampleRate),
+                               1.0);
+            }
+        }
+    }
+
+private:
+    /**
+     * @brief Analog prototype (n2 s^2 + n1 s + n0) / (d2 s^2 + d1 s + d0),
+     * normalised to the centre frequency.
+     */
+    struct Analog
+    {
+        double n2, n1, n0;
+        double d2, d1, d0;
+
+        double getMagnitude(double w) const
+        {
+            const auto s = std::complex<double> {0.0, w};
+            return std::abs((n2 * s * s + n1 * s + n0) / (d2 * s * s + d1 * s + d0));
+        }
+    };
+
+    static double getMagnitude(const BiquadCoefficients<double>& c, double w)
+    {
+        const auto z = std::polar(1.0, -w);
+        return std::abs((c.b0 + c.b1 * z + c.b2 * z * z) / (1.0 + c.a1 * z + c.a2 * z * z));
+    }
+
+    /**
+     * @brief Largest deviation from the analog magnitude in dB between 20 Hz
+     * and 20 kHz. Ignores the stop band 40 dB below the peak.
+     */
+    static double error(const BiquadCoefficients<double>& c, const Analog& analog, double frequency, double sampleRate)
+    {
+        constexpr auto numPoints = 200;
+
+        auto peak = 0.0;
+        for (int i = 0; i < numPoints; ++i) { peak = jmax(peak, analog.getMagnitude(getFrequency(i) / frequency)); }
+
+        auto maxError = 0.0;
+        for (int i = 0; i < numPoints; ++i)
+        {
+            const auto f        = getFrequency(i);
+            const auto expected = analog.getMagnitude(f / frequency);
+            if (expected < peak * 0.01) { continue; }
+
+            const auto actual = getMagnitude(c, MathConstants<double>::twoPi * f / sampleRate);
+            maxError          = jmax(maxError, std::abs(Decibels::gainToDecibels(actual / expected, -200.0)));
+        }
+
+        return maxError;
+    }
+
+    static double getFrequency(int index) { return 20.0 * std::pow(1000.0, index / 199.0); }
+};
+}  // namespace tobanteAudio::tests
@@ -0,0 +1,260 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "processor/modulation_matrix.h"
+#include "processor_host.h"
+
+namespace tobanteAudio::tests
+{
+class TestModulationMatrix : public UnitTest
+{
+public:
+    TestModulationMatrix() : UnitTest("Modulation Matrix") { }
+
+    void runTest() override
+    {
+        using Connection = ModulationMatrix::Connection;
+
+        const auto frequencyTarget = ModulationTarget {ModulationParameter::Frequency, 2};
+        const auto outputTarget    = ModulationTarget {ModulationParameter::Output, -1};
+        const auto sources         = std::array<float, MODULATION_MAX_SOURCES> {1.0f, -1.0f};
+
+        beginTest("An empty matrix is not evaluated");
+        {
+            ValueTree tree("state");
+            ModulationMatrix matrix(tree);
+            expect(!matrix.acquireConnections());
+            expect(matrix.getConnections().empty());
+        }
+
+        beginTest("Connections are scaled by their depth");
+        {
+            ValueTree tree("state");
+            ModulationMatrix matrix(tree);
+            matrix.setConnection(Connection {0, frequencyTarget, 0.5f, true});
+            matrix.setConnection(Connection {1, outputTarget, 0.5f, true});
+            expectEquals(static_cast<int>(matrix.getConnections().size()), 2);
+
+            expect(matrix.acquireConnections());
+            const auto bands = matrix.process(sources.data(), sources.size());
+            expect(bands == uint64 {1} << 2);
+
+            const auto& modulation = matrix.getBandModulation(2);
+            expectWithinAbsoluteError(modulation.frequency, std::exp2(0.5f * MODULATION_FREQUENCY_OCTAVES), 1.0e-5f);
+            expectEquals(modulation.quality, 1.0f);
+            expectEquals(modulation.gain, 1.0f);
+
+            const auto outputGain = Decibels::decibelsToGain(-0.5f * MODULATION_GAIN_DB);
+            expectWithinAbsoluteError(matrix.getOutputGain(), outputGain, 1.0e-6f);
+
+            // Updating the same source & target keeps a single connection
+            matrix.setConnection(Connection {0, frequencyTarget, -0.5f, true});
+            expectEquals(static_cast<int>(matrix.getConnections().size()), 2);
+            matrix.acquireConnections();
+            matrix.process(sources.data(), sources.size());
+            const auto expected = std::exp2(-0.5f * MODULATION_FREQUENCY_OCTAVES);
+            expectWithinAbsoluteError(matrix.getBandModulation(2).frequency, expected, 1.0e-5f);
+        }
+
+        beginTest("Disconnected targets return to their parameters");
+        {
+            ValueTree tree("state");
+            ModulationMatrix matrix(tree);
+            matrix.setConnection(Connection {0, frequencyTarget, 0.5f, true});
+            matrix.acquireConnections();
+            matrix.process(sources.data(), sources.size());
+
+            // Bypassed connections are not evaluated
+            matrix.setConnection(Connection {0, frequencyTarget, 0.5f, false});
+            expect(matrix.acquireConnections());
+            expect(matrix.process(sources.data(), sources.size()) == uint64 {1} << 2);
+            expectEquals(matrix.getBandModulation(2).frequency, 1.0f);
+            expect(!matrix.acquireConnections());
+
+            matrix.setConnection(Connection {0, frequencyTarget, 0.5f, true});
+            matrix.removeConnection(0, frequencyTarget);
+            expect(!matrix.acquireConnections());
+            expect(matrix.getConnections().empty());
+        }
+
+        beginTest("Connections are restored with the state");
+        {
+            ValueTree tree("state");
+            ModulationMatrix matrix(tree);
+            matrix.setConnection(Connection {0, frequencyTarget, 0.25f, true});
+            const auto xml = tree.createXml();
+
+            matrix.removeConnection(0, frequencyTarget);
+            expect(!matrix.acquireConnections());
+
+            // Replacing the state redirects the tree the matrix listens to
+            tree = ValueTree::fromXml(*xml);
+            expect(matrix.acquireConnections());
+            matrix.process(sources.data(), sources.size());
+            const auto expected = std::exp2(0.25f * MODULATION_FREQUENCY_OCTAVES);
+            expectWithinAbsoluteError(matrix.getBandModulation(2).frequency, expected, 1.0e-5f);
+        }
+
+        beginTest("Band modulation changes the equalizer output");
+        {
+            constexpr auto sampleRate = 48000.0;
+
+            EqualizerHost host;
+            host.prepare(sampleRate, 512);
+            auto& equalizer = host.getEqualizer();
+            host.setParameter(equalizer.getTypeParamID(0), static_cast<float>(EqualizerProcessor::Peak));
+            host.setParameter(equalizer.getFrequencyParamID(0), 1000.0f);
+            host.setParameter(equalizer.getQualityParamID(0), 1.0f);
+            host.setParameter(equalizer.getGainParamID(0), 2.0f);
+            host.setParameter(equalizer.getActiveParamID(0), 1.0f);
+
+            const auto level = measureLevel(host, sampleRate);
+            expectWithinAbsoluteError(level, Decibels::gainToDecibels(2.0), 0.1);
+
+            // Doubles the gain of the peak
+            equalizer.setBandModulation(0, 1.0f, 1.0f, 2.0f);
+            expectWithinAbsoluteError(measureLevel(host, sampleRate), Decibels::gainToDecibels(4.0), 0.1);
+
+            equalizer.setBandModulation(0, 1.0f, 1.0f, 1.0f);
+            expectWithinAbsoluteError(measureLevel(host, sampleRate), level, 1.0e-4);
+        }
+
+        beginTest("Modulated gains stay within the gain range");
+        {
+            constexpr auto sampleRate = 48000.0;
+
+            EqualizerHost host;
+            host.prepare(sampleRate, 512);
+            auto& equalizer = host.getEqualizer();
+            host.setParameter(equalizer.getTypeParamID(0), static_cast<float>(EqualizerProcessor::Peak));
+            host.setParameter(equalizer.getFrequencyParamID(0), 1000.0f);
+            host.setParameter(equalizer.getQualityParamID(0), 1.0f);
+            host.setParameter(equalizer.getGainParamID(0), MAX_GAIN);
+            host.setParameter(equalizer.getActiveParamID(0), 1.0f);
+
+            // A full scale source at full depth on a band at maximum gain
+            ValueTree tree("state");
+            ModulationMatrix matrix(tree);
+            matrix.setConnection(Connection {0, {ModulationParameter::Gain, 0}, 1.0f, true});
+            matrix.acquireConnections();
+            matrix.process(sources.data(), sources.size());
+            const auto& modulation = matrix.getBandModulation(0);
+            expectWithinAbsoluteError(Decibels::gainToDecibels(modulation.gain), MODULATION_GAIN_DB, 1.0e-4f);
+
+            equalizer.setBandModulation(0, modulation.frequency, modulation.quality, modulation.gain);
+            expectWithinAbsoluteError(measureLevel(host, sampleRate), static_cast<double>(MAX_DB), 0.1);
+        }
+
+        beginTest("Frequency modulation glides through the state variable sections");
+        {
+            constexpr auto sampleRate = 48000.0;
+
+            EqualizerHost host;
+            auto& equalizer = host.getEqualizer();
+            host.setParameter(Parameters::Topology, 1.0f);
+            host.setParameter(equalizer.getTypeParamID(0), static_cast<float>(EqualizerProcessor::Peak));
+            host.setParameter(equalizer.getFrequencyParamID(0), 1000.0f);
+            host.setParameter(equalizer.getQualityParamID(0), 1.0f);
+            host.setParameter(equalizer.getGainParamID(0), 2.0f);
+            host.setParameter(equalizer.getActiveParamID(0), 1.0f);
+            host.prepare(sampleRate, 512);
+
+            const auto level = measureLevel(host, sampleRate, 2000.0);
+            expectLessThan(level, Decibels::gainToDecibels(2.0) - 1.0);
+
+            // One octave up moves the peak onto the measured frequency
+            equalizer.setBandModulation(0, 2.0f, 1.0f, 1.0f);
+            expectWithinAbsoluteError(measureLevel(host, sampleRate, 2000.0), Decibels::gainToDecibels(2.0), 0.1);
+
+            // The biquads get the same frequency by a redesign
+            host.setParameter(Parameters::Topology, 0.0f);
+            expectWithinAbsoluteError(measureLevel(host, sampleRate, 2000.0), Decibels::gainToDecibels(2.0), 0.1);
+
+            host.setParameter(Parameters::Topology, 1.0f);
+            equalizer.setBandModulation(0, 1.0f, 1.0f, 1.0f);
+            expectWithinAbsoluteError(measureLevel(host, sampleRate, 2000.0), level, 1.0e-3);
+        }
+
+        beginTest("Frequency modulation glides through oversampled state variable sections");
+        {
+            constexpr auto sampleRate = 48000.0;
+
+            EqualizerHost host;
+            auto& equalizer = host.getEqualizer();
+            host.setParameter(Parameters::Topology, 1.0f);
+            host.setParameter(Parameters::Oversampling, 1.0f);
+            host.setParameter(equalizer.getTypeParamID(0), static_cast<float>(EqualizerProcessor::Peak));
+            host.setParameter(equalizer.getFrequencyParamID(0), 1000.0f);
+            host.setParameter(equalizer.getQualityParamID(0), 1.0f);
+            host.setParameter(equalizer.getGainParamID(0), 2.0f);
+            host.setParameter(equalizer.getActiveParamID(0), 1.0f);
+            host.prepare(sampleRate, 512);
+
+            const auto level = measureLevel(host, sampleRate, 2000.0);
+            expectLessThan(level, Decibels::gainToDecibels(2.0) - 1.0);
+
+            // The ratios run at the oversampled rate, the peak still moves
+            equalizer.setBandModulation(0, 2.0f, 1.0f, 1.0f);
+            expectWithinAbsoluteError(measureLevel(host, sampleRate, 2000.0), Decibels::gainToDecibels(2.0), 0.1);
+
+            equalizer.setBandModulation(0, 1.0f, 1.0f, 1.0f);
+            expectWithinAbsoluteError(measureLevel(host, sampleRate, 2000.0), level, 1.0e-3);
+        }
+    }
+
+private:
+    /**
+     * @brief Peak level of a sine after the equalizer in dB, measured
+     * once the smoothing has settled.
+     */
+    static double measureLevel(EqualizerHost& host, double sampleRate, double frequency = 1000.0)
+    {
+        constexpr auto blockSize = 512;
+        constexpr auto numBlocks = 64;
+        constexpr auto numSkip   = 48;
+
+        AudioBuffer<float> buffer(2, blockSize);
+        MidiBuffer midi;
+
+        auto sumSquares = 0.0;
+        auto sample     = 0;
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            for (int i = 0; i < blockSize; ++i, ++sample)
+            {
+                const auto value = std::sin(MathConstants<double>::twoPi * frequency * sample / sampleRate);
+                buffer.setSample(0, i, static_cast<float>(0.25 * value));
+                buffer.setSample(1, i, static_cast<float>(0.25 * value));
+            }
+
+            host.getEqualizer().processBlock(buffer, midi);
+            if (block < numSkip) { continue; }
+
+            for (int i = 0; i < blockSize; ++i) { sumSquares += square(static_cast<double>(buffer.getSample(0, i))); }
+        }
+
+        // A sine of 0.25 has an RMS of 0.25 / sqrt(2)
+        const auto rms = std::sqrt(sumSquares / ((numBlocks - numSkip) * blockSize));
+        return Decibels::gainToDecibels(rms * MathConstants<double>::sqrt2 / 0.25);
+    }
+};
+}  // namespace tobanteAudio::tests
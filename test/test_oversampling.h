@@ -0,0 +1,92 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "benchmark.h"
+#include "parameters/parameters.h"
+#include "processor_host.h"
+
+namespace tobanteAudio::tests
+{
+class TestOversampling : public UnitTest
+{
+public:
+    TestOversampling() : UnitTest("Oversampling") { }
+
+    void runTest() override
+    {
+        constexpr auto sampleRate = 48000.0;
+        constexpr auto blockSize  = 512;
+
+        beginTest("Latency follows the oversampling mode");
+        {
+            EqualizerHost host;
+            auto& equalizer = host.getEqualizer();
+            host.prepare(sampleRate, blockSize);
+            expectEquals(equalizer.getLatencySamples(), 0);
+
+            host.setParameter(Parameters::Oversampling, 2.0f);
+            host.setParameter(Parameters::OversamplingFilter, 0.0f);
+            const auto iirLatency = equalizer.getLatencySamples();
+            expectGreaterThan(iirLatency, 0);
+
+            host.setParameter(Parameters::OversamplingFilter, 1.0f);
+            const auto firLatency = equalizer.getLatencySamples();
+            expectGreaterThan(firLatency, iirLatency);
+            expectWithinAbsoluteError(equalizer.getTailLengthSeconds(), firLatency / sampleRate, 1.0e-9);
+
+            host.setParameter(Parameters::Oversampling, 0.0f);
+            expectEquals(equalizer.getLatencySamples(), 0);
+        }
+
+        beginTest("Every oversampling mode produces a bounded output");
+        {
+            for (auto filterType : {0.0f, 1.0f})
+            {
+                for (auto order : {1.0f, 2.0f, 3.0f})
+                {
+                    EqualizerHost host;
+                    auto& equalizer = host.getEqualizer();
+                    host.setParameter(Parameters::Oversampling, order);
+                    host.setParameter(Parameters::OversamplingFilter, filterType);
+                    host.prepare(sampleRate, blockSize);
+
+                    auto random = getRandom();
+                    AudioBuffer<float> buffer(2, blockSize);
+                    MidiBuffer midi;
+
+                    auto peak = 0.0f;
+                    for (int block = 0; block < 16; ++block)
+                    {
+                        fillWithNoise(buffer, random);
+                        equalizer.processBlock(buffer, midi);
+                        peak = jmax(peak, buffer.getMagnitude(0, blockSize));
+                    }
+
+                    expect(std::isfinite(peak));
+                    expectGreaterThan(peak, 0.0f);
+                    expectLessThan(peak, 8.0f);
+                }
+            }
+        }
+    }
+};
+}  // namespace tobanteAudio::tests
@@ -0,0 +1,141 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "benchmark.h"
+#include "parameters/parameters.h"
+#include "processor_host.h"
+
+namespace tobanteAudio::tests
+{
+class TestParameterDispatch : public UnitTest
+{
+public:
+    TestParameterDispatch() : UnitTest("Parameter Dispatch") { }
+
+    void runTest() override
+    {
+        using EQ = EqualizerProcessor;
+
+        beginTest("Parameter IDs match the band names");
+        {
+            EqualizerHost host;
+            auto& equalizer = host.getEqualizer();
+            for (int band = 0; band < FILTER_MAX_BANDS; ++band)
+            {
+                const auto prefix = equalizer.getBandName(band) + "-";
+                expectEquals(equalizer.getFrequencyParamID(band), prefix + Parameters::Frequency);
+                expectEquals(equalizer.getKeyParamID(band), prefix + Parameters::Key);
+                expectEquals(equalizer.getBandParamID(band, EQ::RoutingParameter), prefix + Parameters::Routing);
+            }
+        }
+
+        beginTest("The parameters of the default bands keep their host order");
+        {
+            EqualizerHost host;
+            auto& equalizer        = host.getEqualizer();
+            const auto& parameters = host.getState().processor.getParameters();
+
+            // Frequency, Q, gain, active & type of each default band come first
+            auto index = 0;
+            for (int band = 0; band < FILTER_DEFAULT_NUM_BANDS; ++band)
+            {
+                for (const auto& id : {equalizer.getFrequencyParamID(band), equalizer.getQualityParamID(band),
+                                       equalizer.getGainParamID(band), equalizer.getActiveParamID(band),
+                                       equalizer.getTypeParamID(band)})
+                {
+                    const auto* parameter = dynamic_cast<AudioProcessorParameterWithID*>(parameters[index++]);
+                    expect(parameter != nullptr && parameter->paramID == id);
+                }
+            }
+
+            const auto* next = dynamic_cast<AudioProcessorParameterWithID*>(parameters[index]);
+            expect(next != nullptr && next->paramID == equalizer.getSlopeParamID(0));
+        }
+
+        beginTest("A parameter change only reaches its own band & field");
+        {
+            EqualizerHost host;
+            auto& equalizer = host.getEqualizer();
+            const auto last = FILTER_MAX_BANDS - 1;
+
+            host.setParameter(equalizer.getFrequencyParamID(last), 440.0f);
+            host.setParameter(equalizer.getGainParamID(last), 2.0f);
+            host.setParameter(equalizer.getTypeParamID(last), static_cast<float>(EQ::HighShelf));
+            host.setParameter(equalizer.getSlopeParamID(last), static_cast<float>(EQ::Butterworth48));
+            host.setParameter(equalizer.getRoutingParamID(last), static_cast<float>(ChannelRouting::Side));
+            host.setParameter(equalizer.getDynamicParamID(last), 1.0f);
+            host.setParameter(equalizer.getKeyParamID(last), 1.0f);
+
+            // The listeners only mark the band, the model follows on the message thread
+            equalizer.handleBandChanges();
+
+            const auto* band = equalizer.getBand(last);
+            expectWithinAbsoluteError(band->frequency, 440.0f, 1.0f);
+            expectWithinAbsoluteError(band->gain, 2.0f, 0.01f);
+            expect(band->type == EQ::HighShelf);
+            expect(band->slope == EQ::Butterworth48);
+            expect(band->routing == ChannelRouting::Side);
+            expect(band->dynamic);
+            expect(band->sidechainKey);
+
+            const auto* first = equalizer.getBand(0);
+            expect(first->routing == ChannelRouting::Stereo);
+            expect(! first->dynamic);
+            expect(! first->sidechainKey);
+        }
+
+        beginTest("Parameter changes reach the audio thread at the next block");
+        {
+            constexpr auto sampleRate = 48000.0;
+            constexpr auto blockSize  = 256;
+
+            EqualizerHost host;
+            auto& equalizer = host.getEqualizer();
+            host.prepare(sampleRate, blockSize);
+
+            // Without the message thread, only the next block picks them up
+            for (int band = 0; band < equalizer.getNumBands(); ++band)
+            {
+                host.setParameter(equalizer.getGainParamID(band), 0.5f);
+                host.setParameter(equalizer.getActiveParamID(band), 0.0f);
+            }
+
+            auto random = getRandom();
+            AudioBuffer<float> input(2, blockSize);
+            AudioBuffer<float> output(2, blockSize);
+            MidiBuffer midi;
+            fillWithNoise(input, random);
+            output.makeCopyOf(input, true);
+            equalizer.processBlock(output, midi);
+
+            auto maxError = 0.0f;
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                for (int i = 0; i < blockSize; ++i)
+                { maxError = jmax(maxError, std::abs(input.getSample(channel, i) - output.getSample(channel, i))); }
+            }
+
+            expectEquals(maxError, 0.0f);
+        }
+    }
+};
+}  // namespace tobanteAudio::tests
@@ -0,0 +1,107 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "processor_host.h"
+
+namespace tobanteAudio::tests
+{
+class TestResponseGrid : public UnitTest
+{
+public:
+    TestResponseGrid() : UnitTest("Response Grid") { }
+
+    void runTest() override
+    {
+        using EQ = EqualizerProcessor;
+
+        beginTest("The grid follows the plot width");
+        {
+            EqualizerHost host;
+            host.prepare(48000.0, 512);
+            auto& equalizer = host.getEqualizer();
+            expectEquals(equalizer.getFrequencies().size(), static_cast<size_t>(RESPONSE_DEFAULT_POINTS));
+
+            equalizer.setResponseWidth(1600);
+            const auto expected = static_cast<size_t>(1600 / RESPONSE_PIXELS_PER_POINT);
+            expectEquals(equalizer.getFrequencies().size(), expected);
+            expectEquals(equalizer.getMagnitudes().size(), expected);
+            for (int i = 0; i < FILTER_MAX_BANDS; ++i)
+            { expectEquals(equalizer.getBand(i)->magnitudes.size(), expected); }
+
+            // The edges of the plot
+            expectWithinAbsoluteError(equalizer.getFrequencies().front(), 20.0, 1.0e-9);
+            expectWithinAbsoluteError(equalizer.getFrequencies().back(), 20480.0, 1.0e-6);
+        }
+
+        beginTest("The grid stays within its bounds");
+        {
+            EqualizerHost host;
+            auto& equalizer = host.getEqualizer();
+
+            equalizer.setResponseWidth(10);
+            expectEquals(equalizer.getFrequencies().size(), static_cast<size_t>(RESPONSE_MIN_POINTS));
+            equalizer.setResponseWidth(100000);
+            expectEquals(equalizer.getFrequencies().size(), static_cast<size_t>(RESPONSE_MAX_POINTS));
+        }
+
+        beginTest("Band responses are recomputed for the new grid");
+        {
+            EqualizerHost host;
+            host.prepare(48000.0, 512);
+            auto& equalizer = host.getEqualizer();
+
+            host.setParameter(equalizer.getTypeParamID(0), static_cast<float>(EQ::Peak));
+            host.setParameter(equalizer.getFrequencyParamID(0), 1000.0f);
+            host.setParameter(equalizer.getQualityParamID(0), 1.0f);
+            host.setParameter(equalizer.getGainParamID(0), 2.0f);
+            host.setParameter(equalizer.getActiveParamID(0), 1.0f);
+            equalizer.handleBandChanges();
+
+            for (const auto width : {600, 2400, 4000})
+            {
+                equalizer.setResponseWidth(width);
+                equalizer.updateResponsesNow();
+                const auto& magnitudes = equalizer.getBand(0)->magnitudes;
+                const auto peak        = *std::max_element(magnitudes.begin(), magnitudes.end());
+                expectWithinAbsoluteError(peak, 2.0, 0.01);
+            }
+        }
+
+        beginTest("The worker builds paths spanning the plot");
+        {
+            EqualizerHost host;
+            host.prepare(48000.0, 512);
+            auto& equalizer = host.getEqualizer();
+
+            const auto bounds = Rectangle<int> {10, 20, 800, 300};
+            equalizer.setPlotBounds(bounds, 50.0f);
+            equalizer.updateResponsesNow();
+
+            const auto area = equalizer.getResponsePlot().getBounds();
+            expectEquals(area.getX(), 10.0f);
+            expectEquals(area.getRight(), 810.0f);
+            expectEquals(equalizer.getBandPlot(0).getBounds().getWidth(), 800.0f);
+            expect(equalizer.getBandPlot(FILTER_MAX_BANDS).isEmpty());
+        }
+    }
+};
+}  // namespace tobanteAudio::tests
@@ -0,0 +1,133 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "benchmark.h"
+#include "processor_host.h"
+
+namespace tobanteAudio::tests
+{
+class TestSilence : public UnitTest
+{
+public:
+    TestSilence() : UnitTest("Silence Detection") { }
+
+    void runTest() override
+    {
+        constexpr auto sampleRate = 48000.0;
+        constexpr auto blockSize  = 512;
+
+        beginTest("The cascade is skipped once the tail has decayed");
+        {
+            EqualizerHost host;
+            host.prepare(sampleRate, blockSize);
+            auto& equalizer = host.getEqualizer();
+
+            auto random = getRandom();
+            AudioBuffer<float> buffer(2, blockSize);
+            MidiBuffer midi;
+
+            fillWithNoise(buffer, random);
+            equalizer.processBlock(buffer, midi);
+            expect(!equalizer.isIdle());
+
+            // The filters keep ringing into the first silent block
+            buffer.clear();
+            equalizer.processBlock(buffer, midi);
+            expect(!equalizer.isIdle());
+            expectGreaterThan(buffer.getMagnitude(0, blockSize), 0.0f);
+
+            const auto tailBlocks = static_cast<int>(equalizer.getTailLengthSeconds() * sampleRate / blockSize) + 2;
+            for (int block = 0; block < tailBlocks && !equalizer.isIdle(); ++block)
+            {
+                buffer.clear();
+                equalizer.processBlock(buffer, midi);
+            }
+            expect(equalizer.isIdle());
+
+            // Any signal wakes the cascade up again
+            fillWithNoise(buffer, random);
+            equalizer.processBlock(buffer, midi);
+            expect(!equalizer.isIdle());
+        }
+
+        beginTest("Quiet input below the threshold is still equalized");
+        {
+            EqualizerHost host;
+            host.prepare(sampleRate, blockSize);
+            auto& equalizer = host.getEqualizer();
+            host.setParameter(equalizer.getTypeParamID(2), static_cast<float>(EqualizerProcessor::Peak));
+            host.setParameter(equalizer.getFrequencyParamID(2), 1000.0f);
+            host.setParameter(equalizer.getQualityParamID(2), 1.0f);
+            host.setParameter(equalizer.getGainParamID(2), MAX_GAIN);
+            host.setParameter(equalizer.getActiveParamID(2), 1.0f);
+
+            AudioBuffer<float> buffer(2, blockSize);
+            MidiBuffer midi;
+
+            // -130 dBFS, under the threshold of the decaying tails
+            const auto level      = Decibels::decibelsToGain(-130.0f);
+            const auto tailBlocks = static_cast<int>(equalizer.getTailLengthSeconds() * sampleRate / blockSize) + 2;
+            for (int block = 0; block < tailBlocks; ++block)
+            {
+                // Continues the sine across blocks
+                for (int channel = 0; channel < 2; ++channel)
+                {
+                    for (int i = 0; i < blockSize; ++i)
+                    {
+                        const auto phase = MathConstants<double>::twoPi * 1000.0 * (block * blockSize + i) / sampleRate;
+                        buffer.setSample(channel, i, level * static_cast<float>(std::sin(phase)));
+                    }
+                }
+                equalizer.processBlock(buffer, midi);
+            }
+
+            expect(!equalizer.isIdle());
+            expectGreaterThan(buffer.getMagnitude(0, 0, blockSize), level * 2.0f);
+        }
+
+        beginTest("The silence level matches the threshold in decibels");
+        expectWithinAbsoluteError(SILENCE_THRESHOLD_LEVEL, Decibels::decibelsToGain(SILENCE_THRESHOLD_DB, -200.0),
+                                  1.0e-12);
+
+        beginTest("The tail length follows the bands");
+        {
+            EqualizerHost host;
+            host.prepare(sampleRate, blockSize);
+            auto& equalizer = host.getEqualizer();
+
+            const auto defaultTail = equalizer.getTailLengthSeconds();
+            expectGreaterThan(defaultTail, 0.0);
+
+            // A narrow peak rings longer
+            host.setParameter(equalizer.getQualityParamID(2), 10.0f);
+            equalizer.handleBandChanges();
+            expectGreaterThan(equalizer.getTailLengthSeconds(), defaultTail);
+
+            // Deactivated bands don't ring at all
+            for (int band = 0; band < equalizer.getNumBands(); ++band)
+            { host.setParameter(equalizer.getActiveParamID(band), 0.0f); }
+            equalizer.handleBandChanges();
+            expectWithinAbsoluteError(equalizer.getTailLengthSeconds(), 0.0, 1.0e-9);
+        }
+    }
+};
+}  // namespace tobanteAudio::tests
@@ -0,0 +1,120 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "benchmark.h"
+#include "processor_host.h"
+
+namespace tobanteAudio::tests
+{
+class TestSubBlocks : public UnitTest
+{
+public:
+    TestSubBlocks() : UnitTest("Sub-Block Processing") { }
+
+    void runTest() override
+    {
+        beginTest("Sub-blocks match whole blocks, including ramps & the sidechain");
+        expectEquals(getSubBlockError(FILTER_CONTROL_INTERVAL, 256), 0.0f);
+
+        // The pipeline rounds to the active interval, so the grid still lines up
+        beginTest("Sub-blocks match whole blocks with a longer control interval");
+        {
+            const auto pipelineBlockSize = EqualizerProcessor::getPipelineBlockSize(12, sizeof(float), 96);
+            expectEquals(pipelineBlockSize, 288);
+            expectEquals(getSubBlockError(96, pipelineBlockSize), 0.0f);
+        }
+
+        beginTest("Pipeline block size fits the cache budget on the control-rate grid");
+        {
+            expectEquals(EqualizerProcessor::getPipelineBlockSize(2, sizeof(float)), 2048);
+            expectEquals(EqualizerProcessor::getPipelineBlockSize(16, sizeof(double)), 128);
+            expectEquals(EqualizerProcessor::getPipelineBlockSize(12, sizeof(float)), 320);
+            expectEquals(EqualizerProcessor::getPipelineBlockSize(1024, sizeof(double)), FILTER_CONTROL_INTERVAL);
+        }
+    }
+
+private:
+    /**
+     * @brief Largest difference between processing whole blocks & sub-blocks
+     * of the given size, with the given control interval.
+     */
+    float getSubBlockError(int controlInterval, int subBlockSize)
+    {
+        constexpr auto sampleRate = 48000.0;
+        constexpr auto blockSize  = 1024;
+
+        EqualizerHost wholeHost;
+        EqualizerHost subHost;
+        for (auto* host : {&wholeHost, &subHost})
+        {
+            auto& equalizer = host->getEqualizer();
+            host->setParameter(equalizer.getDynamicParamID(2), 1.0f);
+            host->setParameter(equalizer.getThresholdParamID(2), -30.0f);
+            host->setParameter(equalizer.getKeyParamID(2), 1.0f);
+            equalizer.setControlInterval(controlInterval);
+            host->prepare(sampleRate, blockSize);
+        }
+
+        auto random = getRandom();
+        AudioBuffer<float> input(2, blockSize);
+        AudioBuffer<float> sidechain(2, blockSize);
+        AudioBuffer<float> whole(2, blockSize);
+        AudioBuffer<float> sub(2, blockSize);
+        MidiBuffer midi;
+
+        auto maxError = 0.0f;
+        for (int block = 0; block < 32; ++block)
+        {
+            // Starts a ramp halfway through
+            if (block == 16)
+            {
+                for (auto* host : {&wholeHost, &subHost})
+                { host->setParameter(host->getEqualizer().getGainParamID(1), 0.25f); }
+            }
+
+            fillWithNoise(input, random);
+            fillWithNoise(sidechain, random);
+            whole.makeCopyOf(input);
+            sub.makeCopyOf(input);
+
+            wholeHost.getEqualizer().setSidechain(&sidechain);
+            wholeHost.getEqualizer().processBlock(whole, midi);
+
+            subHost.getEqualizer().setSidechain(&sidechain);
+            for (int start = 0; start < blockSize; start += subBlockSize)
+            {
+                const auto length = jmin(subBlockSize, blockSize - start);
+                AudioBuffer<float> subBlock(sub.getArrayOfWritePointers(), 2, start, length);
+                subHost.getEqualizer().processSubBlock(subBlock, start);
+            }
+
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                for (int i = 0; i < blockSize; ++i)
+                { maxError = jmax(maxError, std::abs(whole.getSample(channel, i) - sub.getSample(channel, i))); }
+            }
+        }
+
+        return maxError;
+    }
+};
+}  // namespace tobanteAudio::tests
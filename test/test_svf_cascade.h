@@ -0,0 +1,192 @@
+/* Copyright 2018-2020 Tobias Hienzsch
+ *
+ * modEQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * modEQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with modEQ. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+// JUCE
+#include "modEQ.hpp"
+
+// tobanteAudio
+#include "benchmark.h"
+#include "processor/biquad_cascade.h"
+#include "processor/biquad_designer.h"
+#include "processor/svf_cascade.h"
+#include "processor/svf_designer.h"
+#include "processor_host.h"
+
+namespace tobanteAudio::tests
+{
+/**
+ * @brief Sets the default 6 band setup on a cascade, designed with the given
+ * designer.
+ */
+template <typename Designer, typename Cascade> void setReferenceSections(Cascade& cascade, double sampleRate)
+{
+    cascade.setCoefficients(0, Designer::makeHighPass(sampleRate, 20.0, 0.707));
+    cascade.setCoefficients(1, Designer::makeLowShelf(sampleRate, 250.0, 1.0, 2.0));
+    cascade.setCoefficients(2, Designer::makePeakFilter(sampleRate, 500.0, 1.0, 0.5));
+    cascade.setCoefficients(3, Designer::makePeakFilter(sampleRate, 1000.0, 4.0, 1.5));
+    cascade.setCoefficients(4, Designer::makeHighShelf(sampleRate, 5000.0, 1.0, 0.7));
+    cascade.setCoefficients(5, Designer::makeLowPass(sampleRate, 12000.0, 0.707));
+}
+
+class TestSvfCascade : public UnitTest
+{
+public:
+    TestSvfCascade() : UnitTest("SVF Cascade") { }
+
+    void runTest() override
+    {
+        constexpr auto sampleRate  = 48000.0;
+        constexpr auto numChannels = 3;
+        constexpr auto blockSize   = 512;
+        constexpr auto numBlocks   = 16;
+
+        const auto spec = dsp::ProcessSpec {sampleRate, blockSize, numChannels};
+
+        beginTest("SvfCascade matches the BiquadCascade");
+        {
+            BiquadCascade<float, 6> biquads;
+            biquads.prepare(spec);
+            setReferenceSections<BiquadDesigner<double>>(biquads, sampleRate);
+
+            SvfCascade<float, 6> svfs;
+            svfs.prepare(spec);
+            setReferenceSections<SvfDesigner<double>>(svfs, sampleRate);
+
+            auto random = getRandom();
+            AudioBuffer<float> expected(numChannels, blockSize);
+            AudioBuffer<float> actual(numChannels, blockSize);
+
+            auto maxError = 0.0f;
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                fillWithNoise(expected, random);
+                actual.makeCopyOf(expected, true);
+
+                dsp::AudioBlock<float> expectedBlock(expected);
+                dsp::AudioBlock<float> actualBlock(actual);
+                biquads.process(dsp::ProcessContextReplacing<float>(expectedBlock));
+                svfs.process(dsp::ProcessContextReplacing<float>(actualBlock));
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    for (int i = 0; i < blockSize; ++i)
+                    {
+                        const auto error = std::abs(expected.getSample(channel, i) - actual.getSample(channel, i));
+                        maxError         = jmax(maxError, error);
+                    }
+                }
+            }
+
+            expectLessThan(maxError, 1.0e-4f);
+        }
+
+        beginTest("A constant frequency ratio retunes the section");
+        {
+            SvfCascade<double, 1> modulated;
+            SvfCascade<double, 1> retuned;
+            modulated.prepare(spec);
+            retuned.prepare(spec);
+            modulated.setCoefficients(0, SvfDesigner<double>::makePeakFilter(sampleRate, 1000.0, 2.0, 4.0));
+            retuned.setCoefficients(0, SvfDesigner<double>::makePeakFilter(sampleRate, 2000.0, 2.0, 4.0));
+
+            std::vector<double> ratios(blockSize, 2.0);
+            const double* modulation[] = {ratios.data()};
+
+            auto random = getRandom();
+            AudioBuffer<double> expected(numChannels, blockSize);
+            AudioBuffer<double> actual(numChannels, blockSize);
+            fillWithNoise(expected, random);
+            actual.makeCopyOf(expected, true);
+
+            dsp::AudioBlock<double> expectedBlock(expected);
+            dsp::AudioBlock<double> actualBlock(actual);
+            retuned.process(dsp::ProcessContextReplacing<double>(expectedBlock));
+            modulated.process(dsp::ProcessContextReplacing<double>(actualBlock), modulation);
+
+            auto maxError = 0.0;
+            for (int i = 0; i < blockSize; ++i)
+            { maxError = jmax(maxError, std::abs(expected.getSample(0, i) - actual.getSample(0, i))); }
+            expectLessThan(maxError, 1.0e-6);
+        }
+
+        beginTest("Audio-rate modulation of every section stays bounded");
+        {
+            SvfCascade<float, 6> svfs;
+            svfs.prepare(spec);
+            setReferenceSections<SvfDesigner<double>>(svfs, sampleRate);
+
+            // Jumps between two & a quarter of the cutoff on every sample
+            std::vector<float> ratios(blockSize);
+            for (size_t i = 0; i < ratios.size(); ++i) { ratios[i] = i % 2 == 0 ? 4.0f : 0.25f; }
+            const auto modulation = std::array<const float*, 6> {ratios.data(), ratios.data(), ratios.data(),
+                                                                 ratios.data(), ratios.data(), ratios.data()};
+
+            auto random = getRandom();
+            AudioBuffer<float> buffer(numChannels, blockSize);
+
+            auto peak = 0.0f;
+            for (int block = 0; block < numBlocks * 4; ++block)
+            {
+                fillWithNoise(buffer, random);
+                dsp::AudioBlock<float> ioBlock(buffer);
+                svfs.process(dsp::ProcessContextReplacing<float>(ioBlock), modulation.data());
+                for (int channel = 0; channel < numChannels; ++channel)
+                { peak = jmax(peak, buffer.getMagnitude(channel, 0, blockSize)); }
+            }
+
+            expect(std::isfinite(peak));
+            expectLessThan(peak, 16.0f);
+        }
+
+        beginTest("State variable topology matches the biquad topology");
+        {
+            EqualizerHost biquadHost;
+            EqualizerHost svfHost;
+            svfHost.setParameter(Parameters::Topology, 1.0f);
+            biquadHost.prepare(sampleRate, blockSize);
+            svfHost.prepare(sampleRate, blockSize);
+
+            auto random = getRandom();
+            AudioBuffer<float> expected(2, blockSize);
+            AudioBuffer<float> actual(2, blockSize);
+            MidiBuffer midi;
+
+            auto maxError = 0.0f;
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                fillWithNoise(expected, random);
+                actual.makeCopyOf(expected, true);
+                biquadHost.getEqualizer().processBlock(expected, midi);
+                svfHost.getEqualizer().processBlock(actual, midi);
+
+                for (int channel = 0; channel < 2; ++channel)
+                {
+                    for (int i = 0; i < blockSize; ++i)
+                    {
+                        const auto error = std::abs(expected.getSample(channel, i) - actual.getSample(channel, i));
+                        maxError         = jmax(maxError, error);
+                    }
+                }
+            }
+
+            expectLessThan(maxError, 1.0e-3f);
+        }
+    }
+};
+}  // namespace tobanteAudio::tests